@@ -3,15 +3,26 @@
 
 #include <memory>
 #include <string>
+#include <cstddef>
+#include <optional>
 #include <filesystem>
 
 namespace firstgame::platform {
 
+/// Read-only view of a file's content in memory
+struct FileView {
+    const std::byte* data;
+    std::size_t size;
+};
+
 /// File Interface
 class File {
    public:
     // Interface
     virtual auto ReadToString() -> std::string = 0;
+    /// Map the whole content into memory, read-only and valid until the file is closed.
+    /// Platforms that cannot map files return nothing, and readers fall back to ReadToString().
+    virtual auto Map() -> std::optional<FileView> { return std::nullopt; }
     virtual void Close() = 0;
     virtual auto Path() -> std::filesystem::path = 0;
     // Destructor
@@ -27,6 +38,11 @@ class FileSystem {
    public:
     // Interface
     virtual auto Open(const char* filename) -> std::unique_ptr<File> = 0;
+    /// Directory for the files written by the engine, like caches, or empty if the platform has no writable storage
+    virtual auto CacheDir() -> std::filesystem::path { return {}; }
+    /// Write the whole content of a file, replacing any previous one atomically. Returns false on failure.
+    /// Must be thread-safe, it is called from loader threads.
+    virtual bool Write(const char* filename, const void* data, std::size_t size) { return false; }
     // Destructor
     virtual ~FileSystem() = default;
 
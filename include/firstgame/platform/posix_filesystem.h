@@ -0,0 +1,30 @@
+#ifndef FIRSTGAME_POSIX_FILESYSTEM_H_
+#define FIRSTGAME_POSIX_FILESYSTEM_H_
+
+#include "firstgame/platform/filesystem.h"
+
+namespace firstgame::platform {
+
+/// POSIX File System, opening files with `open` and mapping them with `mmap`.
+/// Files are written to a temporary file renamed over the target, so readers never see a partial file.
+/// Provided for platforms to use as they are, or to delegate to.
+class PosixFileSystem final : public FileSystem {
+   public:
+    /// The cache directory defaults to `$XDG_CACHE_HOME/firstgame`, or `$HOME/.cache/firstgame`
+    explicit PosixFileSystem(std::filesystem::path cache_dir = DefaultCacheDir()) : cache_dir_(std::move(cache_dir)) {}
+
+    // Interface
+    auto Open(const char* filename) -> std::unique_ptr<File> override;
+    auto CacheDir() -> std::filesystem::path override { return cache_dir_; }
+    bool Write(const char* filename, const void* data, std::size_t size) override;
+
+    /// Per-user cache directory of the engine, or empty if the environment has none
+    static auto DefaultCacheDir() -> std::filesystem::path;
+
+   private:
+    std::filesystem::path cache_dir_;
+};
+
+}  // namespace firstgame::platform
+
+#endif  // FIRSTGAME_POSIX_FILESYSTEM_H_
@@ -0,0 +1,94 @@
+#ifndef FIRSTGAME_REPLAY_REPLAY_H_
+#define FIRSTGAME_REPLAY_REPLAY_H_
+
+#include <memory>
+#include <functional>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#include "firstgame/firstgame.h"
+#include "firstgame/event/event.h"
+#include "firstgame/platform/filesystem.h"
+
+namespace firstgame::replay {
+
+/// Game recording the input of a session into a binary recording (.fgreplay), while passing it on to the game
+/// it wraps. The events and the delta time of every frame are recorded in order, so that a Player feeds the game
+/// exactly the input it received. Platforms wrap the game created by FirstGame::New() to record a session:
+///
+///     game = std::make_unique<replay::Recorder>(FirstGame::New(width, height, logger, fs), width, height, fs, path);
+///
+/// The recording is kept in memory, compactly encoded, and written on destruction or on Save().
+class Recorder final : public FirstGame {
+   public:
+    Recorder(std::unique_ptr<FirstGame> game, int width, int height, std::shared_ptr<platform::FileSystem> filesystem,
+             std::filesystem::path path);
+    // Interface
+    void Update(float deltatime) override;
+    void OnImGuiRender() override;
+    void OnEvent(const event::Event& event) override;
+    ~Recorder() override;
+
+    /// Write the frames recorded so far with the file system. Returns false on failure.
+    bool Save();
+
+    /// Number of frames recorded so far
+    [[nodiscard]] auto NumFrames() const -> uint32_t { return num_frames_; }
+
+   private:
+    std::unique_ptr<FirstGame> game_;
+    std::shared_ptr<platform::FileSystem> filesystem_;
+    std::filesystem::path path_;
+    std::vector<std::byte> bytes_;  ///< header followed by the records
+    size_t frame_end_ = 0;          ///< end of the records of the last frame
+    uint32_t num_frames_ = 0;
+};
+
+/// Pace of a replay
+enum class Pace {
+    Fixed,  ///< frames are replayed in real time, waiting out their recorded delta time
+    Max,    ///< frames are replayed back to back, as fast as the game updates
+};
+
+/// Driver feeding a recording back to a game, frame by frame. The recording is validated once on construction,
+/// then frames are decoded in place, so that replaying does not allocate.
+class Player final {
+   public:
+    /// Throws std::runtime_error if the bytes are not a valid recording
+    explicit Player(std::vector<std::byte> bytes);
+
+    /// Read a recording with the file system. Throws std::runtime_error if it cannot be read or is malformed.
+    static auto Load(platform::FileSystem& filesystem, const std::filesystem::path& path) -> Player;
+
+    /// Size of the window when the recording started, to create the game with
+    [[nodiscard]] auto Width() const -> int { return width_; }
+    [[nodiscard]] auto Height() const -> int { return height_; }
+
+    [[nodiscard]] auto NumFrames() const -> uint32_t { return num_frames_; }
+    /// Index of the next frame to replay
+    [[nodiscard]] auto Frame() const -> uint32_t { return frame_; }
+    [[nodiscard]] bool Done() const { return frame_ == num_frames_; }
+
+    /// Feed the events of the next frame to the game, then update it with the frame's delta time, which is
+    /// returned. Must not be called once Done().
+    float Step(FirstGame& game);
+
+    /// Replay the remaining frames at the given pace, and return the wall time of each in milliseconds, from its
+    /// first event to the end of its update. `end_frame`, if any, is called after each frame and is not timed,
+    /// for the platform to present the frame.
+    auto Run(FirstGame& game, Pace pace, const std::function<void()>& end_frame = {}) -> std::vector<float>;
+
+   private:
+    std::vector<std::byte> bytes_;
+    size_t offset_;  ///< offset of the next record
+    int width_;
+    int height_;
+    uint32_t num_frames_;
+    uint32_t frame_ = 0;
+};
+
+}  // namespace firstgame::replay
+
+#endif  // FIRSTGAME_REPLAY_REPLAY_H_
@@ -4,25 +4,42 @@
 
 #include "firstgame/firstgame.h"
 
+#include <cmath>
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <exception>
+#include <string_view>
 #include <entt/entity/handle.hpp>
 #include <entt/entity/registry.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <imgui/imgui.h>
 #include <firstgame/render/motion.h>
 
 #include "firstgame/event/event.h"
 #include "firstgame/system/log.h"
 #include "firstgame/system/system.h"
+#include "firstgame/system/task_thread.h"
+#include "firstgame/render/instance_grid.h"
+#include "firstgame/render/motion_system.h"
+#include "firstgame/render/transform_system.h"
+#include "firstgame/render/spatial_system.h"
 #include "firstgame/render/painter.h"
 #include "firstgame/render/renderer.h"
 #include "firstgame/render/renderable.h"
 #include "firstgame/render/transform.h"
 #include "firstgame/render/shader_lib.h"
+#include "firstgame/render/world_streamer.h"
 #include "firstgame/util/overloaded.h"
 
 namespace firstgame {
 
 /**************************************************************************************************/
 
+using render::InstanceGrid;
 using render::Motion;
 using render::Renderable;
 using render::RenderableInstanced;
@@ -42,20 +59,62 @@ class FirstGameImpl final : public FirstGame {
     void OnEvent(const event::Event& event) override;
     ~FirstGameImpl() override;
 
+   private:
+    /// Update the systems for the next frame, without any GL call
+    void Simulate(float deltatime);
+
+    /// Write the instance transforms of the waving grids, to be culled and streamed by the renderer
+    void UpdateInstanceGrids(float deltatime);
+
+    /// Attach the renderables whose background load completed to their entities
+    void AttachLoaded();
+
+    /// Show the zones of a profiled frame on a timeline, with the frame times
+    void ProfilerWindow();
+
+    /// Time budget per frame for GL uploads of background loads
+    static constexpr std::chrono::microseconds kUploadBudget{ 2000 };
+
    private:
     system::System system_;
     render::Renderer renderer_;
     entt::registry registry_;
+    render::TransformSystem transform_system_;
+    render::MotionSystem motion_system_;
+    render::SpatialSystem spatial_system_;
+    render::WorldStreamer streamer_;
+    system::TaskThread simulation_;  ///< simulates and records the next frame in pipelined mode
+    // renderables loading in the background, attached to their entity once loaded
+    std::vector<std::pair<entt::entity, std::future<Renderable>>> loading_renderables_;
+    std::vector<std::pair<entt::entity, std::future<RenderableInstanced>>> loading_instanced_;
+    std::chrono::steady_clock::time_point created_;
+    float startup_ms_ = -1.0f;  ///< from creation until every startup load completed, negative while loading
+    bool pipelined_ = false;
+    std::chrono::steady_clock::time_point recorded_start_{};  ///< start of the simulation of the recorded frame
+    float motion_ms_ = 0.0f;
+    float frame_ms_ = 0.0f;    ///< time spent in Update(), throughput
+    float latency_ms_ = 0.0f;  ///< from the start of a frame's simulation to the end of its submission
+    int profiled_age_ = 0;     ///< age of the frame shown by the profiler window
+    int trace_frames_ = 60;    ///< number of frames of the next trace capture
 };
 
 /**************************************************************************************************/
 
 FirstGameImpl::FirstGameImpl(int width, int height, std::shared_ptr<spdlog::logger> logger,
                              std::shared_ptr<platform::FileSystem> filesystem)
-    : system_(std::move(logger), std::move(filesystem)), renderer_({ Width(width), Height(height) })
+    : system_(std::move(logger), std::move(filesystem)),
+      renderer_({ Width(width), Height(height) }),
+      transform_system_(registry_),
+      motion_system_(registry_),
+      spatial_system_(registry_),
+      created_(std::chrono::steady_clock::now())
 {
     TRACE("Created FirstGameImpl");
 
+    system::Profiler::NameThread("main");
+    simulation_.Run([] { system::Profiler::NameThread("simulation"); });
+    simulation_.Wait();
+
     // Generate Multiple Quads
     // for (float i : { 1.f, 2.f, 3.f, 4.f, 5.f }) {
     //     float x = ((2.0f / 5) * i) - 1.0f - (2.0f / 5 / 2);
@@ -83,16 +142,23 @@ FirstGameImpl::FirstGameImpl(int width, int height, std::shared_ptr<spdlog::logg
     using render::MyShader;
     using render::ShaderLibrary;
 
-    auto& shader_simple = ShaderLibrary::current().get(MyShader::SIMPLE);
-    auto& shader_instance = ShaderLibrary::current().get(MyShader::SIMPLE_INSTANCE);
+    // meshes are uploaded in the background once their shader is built, as the vertex layout depends on it
+    auto& loader = system_.Loader();
+    auto& shaders = ShaderLibrary::current();
+    const auto upload = [&](MyShader my_shader, auto generate) {
+        return loader.Async([my_shader, generate] { return [my_shader, generate] { return generate(my_shader); }; },
+                            shaders.loading(my_shader));
+    };
 
     // Generate instanced cubes
     entt::handle cubes{ registry_, registry_.create() };
-    cubes.emplace<RenderableInstanced>(render::GenerateCubeInstanced(shader_instance, 50, 100));
+    cubes.emplace<InstanceGrid>(InstanceGrid{ .rows = 50, .cols = 100 });
+    loading_instanced_.emplace_back(cubes.entity(), upload(MyShader::SIMPLE_INSTANCE, [](MyShader my_shader) {
+                                        return render::GenerateCubeInstanced(ShaderLibrary::current().get(my_shader), 50, 100);
+                                    }));
 
     // Generate Single Quad
     entt::handle quad{ registry_, registry_.create() };
-    quad.emplace<Renderable>(render::GenerateQuad(shader_simple));
     quad.emplace<Transform>(Transform{
         .position = glm::vec3(-7.0f, 0.0f, 10.0f),
         .scale = glm::vec3(1.0f),
@@ -102,10 +168,12 @@ FirstGameImpl::FirstGameImpl(int width, int height, std::shared_ptr<spdlog::logg
         .velocity = glm::vec3(0.0f, 0.0f, 40.0f),
         .acceleration = glm::vec3(0.0f, 0.0f, 15.0f),
     });
+    loading_renderables_.emplace_back(quad.entity(), upload(MyShader::SIMPLE, [](MyShader my_shader) {
+                                          return render::GenerateQuad(ShaderLibrary::current().get(my_shader));
+                                      }));
 
     // Generate Cube
     entt::handle cube{ registry_, registry_.create() };
-    cube.emplace<Renderable>(render::GenerateCube(shader_simple));
     cube.emplace<Transform>(Transform{
         .position = glm::vec3(-7.0f, 0.0f, 0.0f),
         .scale = glm::vec3(1.0f),
@@ -115,22 +183,125 @@ FirstGameImpl::FirstGameImpl(int width, int height, std::shared_ptr<spdlog::logg
         .velocity = glm::vec3(70.0f, 50.0f, 90.0f),
         .acceleration = glm::vec3(0.0f),
     });
+    loading_renderables_.emplace_back(cube.entity(), upload(MyShader::SIMPLE, [](MyShader my_shader) {
+                                          return render::GenerateCube(ShaderLibrary::current().get(my_shader));
+                                      }));
 }
 
 /**************************************************************************************************/
 
 void FirstGameImpl::Update(float deltatime)
 {
-    auto view = registry_.view<Transform, Motion>();
-    view.each([deltatime](Transform& transform, Motion& motion) {
-        motion.velocity += motion.acceleration * deltatime;
-        glm::vec3 degrees = motion.velocity * deltatime;
-        transform.rotation *= glm::angleAxis(glm::radians(degrees.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        transform.rotation *= glm::angleAxis(glm::radians(degrees.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        transform.rotation *= glm::angleAxis(glm::radians(degrees.z), glm::vec3(0.0f, 0.0f, 1.0f));
-    });
+    using clock = std::chrono::steady_clock;
+    const auto frame_start = clock::now();
+    system_.Profiler().NextFrame();
+    system_.Trace().Update(system_.Profiler());
+    system_.FrameArena().NextFrame();
+    PROFILE_ZONE("Update");
+    // reload changed assets, costs nothing unless files changed
+    system_.Watcher().Poll();
+
+    if (pipelined_) {
+        // simulate and record frame N+1 on the simulation thread while this thread, owning the GL context,
+        // submits frame N. The registry belongs to the simulation thread until it is waited for.
+        simulation_.Run([this, deltatime] {
+            Simulate(deltatime);
+            renderer_.Record(registry_);
+        });
+        renderer_.Submit();
+        const auto submit_end = clock::now();
+        system_.Loader().Upload(kUploadBudget);
+        {
+            PROFILE_ZONE("Wait simulation");
+            simulation_.Wait();
+        }
+        streamer_.ReleaseRetired();
+        latency_ms_ = std::chrono::duration<float, std::milli>(submit_end - recorded_start_).count();
+        recorded_start_ = frame_start;
+        renderer_.Swap();
+    }
+    else {
+        Simulate(deltatime);
+        renderer_.Render(registry_);
+        latency_ms_ = std::chrono::duration<float, std::milli>(clock::now() - frame_start).count();
+        recorded_start_ = frame_start;
+        streamer_.ReleaseRetired();
+        system_.Loader().Upload(kUploadBudget);
+    }
+
+    if (startup_ms_ < 0.0f && system_.Loader().NumPending() == 0 && loading_renderables_.empty() &&
+        loading_instanced_.empty()) {
+        startup_ms_ = std::chrono::duration<float, std::milli>(clock::now() - created_).count();
+        DEBUG("Startup loads completed in {:.3f} ms", startup_ms_);
+    }
 
-    renderer_.Render(registry_);
+    frame_ms_ = std::chrono::duration<float, std::milli>(clock::now() - frame_start).count();
+}
+
+/**************************************************************************************************/
+
+void FirstGameImpl::Simulate(float deltatime)
+{
+    PROFILE_ZONE("Simulate");
+    AttachLoaded();
+    // the camera only moves on events, handled while no frame is being simulated
+    streamer_.Update(registry_, renderer_.CameraPosition());
+    transform_system_.Update(registry_);
+
+    const auto motion_start = std::chrono::steady_clock::now();
+    motion_system_.Update(registry_, system_.Jobs(), deltatime);
+    motion_ms_ = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - motion_start).count();
+
+    spatial_system_.Update(registry_);
+    UpdateInstanceGrids(deltatime);
+}
+
+/**************************************************************************************************/
+
+void FirstGameImpl::AttachLoaded()
+{
+    const auto attach = [this](auto& loading) {
+        for (auto it = loading.begin(); it != loading.end();) {
+            auto& [entity, future] = *it;
+            if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+            try {
+                using Component = decltype(future.get());
+                auto component = future.get();
+                if (registry_.valid(entity)) {
+                    registry_.emplace<Component>(entity, std::move(component));
+                }
+            }
+            catch (const std::exception& e) {
+                ERROR("Failed to load renderable of entity {}: {}", entt::to_integral(entity), e.what());
+            }
+            it = loading.erase(it);
+        }
+    };
+    attach(loading_renderables_);
+    attach(loading_instanced_);
+}
+
+/**************************************************************************************************/
+
+void FirstGameImpl::UpdateInstanceGrids(float deltatime)
+{
+    PROFILE_ZONE("InstanceGrids");
+    auto view = registry_.view<RenderableInstanced, InstanceGrid>();
+    view.each([&](RenderableInstanced& renderable, InstanceGrid& grid) {
+        grid.time += deltatime;
+        renderable.models.resize(grid.rows * grid.cols);
+        const glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(0.5f));
+        for (unsigned int i = 0; i < grid.rows; i++) {
+            for (unsigned int j = 0; j < grid.cols; j++) {
+                const float height = -3.0f + grid.amplitude * std::sin(2.0f * grid.time + 0.3f * float(i + j));
+                renderable.models[i * grid.cols + j] =
+                    glm::translate(glm::mat4(1.0f), glm::vec3(float(i), height, float(j))) * scale;
+            }
+        }
+    });
 }
 
 /**************************************************************************************************/
@@ -139,6 +310,173 @@ void FirstGameImpl::OnImGuiRender()
 {
     ImGui::Begin("Stats");
     ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    const render::RenderStats& stats = renderer_.Stats();
+    ImGui::Text("%u draw calls (%u objects in %u batches)", stats.draw_calls, stats.objects, stats.batches);
+    bool batching = renderer_.Batching();
+    if (ImGui::Checkbox("Batch renderables", &batching)) {
+        renderer_.SetBatching(batching);
+    }
+    ImGui::Text("State changes: %u shader binds, %u VAO binds", stats.shader_binds, stats.vao_binds);
+    ImGui::Text("GL state calls: %llu issued, %llu elided", static_cast<unsigned long long>(stats.state_calls_issued),
+                static_cast<unsigned long long>(stats.state_calls_elided));
+    bool sorting = renderer_.Sorting();
+    if (ImGui::Checkbox("Sort draw commands", &sorting)) {
+        renderer_.SetSorting(sorting);
+    }
+    ImGui::Text("Objects: %u visible, %u culled", stats.simple.visible, stats.simple.culled);
+    ImGui::Text("Instances: %u visible, %u culled", stats.instanced.visible, stats.instanced.culled);
+    bool culling = renderer_.Culling();
+    if (ImGui::Checkbox("Frustum culling", &culling)) {
+        renderer_.SetCulling(culling);
+    }
+    ImGui::Text("Update: %.3f ms/frame, %.3f ms latency", frame_ms_, latency_ms_);
+    ImGui::Checkbox("Pipelined (simulate next frame while submitting)", &pipelined_);
+    if (startup_ms_ < 0.0f) {
+        ImGui::Text("Startup: loading %zu assets", system_.Loader().NumPending());
+    }
+    else {
+        ImGui::Text("Startup: %.3f ms until all assets loaded", startup_ms_);
+    }
+    const render::ShaderStats& shaders = render::ShaderLibrary::current().stats();
+    ImGui::Text("Shaders: %.3f ms creating %u built, %u from program cache, %u rejected, %u reloaded", shaders.create_ms,
+                shaders.built, shaders.cached, shaders.rejected, shaders.reloaded);
+    const system::LoaderStats& loader = system_.Loader().Stats();
+    ImGui::Text("Uploads: %u in %.3f ms this frame, %.3f ms max", loader.uploads, loader.upload_ms, loader.max_upload_ms);
+    const system::AssetCacheStats cache = system_.AssetManager().Cache().Stats();
+    ImGui::Text("Asset cache: %zu entries, %zu KiB, %llu hits, %llu misses, %llu dedups, %llu evictions", cache.entries,
+                cache.bytes / 1024, static_cast<unsigned long long>(cache.hits), static_cast<unsigned long long>(cache.misses),
+                static_cast<unsigned long long>(cache.dedups), static_cast<unsigned long long>(cache.evictions));
+    const render::StreamingStats& streaming = streamer_.Stats();
+    const render::StreamingConfig& streaming_config = streamer_.Config();
+    ImGui::Text("Streaming: %u cells resident, %u loading, %llu loads, %llu unloads", streaming.resident_cells,
+                streaming.loading_cells, static_cast<unsigned long long>(streaming.loads),
+                static_cast<unsigned long long>(streaming.unloads));
+    ImGui::Text("Streaming memory: %zu/%zu KiB CPU, %zu/%zu KiB GPU", streaming.cpu_bytes / 1024,
+                streaming_config.cpu_budget / 1024, streaming.gpu_bytes / 1024, streaming_config.gpu_budget / 1024);
+    ImGui::Text("Streaming latency: %.3f ms last, %.3f ms avg, %.3f ms max", streaming.last_load_ms,
+                streaming.avg_load_ms, streaming.max_load_ms);
+    auto& jobs = system_.Jobs();
+    ImGui::Text("Motion: %.3f ms for %zu entities", motion_ms_, motion_system_.NumIntegrated());
+    ImGui::Text("World matrices recomputed: %zu", transform_system_.NumRecomputed() + motion_system_.NumIntegrated());
+    const render::AabbTree& tree = spatial_system_.Tree();
+    ImGui::Text("Spatial index: %zu proxies, height %d, %zu changed", tree.size(), tree.Height(),
+                spatial_system_.NumChanged());
+    int max_threads = static_cast<int>(jobs.MaxThreads());
+    if (ImGui::SliderInt("Threads", &max_threads, 1, static_cast<int>(jobs.NumWorkers()) + 1)) {
+        jobs.SetMaxThreads(static_cast<unsigned int>(max_threads));
+    }
+    bool deterministic = jobs.Deterministic();
+    if (ImGui::Checkbox("Deterministic", &deterministic)) {
+        jobs.SetDeterministic(deterministic);
+    }
+    ImGui::End();
+
+    ProfilerWindow();
+
+    // the platform renders the UI with its own GL calls next, out of the renderer's state cache
+    renderer_.InvalidateState();
+}
+
+/**************************************************************************************************/
+
+void FirstGameImpl::ProfilerWindow()
+{
+    using system::ProfileZone;
+    system::Profiler& profiler = system_.Profiler();
+    ImGui::Begin("Profiler");
+    bool enabled = system::Profiler::Enabled();
+    if (ImGui::Checkbox("Record", &enabled)) {
+        profiler.SetEnabled(enabled);
+    }
+    ImGui::SameLine();
+    bool paused = profiler.Paused();
+    if (ImGui::Checkbox("Pause", &paused)) {
+        profiler.SetPaused(paused);
+    }
+
+    // capture of the next frames into a trace file
+    system::TraceCapture& trace = system_.Trace();
+    ImGui::InputInt("Trace frames", &trace_frames_);
+    trace_frames_ = std::max(trace_frames_, 1);
+    ImGui::SameLine();
+    if (trace.Capturing()) {
+        ImGui::Text("Capturing %u/%d", trace.NumCaptured(), trace_frames_);
+    }
+    else if (ImGui::Button("Capture")) {
+        profiler.SetEnabled(true);
+        profiler.SetPaused(false);
+        trace.Start(static_cast<unsigned int>(trace_frames_));
+    }
+    if (const std::string& path = trace.LastPath(); not path.empty()) {
+        ImGui::Text("Last trace: %s", path.c_str());
+    }
+
+    // frame times, oldest first
+    constexpr int kNumFrames = static_cast<int>(system::Profiler::kNumFrames);
+    float frame_ms[kNumFrames] = {};
+    for (int age = 0; age < kNumFrames; age++) {
+        if (const system::ProfileFrame* frame = profiler.Frame(static_cast<size_t>(age))) {
+            frame_ms[kNumFrames - 1 - age] = static_cast<float>(frame->end_ns - frame->start_ns) * 1e-6f;
+        }
+    }
+    ImGui::PlotHistogram("##frame_times", frame_ms, kNumFrames, 0, "frame times (ms)", 0.0f, 33.3f, ImVec2(-1.0f, 60.0f));
+    ImGui::SliderInt("Frame age", &profiled_age_, 0, kNumFrames - 1);
+    const system::ProfileFrame* frame = profiler.Frame(static_cast<size_t>(profiled_age_));
+    if (not frame) {
+        ImGui::Text("No frame recorded yet");
+        ImGui::End();
+        return;
+    }
+    ImGui::Text("Frame %llu: %.3f ms, %zu zones, %zu GPU passes", static_cast<unsigned long long>(frame->number),
+                static_cast<float>(frame->end_ns - frame->start_ns) * 1e-6f, frame->zones.size(), frame->gpu_zones.size());
+    ImGui::Text("Allocations: %llu, %llu KiB", static_cast<unsigned long long>(frame->allocations.count),
+                static_cast<unsigned long long>(frame->allocations.bytes / 1024));
+    const util::FrameArena& arena = system_.FrameArena();
+    ImGui::Text("Frame arena: %zu KiB peak of %zu KiB, %llu overflows", arena.HighWater() / 1024,
+                arena.Current().Capacity() / 1024, static_cast<unsigned long long>(arena.NumOverflows()));
+
+    // timeline of the frame, a row per thread and one for the GPU, nested zones stacked down
+    constexpr float kLabelWidth = 90.0f;
+    const float lane_height = ImGui::GetTextLineHeight() + 2.0f;
+    const float width = std::max(ImGui::GetContentRegionAvail().x - kLabelWidth, 1.0f);
+    const double px_per_ns = width / static_cast<double>(std::max<uint64_t>(frame->end_ns - frame->start_ns, 1));
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    const auto to_x = [&](uint64_t ns) {
+        return origin.x + kLabelWidth + static_cast<float>(static_cast<double>(ns - frame->start_ns) * px_per_ns);
+    };
+    float row_top = origin.y;
+    const auto draw_row = [&](const char* label, const std::vector<ProfileZone>& zones, auto&& in_row) {
+        draw_list->AddText(ImVec2(origin.x, row_top), IM_COL32(200, 200, 200, 255), label);
+        uint16_t max_depth = 0;
+        for (const ProfileZone& zone : zones) {
+            if (not in_row(zone)) {
+                continue;
+            }
+            // zones may have started in a previous frame, clip them to this one
+            const uint64_t start_ns = std::clamp(zone.start_ns, frame->start_ns, frame->end_ns);
+            const uint64_t end_ns = std::clamp(zone.end_ns, start_ns, frame->end_ns);
+            const float x0 = to_x(start_ns);
+            const float x1 = std::max(to_x(end_ns), x0 + 1.0f);
+            const float y0 = row_top + zone.depth * lane_height;
+            const ImVec2 min(x0, y0), max(x1, y0 + lane_height - 1.0f);
+            const float hue = static_cast<float>(std::hash<std::string_view>{}(zone.name) % 64) / 64.0f;
+            draw_list->AddRectFilled(min, max, ImColor::HSV(hue, 0.5f, 0.7f));
+            const ImVec4 clip(x0, y0, x1, y0 + lane_height);
+            draw_list->AddText(nullptr, 0.0f, ImVec2(x0 + 2.0f, y0), IM_COL32_WHITE, zone.name, nullptr, 0.0f, &clip);
+            if (ImGui::IsMouseHoveringRect(min, max)) {
+                ImGui::SetTooltip("%s: %.3f ms", zone.name, static_cast<float>(zone.end_ns - zone.start_ns) * 1e-6f);
+            }
+            max_depth = std::max(max_depth, zone.depth);
+        }
+        row_top += (max_depth + 1) * lane_height + 4.0f;
+    };
+    const std::vector<std::string> threads = profiler.ThreadNames();
+    for (size_t thread = 0; thread < threads.size(); thread++) {
+        draw_row(threads[thread].c_str(), frame->zones, [thread](const ProfileZone& zone) { return zone.thread == thread; });
+    }
+    draw_row("GPU", frame->gpu_zones, [](const ProfileZone&) { return true; });
+    ImGui::Dummy(ImVec2(kLabelWidth + width, row_top - origin.y));
     ImGui::End();
 }
 
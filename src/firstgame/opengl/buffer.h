@@ -3,6 +3,7 @@
 
 #include <utility>
 #include "gl/functions.h"
+#include "state_cache.h"
 
 namespace firstgame::opengl {
 
@@ -14,8 +15,13 @@ struct Buffer {
     /// Delete buffer if non-zero
     ~Buffer()
     {
-        if (id)
+        if (id) {
+            // objects may outlive the renderer owning the cache, in tools or at shutdown
+            if (auto* state = StateCache::try_current()) {
+                state->OnDeleteBuffer(id);
+            }
             glDeleteBuffers(1, &id);
+        }
     }
 
     /// For creating a null Buffer
@@ -33,7 +39,7 @@ struct Buffer {
     /// Move Assignment
     Buffer& operator=(Buffer&& other) noexcept
     {
-        id = std::exchange(other.id, 0);
+        std::swap(id, other.id);
         return *this;
     }
 
@@ -8,6 +8,8 @@
 #elif defined(FIRSTGAME_OPENGL_GLBINDING3)
 #include <glbinding/gl/extension.h>
 using namespace gl;
+#elif defined(FIRSTGAME_OPENGL_STUB)
+#include "firstgame/opengl/stub/gl_stub.h"
 #else
 #error "No OpenGL library specified!"
 #endif
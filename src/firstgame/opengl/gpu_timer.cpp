@@ -0,0 +1,94 @@
+#include "firstgame/opengl/gpu_timer.h"
+
+#include "firstgame/opengl/gl.h"
+#include "firstgame/system/profiler.h"
+
+namespace firstgame::opengl {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// GpuTimer
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// OpenGL ES has no GL_TIME_ELAPSED queries, passes are not timed there
+#ifndef FIRSTGAME_OPENGL_ES3
+
+GpuTimer::GpuTimer() : frames_(kNumFrames)
+{
+    for (Frame& frame : frames_) {
+        glGenQueries(kMaxPasses, frame.queries);
+    }
+}
+
+GpuTimer::~GpuTimer()
+{
+    for (Frame& frame : frames_) {
+        glDeleteQueries(kMaxPasses, frame.queries);
+    }
+}
+
+void GpuTimer::BeginFrame(uint64_t frame)
+{
+    Collect();
+    // a frame still pending has its results dropped, the GPU is more frames behind than kNumFrames
+    current_ = &frames_[frame % kNumFrames];
+    current_->number = frame;
+    current_->num_passes = 0;
+    current_->pending = false;
+}
+
+void GpuTimer::Begin(const char* name)
+{
+    if (not current_ || current_->num_passes == kMaxPasses || not system::Profiler::Enabled()) {
+        return;
+    }
+    const unsigned int pass = current_->num_passes;
+    current_->names[pass] = name;
+    current_->start_ns[pass] = system::Profiler::Now();
+    glBeginQuery(GL_TIME_ELAPSED, current_->queries[pass]);
+    timing_ = true;
+}
+
+void GpuTimer::End()
+{
+    if (not timing_) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    current_->num_passes++;
+    current_->pending = true;
+    timing_ = false;
+}
+
+void GpuTimer::Collect()
+{
+    for (Frame& frame : frames_) {
+        if (not frame.pending) {
+            continue;
+        }
+        // queries complete in order, the last one being available means all of them are
+        GLint available = 0;
+        glGetQueryObjectiv(frame.queries[frame.num_passes - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (not available) {
+            continue;
+        }
+        for (unsigned int pass = 0; pass < frame.num_passes; pass++) {
+            GLuint64 elapsed_ns = 0;
+            glGetQueryObjectui64v(frame.queries[pass], GL_QUERY_RESULT, &elapsed_ns);
+            system::Profiler::current().RecordGpu(frame.number, frame.names[pass], frame.start_ns[pass], elapsed_ns);
+        }
+        frame.pending = false;
+    }
+}
+
+#else
+
+GpuTimer::GpuTimer() = default;
+GpuTimer::~GpuTimer() = default;
+void GpuTimer::BeginFrame(uint64_t frame) {}
+void GpuTimer::Begin(const char* name) {}
+void GpuTimer::End() {}
+void GpuTimer::Collect() {}
+
+#endif
+
+}  // namespace firstgame::opengl
@@ -0,0 +1,61 @@
+#ifndef FIRSTGAME_OPENGL_GPU_TIMER_H_
+#define FIRSTGAME_OPENGL_GPU_TIMER_H_
+
+#include <vector>
+#include <cstdint>
+#include "gl/types.h"
+
+namespace firstgame::opengl {
+
+/// GpuTimer times the render passes of each frame on the GPU with GL_TIME_ELAPSED queries, reporting them to the
+/// system::Profiler. Results are read back a few frames later, once available, so timing never waits on the GPU.
+/// Queries do not nest, a pass ends before the next one begins.
+/// Example:
+/// ```
+///  timer.BeginFrame(profiler.FrameNumber());
+///  timer.Begin("3D");
+///  ...  // draws of the pass
+///  timer.End();
+/// ```
+class GpuTimer final {
+   public:
+    /// Number of frames in flight whose queries are pending
+    static constexpr unsigned int kNumFrames = 4;
+    /// Number of passes timed per frame, the next ones are not timed
+    static constexpr unsigned int kMaxPasses = 4;
+
+    GpuTimer();
+    ~GpuTimer();
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    /// Report the frames whose timings are available and start timing the passes of a new frame
+    void BeginFrame(uint64_t frame);
+
+    /// Time a pass of the current frame, `name` must be a static string
+    void Begin(const char* name);
+    void End();
+
+   private:
+    /// Report the timings of the pending frames whose queries completed
+    void Collect();
+
+   private:
+    /// Queries of a frame in flight
+    struct Frame {
+        uint64_t number = 0;
+        unsigned int num_passes = 0;
+        bool pending = false;  ///< whether the results were not read back yet
+        GLuint queries[kMaxPasses]{};
+        const char* names[kMaxPasses]{};
+        uint64_t start_ns[kMaxPasses]{};  ///< CPU time the pass began, to place it on the timeline
+    };
+
+    std::vector<Frame> frames_;
+    Frame* current_ = nullptr;
+    bool timing_ = false;  ///< whether a query is active
+};
+
+}  // namespace firstgame::opengl
+
+#endif  // FIRSTGAME_OPENGL_GPU_TIMER_H_
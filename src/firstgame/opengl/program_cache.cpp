@@ -0,0 +1,117 @@
+#include "firstgame/opengl/program_cache.h"
+
+#include <string>
+#include <cstring>
+
+#include "firstgame/opengl/gl.h"
+#include "firstgame/system/log.h"
+#include "firstgame/util/hash.h"
+
+namespace firstgame::opengl {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Cache file
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Header of a cache file, followed by the binary
+struct ProgramFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t size;
+};
+static_assert(sizeof(ProgramFileHeader) == 24);
+
+static constexpr char kMagic[4] = { 'F', 'G', 'P', 'B' };
+static constexpr uint32_t kVersion = 1;
+
+/// Driver string, or empty if unavailable
+static auto DriverString(GLenum name) -> std::string_view
+{
+    const auto* str = reinterpret_cast<const char*>(glGetString(name));
+    return str ? std::string_view(str) : std::string_view();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ProgramCache
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ProgramCache::ProgramCache(std::shared_ptr<platform::FileSystem> filesystem) : filesystem_(std::move(filesystem))
+{
+    GLint num_formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+    const auto cache_dir = filesystem_->CacheDir();
+    if (num_formats <= 0 || cache_dir.empty()) {
+        DEBUG("Program binary cache disabled ({} binary formats, cache dir '{}')", num_formats, cache_dir.c_str());
+        return;
+    }
+    dir_ = cache_dir / "programs";
+    driver_hash_ = util::Fnv1a(DriverString(GL_VENDOR));
+    driver_hash_ = util::Fnv1a(DriverString(GL_RENDERER), driver_hash_);
+    driver_hash_ = util::Fnv1a(DriverString(GL_VERSION), driver_hash_);
+    DEBUG("Program binary cache in '{}'", dir_.c_str());
+}
+
+uint64_t ProgramCache::key(const ShaderSourceArray& sources) const
+{
+    // sources are separated by their length, so moving code between stages changes the key
+    uint64_t hash = driver_hash_;
+    for (const auto& source : { std::optional(sources.vertex), std::optional(sources.fragment), sources.geometry }) {
+        const uint64_t size = source ? source->size() : ~0ull;
+        hash = util::Fnv1a(reinterpret_cast<const unsigned char*>(&size), sizeof(size), hash);
+        hash = util::Fnv1a(source.value_or(std::string_view()), hash);
+    }
+    return hash;
+}
+
+auto ProgramCache::path(std::string_view name) const -> std::filesystem::path
+{
+    return dir_ / (std::string(name) + ".fgprog");
+}
+
+auto ProgramCache::read(std::string_view name, uint64_t key) const -> std::optional<ProgramBinary>
+{
+    if (not enabled()) {
+        return std::nullopt;
+    }
+    auto file = filesystem_->Open(path(name).c_str());
+    if (not file) {
+        return std::nullopt;
+    }
+    const std::string content = file->ReadToString();
+    ProgramFileHeader header;
+    if (content.size() < sizeof(header)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, content.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion || header.key != key ||
+        header.size != content.size() - sizeof(header)) {
+        TRACE("Stale program binary of '{}'", name);
+        return std::nullopt;
+    }
+    ProgramBinary binary{ .format = static_cast<GLenum>(header.format), .data = std::vector<std::byte>(header.size) };
+    std::memcpy(binary.data.data(), content.data() + sizeof(header), header.size);
+    return binary;
+}
+
+bool ProgramCache::write(std::string_view name, uint64_t key, const ProgramBinary& binary) const
+{
+    if (not enabled()) {
+        return false;
+    }
+    ProgramFileHeader header{
+        .magic = {},
+        .version = kVersion,
+        .key = key,
+        .format = static_cast<uint32_t>(binary.format),
+        .size = static_cast<uint32_t>(binary.data.size()),
+    };
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    std::vector<std::byte> content(sizeof(header) + binary.data.size());
+    std::memcpy(content.data(), &header, sizeof(header));
+    std::memcpy(content.data() + sizeof(header), binary.data.data(), binary.data.size());
+    return filesystem_->Write(path(name).c_str(), content.data(), content.size());
+}
+
+}  // namespace firstgame::opengl
@@ -0,0 +1,61 @@
+#ifndef FIRSTGAME_OPENGL_PROGRAM_CACHE_H_
+#define FIRSTGAME_OPENGL_PROGRAM_CACHE_H_
+
+#include <memory>
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+#include <string_view>
+
+#include "firstgame/opengl/shader.h"
+#include "firstgame/platform/filesystem.h"
+
+namespace firstgame::opengl {
+
+/// ProgramCache persists linked program binaries in the platform's cache directory, so later launches create
+/// the programs without compiling and linking GLSL. A binary is keyed by the hash of its sources and of the driver
+/// (vendor, renderer and version), a stale one is simply not read, and one rejected by the driver anyway must fall
+/// back to a build from sources, see GLShader::from_binary().
+/// The cache is disabled if the platform has no cache directory or the driver supports no binary format.
+/// Must be created on the GL thread, then key(), read() and write() are thread-safe.
+/// Example:
+/// ```
+///  const uint64_t key = cache.key(sources);
+///  auto binary = cache.read("main", key);
+///  auto shader = binary ? GLShader::from_binary("main", *binary) : util::Scoped<GLShader>{};
+///  if (not shader) {
+///      shader = GLShader::build("main", sources, cache.enabled()).Assert();
+///      if (auto built = shader->binary()) cache.write("main", key, *built);
+///  }
+/// ```
+class ProgramCache final {
+   public:
+    explicit ProgramCache(std::shared_ptr<platform::FileSystem> filesystem);
+    ProgramCache(const ProgramCache&) = delete;
+    ProgramCache& operator=(const ProgramCache&) = delete;
+
+    /// Whether binaries are read and written at all
+    [[nodiscard]] bool enabled() const { return not dir_.empty(); }
+
+    /// Key of a program's binary for the current driver
+    [[nodiscard]] uint64_t key(const ShaderSourceArray& sources) const;
+
+    /// Read the cached binary of a program, or nothing if not cached under this key
+    [[nodiscard]] auto read(std::string_view name, uint64_t key) const -> std::optional<ProgramBinary>;
+
+    /// Write the binary of a program, replacing the cached one. Returns false on failure.
+    bool write(std::string_view name, uint64_t key, const ProgramBinary& binary) const;
+
+   private:
+    /// Cache file of a program
+    [[nodiscard]] auto path(std::string_view name) const -> std::filesystem::path;
+
+   private:
+    std::shared_ptr<platform::FileSystem> filesystem_;
+    std::filesystem::path dir_;  ///< empty when disabled
+    uint64_t driver_hash_ = 0;
+};
+
+}  // namespace firstgame::opengl
+
+#endif  // FIRSTGAME_OPENGL_PROGRAM_CACHE_H_
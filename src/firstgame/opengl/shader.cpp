@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "firstgame/opengl/gl.h"
+#include "firstgame/opengl/state_cache.h"
 #include "firstgame/system/log.h"
 
 namespace firstgame::opengl {
@@ -22,7 +23,7 @@ namespace firstgame::opengl {
 using ScopedShaderObj = util::Scoped<GLuint, std::decay_t<decltype(glDeleteShader)>>;
 
 /// Compile shader source into an object
-static auto CompileShader(GLenum shader_type, const char* shader_src) -> ScopedShaderObj;
+static auto CompileShader(GLenum shader_type, std::string_view shader_src) -> ScopedShaderObj;
 
 /// Link shader objects into a program
 [[nodiscard]] static bool LinkShader(GLuint program, const struct ShaderObjArray& shaders);
@@ -47,6 +48,10 @@ GLShader::GLShader(std::string name) : name_(std::move(name)), id_(glCreateProgr
 
 GLShader::~GLShader()
 {
+    // programs may outlive the renderer owning the cache, in tools or at shutdown
+    if (auto* state = StateCache::try_current()) {
+        state->OnDeleteProgram(id_);
+    }
     glDeleteProgram(id_);
     TRACE("Delete GLShader program '{}' [{}]", name_, id_);
 }
@@ -54,13 +59,13 @@ GLShader::~GLShader()
 void GLShader::bind()
 {
     // TRACE("Binding GLShader program '{}' [{}]", name_, id_);
-    glUseProgram(id_);
+    StateCache::current().UseProgram(id_);
 }
 
 void GLShader::unbind()
 {
     // TRACE("Unbinding GLShader program '{}' [{}]", name_, id_);
-    glUseProgram(0);
+    StateCache::current().UseProgram(0);
 }
 
 GLint GLShader::attr_loc(GLAttr attr) const
@@ -115,11 +120,12 @@ void GLShader::load_unif_loc(const std::initializer_list<GLUnifInfo>& list)
     }
 }
 
-auto GLShader::build(std::string name, const struct ShaderSourceArray& sources) -> util::Scoped<GLShader>
+auto GLShader::build(std::string name, const struct ShaderSourceArray& sources, bool retrievable)
+    -> util::Scoped<GLShader>
 {
-    auto vertex = CompileShader(GL_VERTEX_SHADER, sources.vertex.data());
-    auto fragment = CompileShader(GL_FRAGMENT_SHADER, sources.fragment.data());
-    auto geometry = sources.geometry ? CompileShader(GL_GEOMETRY_SHADER, sources.geometry->data()) : ScopedShaderObj{};
+    auto vertex = CompileShader(GL_VERTEX_SHADER, sources.vertex);
+    auto fragment = CompileShader(GL_FRAGMENT_SHADER, sources.fragment);
+    auto geometry = sources.geometry ? CompileShader(GL_GEOMETRY_SHADER, *sources.geometry) : ScopedShaderObj{};
 
     if (not vertex || not fragment || (sources.geometry && not geometry)) {
         ERROR("Failed to Compile Shaders");
@@ -127,6 +133,10 @@ auto GLShader::build(std::string name, const struct ShaderSourceArray& sources)
     }
 
     auto shader = util::make_scoped<GLShader>(std::move(name));
+    if (retrievable) {
+        // keep the binary retrievable for the program binary cache, some drivers only provide it when hinted
+        glProgramParameteri(shader->id_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, static_cast<GLint>(GL_TRUE));
+    }
     if (not LinkShader(shader->id_, { *vertex, *fragment, (geometry ? std::optional(*geometry) : std::nullopt) })) {
         ERROR("Failed to Link GLShader program");
         return {};
@@ -136,10 +146,46 @@ auto GLShader::build(std::string name, const struct ShaderSourceArray& sources)
     return shader;
 }
 
-auto CompileShader(GLenum shader_type, const char* shader_src) -> ScopedShaderObj
+auto GLShader::from_binary(std::string name, const ProgramBinary& binary) -> util::Scoped<GLShader>
+{
+    auto shader = util::make_scoped<GLShader>(std::move(name));
+    glProgramBinary(shader->id_, binary.format, binary.data.data(), static_cast<GLsizei>(binary.data.size()));
+
+    GLint link_status = 0;
+    glGetProgramiv(shader->id_, GL_LINK_STATUS, &link_status);
+    if (!link_status) {
+        DEBUG("Rejected binary of GLShader program '{}' [{}]", shader->name_, shader->id_);
+        return {};
+    }
+
+    DEBUG("Loaded binary of GLShader program '{}' [{}]", shader->name_, shader->id_);
+    return shader;
+}
+
+auto GLShader::binary() const -> std::optional<ProgramBinary>
+{
+    GLint length = 0;
+    glGetProgramiv(id_, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return std::nullopt;
+    }
+    ProgramBinary binary{ .format = {}, .data = std::vector<std::byte>(static_cast<size_t>(length)) };
+    GLsizei written = 0;
+    glGetProgramBinary(id_, length, &written, &binary.format, binary.data.data());
+    if (written <= 0) {
+        return std::nullopt;
+    }
+    binary.data.resize(static_cast<size_t>(written));
+    return binary;
+}
+
+auto CompileShader(GLenum shader_type, std::string_view shader_src) -> ScopedShaderObj
 {
     auto shader = util::make_scoped_final<GLuint>(&glDeleteShader, glCreateShader(shader_type));
-    glShaderSource(*shader, 1, &shader_src, nullptr);
+    // sources are not null-terminated when viewing a mapped file, so pass their length
+    const GLchar* src = shader_src.data();
+    const auto src_len = static_cast<GLint>(shader_src.size());
+    glShaderSource(*shader, 1, &src, &src_len);
     glCompileShader(*shader);
 
     GLint info_len = 0;
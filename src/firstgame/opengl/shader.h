@@ -2,6 +2,8 @@
 #define FIRSTGAME_OPENGL_SHADER_H_
 
 #include <string>
+#include <vector>
+#include <cstddef>
 #include <optional>
 #include <variant>
 #include "firstgame/util/scoped.h"
@@ -51,9 +53,18 @@ class GLShader final {
     /// Load uniforms' location into local array
     void load_unif_loc(const std::initializer_list<struct GLUnifInfo>& list);
 
+    /// Get the linked program's binary, or nothing if the driver does not provide one
+    [[nodiscard]] auto binary() const -> std::optional<struct ProgramBinary>;
+
    public:
-    /// Build the shader program from sources
-    static auto build(std::string name, const struct ShaderSourceArray& sources) -> util::Scoped<GLShader>;
+    /// Build the shader program from sources. `retrievable` hints the driver to keep the binary for binary(), only
+    /// for a program binary cache, as it needs GL 4.1 or ARB_get_program_binary.
+    static auto build(std::string name, const struct ShaderSourceArray& sources, bool retrievable = false)
+        -> util::Scoped<GLShader>;
+
+    /// Create the shader program from a binary retrieved with binary(), skipping compilation and linking.
+    /// The returned object is empty if the driver rejects the binary, e.g. after a driver update.
+    static auto from_binary(std::string name, const struct ProgramBinary& binary) -> util::Scoped<GLShader>;
 
    private:
     /// Program name
@@ -85,6 +96,12 @@ struct ShaderSourceArray {
     std::optional<std::string_view> geometry = std::nullopt;
 };
 
+/// Linked program binary, only valid for the driver it was retrieved from.
+struct ProgramBinary {
+    GLenum format;
+    std::vector<std::byte> data;
+};
+
 /// Stringify opengl shader type.
 auto shader_type_str(GLenum shader_type) -> std::string_view;
 
@@ -0,0 +1,126 @@
+#include "firstgame/opengl/state_cache.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include "firstgame/opengl/gl.h"
+
+namespace firstgame::opengl {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// StateCache
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateCache::UseProgram(GLuint program)
+{
+    if (Changed(program_.Set(program)))
+        glUseProgram(program);
+}
+
+void StateCache::BindVertexArray(GLuint array)
+{
+    if (Changed(vertex_array_.Set(array)))
+        glBindVertexArray(array);
+}
+
+void StateCache::BindBuffer(GLenum target, GLuint buffer)
+{
+    bool changed = true;
+    if (target == GL_ARRAY_BUFFER)
+        changed = array_buffer_.Set(buffer);
+    else if (target == GL_COPY_WRITE_BUFFER)
+        changed = copy_write_buffer_.Set(buffer);
+    if (Changed(changed))
+        glBindBuffer(target, buffer);
+}
+
+void StateCache::Enable(GLenum cap)
+{
+    auto it = std::find_if(capabilities_.begin(), capabilities_.end(), [&](const auto& item) { return item.first == cap; });
+    if (it == capabilities_.end())
+        it = capabilities_.insert(it, { cap, {} });
+    if (Changed(it->second.Set(true)))
+        glEnable(cap);
+}
+
+void StateCache::Disable(GLenum cap)
+{
+    auto it = std::find_if(capabilities_.begin(), capabilities_.end(), [&](const auto& item) { return item.first == cap; });
+    if (it == capabilities_.end())
+        it = capabilities_.insert(it, { cap, {} });
+    if (Changed(it->second.Set(false)))
+        glDisable(cap);
+}
+
+void StateCache::PolygonMode(GLenum face, GLenum mode)
+{
+    if (Changed(polygon_mode_.Set({ face, mode })))
+        glPolygonMode(face, mode);
+}
+
+void StateCache::ClearColor(float red, float green, float blue, float alpha)
+{
+    if (Changed(clear_color_.Set(Color{ { red, green, blue, alpha } })))
+        glClearColor(red, green, blue, alpha);
+}
+
+void StateCache::UniformMatrix4fv(GLint location, const float* value)
+{
+    // uniforms belong to the program, so without a known program there is nothing to compare against
+    bool changed = true;
+    if (program_.known) {
+        const uint64_t key = static_cast<uint64_t>(program_.value) << 32 | static_cast<uint32_t>(location);
+        Matrix matrix;
+        std::memcpy(matrix.values, value, sizeof(matrix.values));
+        changed = uniforms_[key].Set(matrix);
+    }
+    if (Changed(changed))
+        glUniformMatrix4fv(location, 1, GL_FALSE, value);
+}
+
+void StateCache::OnDeleteProgram(GLuint program)
+{
+    // deleting the current program only flags it for deletion, it stays in use until another one is bound
+    for (auto it = uniforms_.begin(); it != uniforms_.end();) {
+        it = (it->first >> 32) == program ? uniforms_.erase(it) : std::next(it);
+    }
+}
+
+void StateCache::OnDeleteVertexArray(GLuint array)
+{
+    // deleting a bound object reverts the binding to zero
+    if (vertex_array_.known && vertex_array_.value == array)
+        vertex_array_.value = 0;
+}
+
+void StateCache::OnDeleteBuffer(GLuint buffer)
+{
+    for (Shadow<GLuint>* binding : { &array_buffer_, &copy_write_buffer_ }) {
+        if (binding->known && binding->value == buffer)
+            binding->value = 0;
+    }
+}
+
+void StateCache::Invalidate()
+{
+    program_ = {};
+    vertex_array_ = {};
+    array_buffer_ = {};
+    copy_write_buffer_ = {};
+    capabilities_.clear();
+    polygon_mode_ = {};
+    clear_color_ = {};
+    uniforms_.clear();
+}
+
+bool StateCache::Color::operator==(const Color& other) const
+{
+    return std::memcmp(rgba, other.rgba, sizeof(rgba)) == 0;
+}
+
+bool StateCache::Matrix::operator==(const Matrix& other) const
+{
+    return std::memcmp(values, other.values, sizeof(values)) == 0;
+}
+
+}  // namespace firstgame::opengl
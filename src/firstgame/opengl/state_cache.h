@@ -0,0 +1,108 @@
+#ifndef FIRSTGAME_OPENGL_STATE_CACHE_H_
+#define FIRSTGAME_OPENGL_STATE_CACHE_H_
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+
+#include "firstgame/util/currenton.h"
+#include "gl/types.h"
+#include "gl/enum.h"
+
+namespace firstgame::opengl {
+
+/// StateCache shadows the GL context state set by the engine and drops the calls that would not change it.
+/// It tracks the bound program, vertex array, array and copy buffers, capabilities, polygon mode,
+/// clear color and the 4x4 matrix uniforms of every program.
+/// All changes to the tracked state must go through the cache, or be followed by Invalidate(),
+/// for example after a UI library rendered with its own GL calls.
+/// Since it is a Currenton, the GL wrappers reach it with current(); only one GL context is supported.
+/// Example:
+/// ```
+///  auto& state = StateCache::current();
+///  state.UseProgram(program);  // issued
+///  state.UseProgram(program);  // elided
+/// ```
+class StateCache final : public util::Currenton<StateCache> {
+   public:
+    /// Number of calls made to the cache, split into those forwarded to GL and those dropped
+    struct Counters {
+        uint64_t issued{};
+        uint64_t elided{};
+    };
+
+    StateCache() = default;
+    StateCache(const StateCache&) = delete;
+    StateCache& operator=(const StateCache&) = delete;
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint array);
+    /// The element array buffer binding belongs to the vertex array, so it is always issued
+    void BindBuffer(GLenum target, GLuint buffer);
+    void Enable(GLenum cap);
+    void Disable(GLenum cap);
+    void PolygonMode(GLenum face, GLenum mode);
+    void ClearColor(float red, float green, float blue, float alpha);
+    /// Set a mat4 uniform of the current program
+    void UniformMatrix4fv(GLint location, const float* value);
+
+    /// Forget objects being deleted, whose names may be reused by the driver
+    void OnDeleteProgram(GLuint program);
+    void OnDeleteVertexArray(GLuint array);
+    void OnDeleteBuffer(GLuint buffer);
+
+    /// Forget all the shadowed state, so the next calls are issued
+    void Invalidate();
+
+    [[nodiscard]] const Counters& counters() const { return counters_; }
+    void ResetCounters() { counters_ = {}; }
+
+   private:
+    /// Count a call and return whether it must be issued
+    bool Changed(bool changed)
+    {
+        (changed ? counters_.issued : counters_.elided)++;
+        return changed;
+    }
+
+   private:
+    /// Value of a state that may be unknown
+    template<typename T>
+    struct Shadow {
+        T value{};
+        bool known = false;
+
+        /// Update the value, returning whether it changed
+        bool Set(const T& new_value)
+        {
+            const bool changed = not known || not(value == new_value);
+            value = new_value;
+            known = true;
+            return changed;
+        }
+    };
+    struct Color {
+        float rgba[4];
+        bool operator==(const Color& other) const;
+    };
+    struct Matrix {
+        float values[16];
+        bool operator==(const Matrix& other) const;
+    };
+
+    Counters counters_;
+    Shadow<GLuint> program_;
+    Shadow<GLuint> vertex_array_;
+    Shadow<GLuint> array_buffer_;
+    Shadow<GLuint> copy_write_buffer_;
+    std::vector<std::pair<GLenum, Shadow<bool>>> capabilities_;
+    Shadow<std::pair<GLenum, GLenum>> polygon_mode_;
+    Shadow<Color> clear_color_;
+    /// mat4 uniforms by program and location
+    std::unordered_map<uint64_t, Shadow<Matrix>> uniforms_;
+};
+
+}  // namespace firstgame::opengl
+
+#endif  // FIRSTGAME_OPENGL_STATE_CACHE_H_
@@ -0,0 +1,107 @@
+#include "firstgame/opengl/stream_buffer.h"
+
+#include "firstgame/opengl/gl.h"
+#include "firstgame/opengl/state_cache.h"
+#include "firstgame/system/log.h"
+
+namespace firstgame::opengl {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// StreamBuffer
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+StreamBuffer::StreamBuffer(GLsizeiptr region_size) : region_size_(region_size)
+{
+    StateCache::current().BindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+    glBufferData(GL_COPY_WRITE_BUFFER, region_size_ * kNumRegions, nullptr, GL_STREAM_DRAW);
+    TRACE("New StreamBuffer [{}] with {} regions of {} bytes", GLuint(buffer_), kNumRegions, region_size_);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    Flush();
+    for (GLsync& fence : fences_) {
+        if (fence)
+            glDeleteSync(fence);
+    }
+    TRACE("Delete StreamBuffer [{}]", GLuint(buffer_));
+}
+
+auto StreamBuffer::Allocate(GLsizeiptr size, GLsizeiptr alignment) -> std::optional<Slice>
+{
+    const GLsizeiptr offset = (head_ + alignment - 1) / alignment * alignment;
+    if (offset + size > region_size_) {
+        WARN("StreamBuffer [{}] region exhausted, requested {} bytes with {} left", GLuint(buffer_), size,
+             region_size_ - head_);
+        return std::nullopt;
+    }
+    if (not mapped_ && not Map()) {
+        return std::nullopt;
+    }
+    head_ = offset + size;
+    return Slice{ mapped_ + offset, region_ * region_size_ + offset, size };
+}
+
+void StreamBuffer::Flush()
+{
+    if (not mapped_) {
+        return;
+    }
+    // also reached from the destructor, which may run after the renderer owning the cache
+    if (auto* state = StateCache::try_current()) {
+        state->BindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+    }
+    else {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+    }
+    glFlushMappedBufferRange(GL_COPY_WRITE_BUFFER, 0, head_);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    mapped_ = nullptr;
+}
+
+void StreamBuffer::Advance()
+{
+    Flush();
+    if (head_) {
+        ASSERT(fences_[region_] == nullptr);
+        fences_[region_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    region_ = (region_ + 1) % kNumRegions;
+    head_ = 0;
+}
+
+bool StreamBuffer::Map()
+{
+    StateCache::current().BindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+
+    if (GLsync& fence = fences_[region_]) {
+        // poll without blocking, the GPU is expected to be done with a region kNumRegions frames old
+        const GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) {
+            // orphan the storage rather than stalling, the driver keeps the old one alive for pending draws
+            DEBUG("StreamBuffer [{}] region {} still in use, orphaning storage", GLuint(buffer_), region_);
+            glBufferData(GL_COPY_WRITE_BUFFER, region_size_ * kNumRegions, nullptr, GL_STREAM_DRAW);
+            for (GLsync& other : fences_) {
+                if (other) {
+                    glDeleteSync(other);
+                    other = nullptr;
+                }
+            }
+        }
+        else {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    mapped_ = static_cast<unsigned char*>(glMapBufferRange(
+        GL_COPY_WRITE_BUFFER, region_ * region_size_, region_size_,
+        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+    if (not mapped_) {
+        ERROR("Failed to map StreamBuffer [{}] region {}", GLuint(buffer_), region_);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace firstgame::opengl
@@ -0,0 +1,71 @@
+#ifndef FIRSTGAME_OPENGL_STREAM_BUFFER_H_
+#define FIRSTGAME_OPENGL_STREAM_BUFFER_H_
+
+#include <optional>
+#include "gl/types.h"
+#include "buffer.h"
+
+namespace firstgame::opengl {
+
+/// StreamBuffer is a ring buffer for data re-written every frame, such as instance transforms.
+/// The buffer is split in kNumRegions regions, one per frame in flight. Each frame writes into its own
+/// region, mapped unsynchronized, while the GPU may still be reading the regions of previous frames.
+/// A fence is placed after the frame's draws and checked before its region is reused, so writing never
+/// waits on the GPU. If the GPU falls further behind than the ring, the storage is orphaned instead of stalling.
+/// Example:
+/// ```
+///  auto slice = stream.Allocate(count * sizeof(glm::mat4));
+///  std::memcpy(slice->data, models, slice->size);
+///  stream.Flush();    // before drawing from the stream
+///  ...                // draw with attributes sourced from stream at slice->offset
+///  stream.Advance();  // after all draws of the frame were issued
+/// ```
+class StreamBuffer final {
+   public:
+    /// Number of frames in flight
+    static constexpr unsigned int kNumRegions = 3;
+
+    /// Writable range of the current frame region
+    struct Slice {
+        void* data;       ///< mapped memory, write-only, valid until Flush()
+        GLintptr offset;  ///< byte offset in the buffer for the draw calls
+        GLsizeiptr size;  ///< size in bytes
+    };
+
+    explicit StreamBuffer(GLsizeiptr region_size);
+    ~StreamBuffer();
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    /// Allocate a slice from the current frame region.
+    /// Returns nullopt if the region does not have enough space left.
+    auto Allocate(GLsizeiptr size, GLsizeiptr alignment = 16) -> std::optional<Slice>;
+
+    /// Unmap the current region, making the written slices available to the GPU
+    void Flush();
+
+    /// Fence the current region and move on to the next one
+    void Advance();
+
+    /// Size in bytes of each frame region
+    [[nodiscard]] GLsizeiptr region_size() const { return region_size_; }
+
+    /// Implicit cast to the buffer ID
+    operator GLuint() const { return buffer_; }
+
+   private:
+    /// Map the current region for writing, waiting on its fence or orphaning the storage if still in use
+    bool Map();
+
+   private:
+    Buffer buffer_;
+    GLsync fences_[kNumRegions]{};
+    GLsizeiptr region_size_;
+    unsigned int region_ = 0;
+    GLsizeiptr head_ = 0;
+    unsigned char* mapped_ = nullptr;
+};
+
+}  // namespace firstgame::opengl
+
+#endif  // FIRSTGAME_OPENGL_STREAM_BUFFER_H_
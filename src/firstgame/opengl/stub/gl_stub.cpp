@@ -0,0 +1,480 @@
+#include "firstgame/opengl/stub/gl_stub.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace firstgame::opengl::stub {
+
+/**************************************************************************************************/
+
+/// Emulated context, only tracking what is needed to hand back consistent results
+struct Context {
+    std::vector<Call> calls;
+    GLuint next_name = 1;
+    std::unordered_map<GLuint, std::vector<unsigned char>> buffers;  ///< storage by buffer name
+    std::unordered_map<GLenum, GLuint> bindings;                     ///< bound buffer by target
+    std::unordered_map<std::string, GLint> locations;                ///< attribute/uniform location by name
+    std::unordered_set<GLuint> unlinked;                             ///< programs whose binary was rejected
+    std::unordered_map<GLuint, GLuint64> queries;                    ///< elapsed time by query name
+    std::chrono::steady_clock::time_point query_begin;               ///< begin of the active query
+    GLuint active_query = 0;
+    GLint next_location = 0;
+};
+
+static Context& context()
+{
+    static Context context;
+    return context;
+}
+
+template<typename A = uint64_t, typename B = uint64_t>
+static void Record(const char* function, A a = 0, B b = 0)
+{
+    const auto to_u64 = [](auto value) {
+        if constexpr (std::is_pointer_v<decltype(value)>)
+            return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value));
+        else
+            return static_cast<uint64_t>(value);
+    };
+    context().calls.push_back({ function, { to_u64(a), to_u64(b) } });
+}
+
+/// Location of an attribute or uniform, stable by name, four apart to fit matrix attributes
+static GLint Location(const GLchar* name)
+{
+    auto [it, inserted] = context().locations.try_emplace(name, context().next_location);
+    if (inserted) {
+        context().next_location += 4;
+    }
+    return it->second;
+}
+
+/// Program binary handed out by the stub, the only one it accepts back
+static constexpr std::string_view kProgramBinary = "firstgame-stub-program";
+static constexpr GLenum kProgramBinaryFormat = 1;
+
+/**************************************************************************************************/
+
+const std::vector<Call>& Calls()
+{
+    return context().calls;
+}
+
+size_t Count(std::string_view function)
+{
+    return std::count_if(context().calls.begin(), context().calls.end(),
+                         [&](const Call& call) { return function == call.function; });
+}
+
+void Reset()
+{
+    context().calls.clear();
+}
+
+}  // namespace firstgame::opengl::stub
+
+/**************************************************************************************************/
+
+using firstgame::opengl::stub::context;
+using firstgame::opengl::stub::kProgramBinary;
+using firstgame::opengl::stub::kProgramBinaryFormat;
+using firstgame::opengl::stub::Location;
+using firstgame::opengl::stub::Record;
+
+void glAttachShader(GLuint program, GLuint shader)
+{
+    Record(__func__, program, shader);
+}
+
+void glBeginQuery(GLenum target, GLuint id)
+{
+    Record(__func__, target, id);
+    context().active_query = id;
+    context().query_begin = std::chrono::steady_clock::now();
+}
+
+void glBindBuffer(GLenum target, GLuint buffer)
+{
+    Record(__func__, target, buffer);
+    context().bindings[target] = buffer;
+}
+
+void glBindTexture(GLenum target, GLuint texture)
+{
+    Record(__func__, target, texture);
+}
+
+void glBindVertexArray(GLuint array)
+{
+    Record(__func__, array);
+}
+
+void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    Record(__func__, target, size);
+    auto& storage = context().buffers[context().bindings[target]];
+    storage.assign(static_cast<size_t>(size), 0);
+    if (data) {
+        std::copy_n(static_cast<const unsigned char*>(data), size, storage.begin());
+    }
+}
+
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    Record(__func__, target, size);
+    auto& storage = context().buffers[context().bindings[target]];
+    if (static_cast<size_t>(offset + size) <= storage.size()) {
+        std::copy_n(static_cast<const unsigned char*>(data), size, storage.begin() + offset);
+    }
+}
+
+void glClear(GLbitfield mask)
+{
+    Record(__func__, mask);
+}
+
+void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    Record(__func__);
+}
+
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+    Record(__func__, sync, timeout);
+    return GL_ALREADY_SIGNALED;
+}
+
+void glCompileShader(GLuint shader)
+{
+    Record(__func__, shader);
+}
+
+GLuint glCreateProgram()
+{
+    Record(__func__);
+    return context().next_name++;
+}
+
+GLuint glCreateShader(GLenum type)
+{
+    Record(__func__, type);
+    return context().next_name++;
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    Record(__func__, n, n ? buffers[0] : 0);
+    for (GLsizei i = 0; i < n; i++) {
+        context().buffers.erase(buffers[i]);
+    }
+}
+
+void glDeleteProgram(GLuint program)
+{
+    Record(__func__, program);
+}
+
+void glDeleteQueries(GLsizei n, const GLuint* ids)
+{
+    Record(__func__, n, n ? ids[0] : 0);
+    for (GLsizei i = 0; i < n; i++) {
+        context().queries.erase(ids[i]);
+    }
+}
+
+void glDeleteShader(GLuint shader)
+{
+    Record(__func__, shader);
+}
+
+void glDeleteSync(GLsync sync)
+{
+    Record(__func__, sync);
+}
+
+void glDeleteTextures(GLsizei n, const GLuint* textures)
+{
+    Record(__func__, n, n ? textures[0] : 0);
+}
+
+void glDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    Record(__func__, n, n ? arrays[0] : 0);
+}
+
+void glDetachShader(GLuint program, GLuint shader)
+{
+    Record(__func__, program, shader);
+}
+
+void glDisable(GLenum cap)
+{
+    Record(__func__, cap);
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    Record(__func__, mode, count);
+}
+
+void glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount)
+{
+    Record(__func__, count, instancecount);
+}
+
+void glEnable(GLenum cap)
+{
+    Record(__func__, cap);
+}
+
+void glEnableVertexAttribArray(GLuint index)
+{
+    Record(__func__, index);
+}
+
+void glEndQuery(GLenum target)
+{
+    Record(__func__, target);
+    // the CPU time spent issuing the pass stands for its GPU time
+    const auto elapsed = std::chrono::steady_clock::now() - context().query_begin;
+    context().queries[context().active_query] =
+        static_cast<GLuint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    context().active_query = 0;
+}
+
+GLsync glFenceSync(GLenum condition, GLbitfield flags)
+{
+    Record(__func__, condition);
+    return reinterpret_cast<GLsync>(static_cast<uintptr_t>(context().next_name++));
+}
+
+void glFlushMappedBufferRange(GLenum target, GLintptr offset, GLsizeiptr length)
+{
+    Record(__func__, target, length);
+}
+
+void glGenBuffers(GLsizei n, GLuint* buffers)
+{
+    Record(__func__, n);
+    for (GLsizei i = 0; i < n; i++) {
+        buffers[i] = context().next_name++;
+    }
+}
+
+void glGenQueries(GLsizei n, GLuint* ids)
+{
+    Record(__func__, n);
+    for (GLsizei i = 0; i < n; i++) {
+        ids[i] = context().next_name++;
+    }
+}
+
+void glGenTextures(GLsizei n, GLuint* textures)
+{
+    Record(__func__, n);
+    for (GLsizei i = 0; i < n; i++) {
+        textures[i] = context().next_name++;
+    }
+}
+
+void glGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+    Record(__func__, n);
+    for (GLsizei i = 0; i < n; i++) {
+        arrays[i] = context().next_name++;
+    }
+}
+
+void glGetIntegerv(GLenum pname, GLint* data)
+{
+    Record(__func__, pname);
+    *data = pname == GL_NUM_PROGRAM_BINARY_FORMATS ? 1 : 0;
+}
+
+void glGetProgramBinary(GLuint program, GLsizei buf_size, GLsizei* length, GLenum* binary_format, void* binary)
+{
+    Record(__func__, program, buf_size);
+    const auto size = std::min(static_cast<size_t>(buf_size), kProgramBinary.size());
+    std::copy_n(kProgramBinary.data(), size, static_cast<char*>(binary));
+    if (length) {
+        *length = static_cast<GLsizei>(size);
+    }
+    *binary_format = kProgramBinaryFormat;
+}
+
+GLint glGetAttribLocation(GLuint program, const GLchar* name)
+{
+    Record(__func__, program);
+    return Location(name);
+}
+
+void glGetProgramInfoLog(GLuint program, GLsizei max_length, GLsizei* length, GLchar* info_log)
+{
+    Record(__func__, program);
+    if (length) {
+        *length = 0;
+    }
+    if (max_length > 0) {
+        info_log[0] = '\0';
+    }
+}
+
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    Record(__func__, program, pname);
+    switch (pname) {
+        case GL_LINK_STATUS: *params = context().unlinked.count(program) ? GL_FALSE : GL_TRUE; break;
+        case GL_PROGRAM_BINARY_LENGTH: *params = static_cast<GLint>(kProgramBinary.size()); break;
+        default: *params = 0; break;
+    }
+}
+
+void glGetQueryObjectiv(GLuint id, GLenum pname, GLint* params)
+{
+    Record(__func__, id, pname);
+    // results are available right away
+    *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+
+void glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params)
+{
+    Record(__func__, id, pname);
+    const auto it = context().queries.find(id);
+    *params = it != context().queries.end() ? it->second : 0;
+}
+
+void glGetShaderInfoLog(GLuint shader, GLsizei max_length, GLsizei* length, GLchar* info_log)
+{
+    Record(__func__, shader);
+    if (length) {
+        *length = 0;
+    }
+    if (max_length > 0) {
+        info_log[0] = '\0';
+    }
+}
+
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    Record(__func__, shader, pname);
+    *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+const GLubyte* glGetString(GLenum name)
+{
+    Record(__func__, name);
+    return reinterpret_cast<const GLubyte*>("stub");
+}
+
+GLint glGetUniformLocation(GLuint program, const GLchar* name)
+{
+    Record(__func__, program);
+    return Location(name);
+}
+
+void glLinkProgram(GLuint program)
+{
+    Record(__func__, program);
+    context().unlinked.erase(program);
+}
+
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    Record(__func__, target, length);
+    auto& storage = context().buffers[context().bindings[target]];
+    if (static_cast<size_t>(offset + length) > storage.size()) {
+        return nullptr;
+    }
+    return storage.data() + offset;
+}
+
+void glPixelStorei(GLenum pname, GLint param)
+{
+    Record(__func__, pname, param);
+}
+
+void glPolygonMode(GLenum face, GLenum mode)
+{
+    Record(__func__, face, mode);
+}
+
+void glProgramBinary(GLuint program, GLenum binary_format, const void* binary, GLsizei length)
+{
+    Record(__func__, program, binary_format);
+    const std::string_view data(static_cast<const char*>(binary), static_cast<size_t>(length));
+    if (binary_format == kProgramBinaryFormat && data == kProgramBinary) {
+        context().unlinked.erase(program);
+    }
+    else {
+        context().unlinked.insert(program);
+    }
+}
+
+void glProgramParameteri(GLuint program, GLenum pname, GLint value)
+{
+    Record(__func__, pname, value);
+}
+
+void glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+{
+    Record(__func__, shader, count);
+}
+
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border,
+                  GLenum format, GLenum type, const void* pixels)
+{
+    Record(__func__, level, width);
+}
+
+void glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    Record(__func__, pname, param);
+}
+
+void glTexStorage2D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    Record(__func__, levels, internalformat);
+}
+
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format,
+                     GLenum type, const void* pixels)
+{
+    Record(__func__, level, width);
+}
+
+void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    Record(__func__, location, count);
+}
+
+GLboolean glUnmapBuffer(GLenum target)
+{
+    Record(__func__, target);
+    return GL_TRUE;
+}
+
+void glUseProgram(GLuint program)
+{
+    Record(__func__, program);
+}
+
+void glVertexAttribDivisor(GLuint index, GLuint divisor)
+{
+    Record(__func__, index, divisor);
+}
+
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride,
+                           const void* pointer)
+{
+    Record(__func__, index, size);
+}
+
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    Record(__func__, width, height);
+}
@@ -0,0 +1,182 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This file declares a stub OpenGL API for building and running the engine without a GPU or context.
+/// The stub records every call made, so the GL traffic of the engine can be inspected, and emulates
+/// just enough of the object model (names, buffer storage, compile/link status) for the engine to run.
+/// It is selected with the FIRSTGAME_OPENGL_STUB option in place of a real OpenGL library.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FIRSTGAME_OPENGL_STUB_GL_STUB_H_
+#define FIRSTGAME_OPENGL_STUB_GL_STUB_H_
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**************************************************************************************************/
+// Types
+
+using GLenum = unsigned int;
+using GLboolean = unsigned char;
+using GLbitfield = unsigned int;
+using GLint = int;
+using GLuint = unsigned int;
+using GLsizei = int;
+using GLfloat = float;
+using GLchar = char;
+using GLubyte = unsigned char;
+using GLushort = unsigned short;
+using GLintptr = std::ptrdiff_t;
+using GLsizeiptr = std::ptrdiff_t;
+using GLuint64 = std::uint64_t;
+using GLsync = struct __GLsync*;
+
+/**************************************************************************************************/
+// Values
+
+#define GL_FALSE 0
+#define GL_TRUE 1
+#define GL_TRIANGLES 0x0004
+#define GL_FRONT_AND_BACK 0x0408
+#define GL_DEPTH_TEST 0x0B71
+#define GL_UNPACK_ALIGNMENT 0x0CF5
+#define GL_TEXTURE_2D 0x0DE1
+#define GL_UNSIGNED_BYTE 0x1401
+#define GL_UNSIGNED_SHORT 0x1403
+#define GL_FLOAT 0x1406
+#define GL_HALF_FLOAT 0x140B
+#define GL_RGBA 0x1908
+#define GL_FILL 0x1B02
+#define GL_VENDOR 0x1F00
+#define GL_RENDERER 0x1F01
+#define GL_VERSION 0x1F02
+#define GL_LINEAR 0x2601
+#define GL_LINEAR_MIPMAP_LINEAR 0x2703
+#define GL_TEXTURE_MAG_FILTER 0x2800
+#define GL_TEXTURE_MIN_FILTER 0x2801
+#define GL_RGBA8 0x8058
+#define GL_TEXTURE_MAX_LEVEL 0x813D
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_DEPTH_BUFFER_BIT 0x00000100
+#define GL_COLOR_BUFFER_BIT 0x00004000
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#define GL_MAP_FLUSH_EXPLICIT_BIT 0x0010
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_STREAM_DRAW 0x88E0
+#define GL_STATIC_DRAW 0x88E4
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_LINK_STATUS 0x8B82
+#define GL_INFO_LOG_LENGTH 0x8B84
+#define GL_GEOMETRY_SHADER 0x8DD9
+#define GL_TESS_EVALUATION_SHADER 0x8E87
+#define GL_TESS_CONTROL_SHADER 0x8E88
+#define GL_COPY_WRITE_BUFFER 0x8F37
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_WAIT_FAILED 0x911D
+#define GL_COMPUTE_SHADER 0x91B9
+
+/**************************************************************************************************/
+// Functions
+
+void glAttachShader(GLuint program, GLuint shader);
+void glBeginQuery(GLenum target, GLuint id);
+void glBindBuffer(GLenum target, GLuint buffer);
+void glBindTexture(GLenum target, GLuint texture);
+void glBindVertexArray(GLuint array);
+void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+void glClear(GLbitfield mask);
+void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+void glCompileShader(GLuint shader);
+GLuint glCreateProgram();
+GLuint glCreateShader(GLenum type);
+void glDeleteBuffers(GLsizei n, const GLuint* buffers);
+void glDeleteProgram(GLuint program);
+void glDeleteQueries(GLsizei n, const GLuint* ids);
+void glDeleteShader(GLuint shader);
+void glDeleteSync(GLsync sync);
+void glDeleteTextures(GLsizei n, const GLuint* textures);
+void glDeleteVertexArrays(GLsizei n, const GLuint* arrays);
+void glDetachShader(GLuint program, GLuint shader);
+void glDisable(GLenum cap);
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+void glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount);
+void glEnable(GLenum cap);
+void glEnableVertexAttribArray(GLuint index);
+void glEndQuery(GLenum target);
+GLsync glFenceSync(GLenum condition, GLbitfield flags);
+void glFlushMappedBufferRange(GLenum target, GLintptr offset, GLsizeiptr length);
+void glGenBuffers(GLsizei n, GLuint* buffers);
+void glGenQueries(GLsizei n, GLuint* ids);
+void glGenTextures(GLsizei n, GLuint* textures);
+void glGenVertexArrays(GLsizei n, GLuint* arrays);
+void glGetIntegerv(GLenum pname, GLint* data);
+void glGetProgramBinary(GLuint program, GLsizei buf_size, GLsizei* length, GLenum* binary_format, void* binary);
+GLint glGetAttribLocation(GLuint program, const GLchar* name);
+void glGetProgramInfoLog(GLuint program, GLsizei max_length, GLsizei* length, GLchar* info_log);
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params);
+void glGetQueryObjectiv(GLuint id, GLenum pname, GLint* params);
+void glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params);
+void glGetShaderInfoLog(GLuint shader, GLsizei max_length, GLsizei* length, GLchar* info_log);
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params);
+const GLubyte* glGetString(GLenum name);
+GLint glGetUniformLocation(GLuint program, const GLchar* name);
+void glLinkProgram(GLuint program);
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+void glPixelStorei(GLenum pname, GLint param);
+void glPolygonMode(GLenum face, GLenum mode);
+void glProgramBinary(GLuint program, GLenum binary_format, const void* binary, GLsizei length);
+void glProgramParameteri(GLuint program, GLenum pname, GLint value);
+void glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length);
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border,
+                  GLenum format, GLenum type, const void* pixels);
+void glTexParameteri(GLenum target, GLenum pname, GLint param);
+void glTexStorage2D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height);
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format,
+                     GLenum type, const void* pixels);
+void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+GLboolean glUnmapBuffer(GLenum target);
+void glUseProgram(GLuint program);
+void glVertexAttribDivisor(GLuint index, GLuint divisor);
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride,
+                           const void* pointer);
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+/**************************************************************************************************/
+// Recording
+
+namespace firstgame::opengl::stub {
+
+/// Call made to the stub API, with its first two integral or enum arguments (zero if none)
+struct Call {
+    const char* function;
+    uint64_t args[2];
+};
+
+/// Calls recorded since the last Reset(), in order
+const std::vector<Call>& Calls();
+
+/// Number of recorded calls of a function
+size_t Count(std::string_view function);
+
+/// Forget the recorded calls, keeping the emulated objects
+void Reset();
+
+}  // namespace firstgame::opengl::stub
+
+#endif  // FIRSTGAME_OPENGL_STUB_GL_STUB_H_
@@ -0,0 +1,52 @@
+#ifndef FIRSTGAME_OPENGL_TEXTURE_H_
+#define FIRSTGAME_OPENGL_TEXTURE_H_
+
+#include <utility>
+#include "gl/types.h"
+#include "gl/functions.h"
+
+namespace firstgame::opengl {
+
+/// Representation of a opengl texture generated with glGenTextures
+struct Texture {
+    /// Create and generate the texture object
+    Texture() { glGenTextures(1, &id); }
+
+    /// Delete texture if non-zero
+    ~Texture()
+    {
+        if (id) {
+            glDeleteTextures(1, &id);
+        }
+    }
+
+    /// For creating a null Texture
+    struct Null {
+    };
+    /// Create a non-initialized Texture
+    Texture(Null) noexcept : id(0) {}
+
+    /// Implicit cast to the texture ID
+    operator GLuint() const { return id; }
+
+    /// Move constructor
+    Texture(Texture&& other) noexcept : id(std::exchange(other.id, 0)) {}
+
+    /// Move Assignment
+    Texture& operator=(Texture&& other) noexcept
+    {
+        std::swap(id, other.id);
+        return *this;
+    }
+
+    /// Deleted Copy constructor/assignment
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+   private:
+    GLuint id;
+};
+
+}  // namespace firstgame::opengl
+
+#endif  // FIRSTGAME_OPENGL_TEXTURE_H_
@@ -4,6 +4,7 @@
 #include <utility>
 #include "gl/types.h"
 #include "gl/functions.h"
+#include "state_cache.h"
 
 namespace firstgame::opengl {
 
@@ -15,8 +16,13 @@ struct VertexArray {
     /// Delete buffer if non-zero
     ~VertexArray()
     {
-        if (id)
+        if (id) {
+            // objects may outlive the renderer owning the cache, in tools or at shutdown
+            if (auto* state = StateCache::try_current()) {
+                state->OnDeleteVertexArray(id);
+            }
             glDeleteVertexArrays(1, &id);
+        }
     }
 
     /// For creating a null VertexArray
@@ -34,7 +40,7 @@ struct VertexArray {
     /// Move Assignment
     VertexArray& operator=(VertexArray&& other) noexcept
     {
-        id = std::exchange(other.id, 0);
+        std::swap(id, other.id);
         return *this;
     }
 
@@ -0,0 +1,187 @@
+#include "firstgame/platform/posix_filesystem.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <functional>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "firstgame/system/log.h"
+
+namespace firstgame::platform {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// PosixFile
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// File opened with a POSIX file descriptor, mapped on demand
+class PosixFile final : public File {
+   public:
+    PosixFile(int fd, std::filesystem::path path) : fd_(fd), path_(std::move(path)) {}
+    ~PosixFile() override { Close(); }
+
+    PosixFile(const PosixFile&) = delete;
+    PosixFile& operator=(const PosixFile&) = delete;
+
+    auto ReadToString() -> std::string override;
+    auto Map() -> std::optional<FileView> override;
+    void Close() override;
+    auto Path() -> std::filesystem::path override { return path_; }
+
+   private:
+    /// Size of the file, or nothing on error
+    auto Size() -> std::optional<size_t>;
+
+   private:
+    int fd_;
+    std::filesystem::path path_;
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+};
+
+auto PosixFile::Size() -> std::optional<size_t>
+{
+    struct stat info {};
+    if (fstat(fd_, &info) != 0) {
+        ERROR("Failed to stat file ({}): {}", path_.c_str(), std::strerror(errno));
+        return std::nullopt;
+    }
+    return static_cast<size_t>(info.st_size);
+}
+
+auto PosixFile::ReadToString() -> std::string
+{
+    std::string content;
+    if (fd_ < 0) {
+        return content;
+    }
+    const auto size = Size();
+    content.resize(size.value_or(0));
+    size_t offset = 0;
+    while (offset < content.size()) {
+        const ssize_t count = pread(fd_, content.data() + offset, content.size() - offset, static_cast<off_t>(offset));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            if (count < 0) {
+                ERROR("Failed to read file ({}): {}", path_.c_str(), std::strerror(errno));
+            }
+            break;
+        }
+        offset += static_cast<size_t>(count);
+    }
+    content.resize(offset);
+    return content;
+}
+
+auto PosixFile::Map() -> std::optional<FileView>
+{
+    if (mapping_) {
+        return FileView{ static_cast<const std::byte*>(mapping_), mapping_size_ };
+    }
+    if (fd_ < 0) {
+        return std::nullopt;
+    }
+    const auto size = Size();
+    if (not size) {
+        return std::nullopt;
+    }
+    if (*size == 0) {
+        // empty files cannot be mapped, there is nothing to read anyway
+        return FileView{ nullptr, 0 };
+    }
+    void* mapping = mmap(nullptr, *size, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        WARN("Failed to map file ({}): {}", path_.c_str(), std::strerror(errno));
+        return std::nullopt;
+    }
+    mapping_ = mapping;
+    mapping_size_ = *size;
+    TRACE("Mapped file ({}) of {} bytes", path_.c_str(), mapping_size_);
+    return FileView{ static_cast<const std::byte*>(mapping_), mapping_size_ };
+}
+
+void PosixFile::Close()
+{
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// PosixFileSystem
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+auto PosixFileSystem::Open(const char* filename) -> std::unique_ptr<File>
+{
+    const int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    return std::make_unique<PosixFile>(fd, filename);
+}
+
+bool PosixFileSystem::Write(const char* filename, const void* data, std::size_t size)
+{
+    const std::filesystem::path path(filename);
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    if (error) {
+        WARN("Failed to create directory ({}): {}", path.parent_path().c_str(), error.message());
+        return false;
+    }
+
+    // unique per process and thread, so concurrent writers of the same file do not clobber each other's temporary
+    const std::string temp = path.string() + ".tmp" + std::to_string(getpid()) + "." +
+                             std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    const int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        WARN("Failed to create file ({}): {}", temp, std::strerror(errno));
+        return false;
+    }
+    const auto* bytes = static_cast<const char*>(data);
+    size_t offset = 0;
+    while (offset < size) {
+        const ssize_t count = ::write(fd, bytes + offset, size - offset);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        offset += static_cast<size_t>(count);
+    }
+    const bool complete = offset == size;
+    const bool closed = close(fd) == 0;
+    if (not complete || not closed || rename(temp.c_str(), filename) != 0) {
+        WARN("Failed to write file ({}): {}", filename, std::strerror(errno));
+        unlink(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+auto PosixFileSystem::DefaultCacheDir() -> std::filesystem::path
+{
+    if (const char* xdg_cache = std::getenv("XDG_CACHE_HOME"); xdg_cache && *xdg_cache) {
+        return std::filesystem::path(xdg_cache) / "firstgame";
+    }
+    if (const char* home = std::getenv("HOME"); home && *home) {
+        return std::filesystem::path(home) / ".cache" / "firstgame";
+    }
+    return {};
+}
+
+}  // namespace firstgame::platform
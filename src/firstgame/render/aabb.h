@@ -0,0 +1,88 @@
+#ifndef FIRSTGAME_RENDER_AABB_H_
+#define FIRSTGAME_RENDER_AABB_H_
+
+#include <cmath>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vector_relational.hpp>
+
+#include "frustum.h"
+
+namespace firstgame::render {
+
+/// Axis-aligned bounding box in world space
+struct Aabb final {
+    glm::vec3 min;
+    glm::vec3 max;
+
+    /// Box enclosing a bounding sphere (xyz: center, w: radius)
+    static Aabb FromSphere(const glm::vec4& sphere)
+    {
+        const glm::vec3 center{ sphere };
+        return { center - sphere.w, center + sphere.w };
+    }
+
+    /// Smallest box enclosing both boxes
+    static Aabb Union(const Aabb& a, const Aabb& b) { return { glm::min(a.min, b.min), glm::max(a.max, b.max) }; }
+
+    /// Box grown by a margin on every side
+    [[nodiscard]] Aabb Fattened(float margin) const { return { min - margin, max + margin }; }
+
+    /// Sum of the areas of the faces, the cost metric of the tree insertion
+    [[nodiscard]] float SurfaceArea() const
+    {
+        const glm::vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    [[nodiscard]] bool Contains(const Aabb& other) const
+    {
+        return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+    }
+
+    [[nodiscard]] bool Overlaps(const Aabb& other) const
+    {
+        return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::greaterThanEqual(max, other.min));
+    }
+
+    /// Whether the box is at least partially inside the frustum, testing the corner furthest along each plane normal
+    [[nodiscard]] bool Intersects(const Frustum& frustum) const
+    {
+        for (const glm::vec4& plane : frustum.planes) {
+            const glm::vec3 normal{ plane };
+            const glm::vec3 corner = glm::mix(min, max, glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+            if (glm::dot(normal, corner) + plane.w < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Distance along the ray where it enters the box, or a negative value if it misses within [0, max_distance].
+    /// A zero direction component gives an infinite `inv_direction` one, the ray being parallel to that axis' slab.
+    [[nodiscard]] float Intersects(const glm::vec3& origin, const glm::vec3& inv_direction, float max_distance) const
+    {
+        float enter = 0.0f;
+        float exit = max_distance;
+        for (int axis = 0; axis < 3; axis++) {
+            if (std::isinf(inv_direction[axis])) {
+                // parallel: the slab is crossed over the whole ray or never, 0 * inf would give NaN below
+                if (origin[axis] < min[axis] || origin[axis] > max[axis]) {
+                    return -1.0f;
+                }
+                continue;
+            }
+            const float t0 = (min[axis] - origin[axis]) * inv_direction[axis];
+            const float t1 = (max[axis] - origin[axis]) * inv_direction[axis];
+            enter = glm::max(enter, glm::min(t0, t1));
+            exit = glm::min(exit, glm::max(t0, t1));
+        }
+        return enter <= exit ? enter : -1.0f;
+    }
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_AABB_H_
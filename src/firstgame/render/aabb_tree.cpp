@@ -0,0 +1,254 @@
+#include "aabb_tree.h"
+
+#include <algorithm>
+
+namespace firstgame::render {
+
+/**************************************************************************************************/
+
+int32_t AabbTree::CreateProxy(const Aabb& box, uint32_t user_data)
+{
+    const int32_t proxy = AllocateNode();
+    nodes_[proxy].box = box.Fattened(margin_);
+    nodes_[proxy].user_data = user_data;
+    nodes_[proxy].height = 0;
+    InsertLeaf(proxy);
+    num_proxies_++;
+    return proxy;
+}
+
+/**************************************************************************************************/
+
+void AabbTree::DestroyProxy(int32_t proxy)
+{
+    ASSERT(proxy >= 0 && proxy < static_cast<int32_t>(nodes_.size()) && nodes_[proxy].IsLeaf());
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    num_proxies_--;
+}
+
+/**************************************************************************************************/
+
+bool AabbTree::MoveProxy(int32_t proxy, const Aabb& box)
+{
+    ASSERT(proxy >= 0 && proxy < static_cast<int32_t>(nodes_.size()) && nodes_[proxy].IsLeaf());
+    Node& leaf = nodes_[proxy];
+    if (leaf.box.Contains(box)) {
+        return false;
+    }
+    const bool nearby = leaf.box.Overlaps(box);
+    leaf.box = box.Fattened(margin_);
+    if (nearby) {
+        // keep the leaf where it is and only refit the boxes above it
+        Refit(leaf.parent);
+    }
+    else {
+        RemoveLeaf(proxy);
+        InsertLeaf(proxy);
+    }
+    return true;
+}
+
+/**************************************************************************************************/
+
+void AabbTree::Clear()
+{
+    nodes_.clear();
+    root_ = kNull;
+    free_list_ = kNull;
+    num_proxies_ = 0;
+}
+
+/**************************************************************************************************/
+
+int32_t AabbTree::AllocateNode()
+{
+    int32_t node;
+    if (free_list_ != kNull) {
+        node = free_list_;
+        free_list_ = nodes_[node].parent;
+    }
+    else {
+        node = static_cast<int32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    nodes_[node] = Node{ .box = {}, .user_data = 0, .parent = kNull, .child1 = kNull, .child2 = kNull, .height = 0 };
+    return node;
+}
+
+/**************************************************************************************************/
+
+void AabbTree::FreeNode(int32_t node)
+{
+    nodes_[node].parent = free_list_;
+    nodes_[node].height = -1;
+    free_list_ = node;
+}
+
+/**************************************************************************************************/
+
+void AabbTree::InsertLeaf(int32_t leaf)
+{
+    if (root_ == kNull) {
+        root_ = leaf;
+        nodes_[leaf].parent = kNull;
+        return;
+    }
+
+    // descend towards the sibling with the least cost, the increase of surface area of the tree
+    const Aabb leaf_box = nodes_[leaf].box;
+    int32_t index = root_;
+    while (not nodes_[index].IsLeaf()) {
+        const Node& node = nodes_[index];
+        const float area = node.box.SurfaceArea();
+        const float combined_area = Aabb::Union(node.box, leaf_box).SurfaceArea();
+        // cost of creating a new parent for this node and the leaf
+        const float cost = 2.0f * combined_area;
+        // minimum cost of pushing the leaf further down, inherited by the children
+        const float inheritance = 2.0f * (combined_area - area);
+        const auto child_cost = [&](int32_t child) {
+            const Aabb& box = nodes_[child].box;
+            const float new_area = Aabb::Union(box, leaf_box).SurfaceArea();
+            return (nodes_[child].IsLeaf() ? new_area : new_area - box.SurfaceArea()) + inheritance;
+        };
+        const float cost1 = child_cost(node.child1);
+        const float cost2 = child_cost(node.child2);
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+    const int32_t sibling = index;
+
+    // create a new parent for the sibling and the leaf
+    const int32_t old_parent = nodes_[sibling].parent;
+    const int32_t new_parent = AllocateNode();
+    nodes_[new_parent].parent = old_parent;
+    nodes_[new_parent].box = Aabb::Union(leaf_box, nodes_[sibling].box);
+    nodes_[new_parent].height = nodes_[sibling].height + 1;
+    nodes_[new_parent].child1 = sibling;
+    nodes_[new_parent].child2 = leaf;
+    nodes_[sibling].parent = new_parent;
+    nodes_[leaf].parent = new_parent;
+    if (old_parent != kNull) {
+        (nodes_[old_parent].child1 == sibling ? nodes_[old_parent].child1 : nodes_[old_parent].child2) = new_parent;
+    }
+    else {
+        root_ = new_parent;
+    }
+
+    Refit(old_parent);
+}
+
+/**************************************************************************************************/
+
+void AabbTree::RemoveLeaf(int32_t leaf)
+{
+    if (leaf == root_) {
+        root_ = kNull;
+        return;
+    }
+
+    // replace the parent with the sibling
+    const int32_t parent = nodes_[leaf].parent;
+    const int32_t grand_parent = nodes_[parent].parent;
+    const int32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+    nodes_[sibling].parent = grand_parent;
+    FreeNode(parent);
+    if (grand_parent != kNull) {
+        (nodes_[grand_parent].child1 == parent ? nodes_[grand_parent].child1 : nodes_[grand_parent].child2) = sibling;
+        Refit(grand_parent);
+    }
+    else {
+        root_ = sibling;
+    }
+}
+
+/**************************************************************************************************/
+
+void AabbTree::Refit(int32_t index)
+{
+    while (index != kNull) {
+        index = Balance(index);
+        Node& node = nodes_[index];
+        const Node& child1 = nodes_[node.child1];
+        const Node& child2 = nodes_[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.box = Aabb::Union(child1.box, child2.box);
+        index = node.parent;
+    }
+}
+
+/**************************************************************************************************/
+
+int32_t AabbTree::Balance(int32_t ia)
+{
+    Node& a = nodes_[ia];
+    if (a.IsLeaf() || a.height < 2) {
+        return ia;
+    }
+
+    const int32_t ib = a.child1;
+    const int32_t ic = a.child2;
+    Node& b = nodes_[ib];
+    Node& c = nodes_[ic];
+    const int32_t balance = c.height - b.height;
+
+    // replace `a` by its child `up` in a's parent
+    const auto promote = [&](int32_t iup, Node& up) {
+        up.child1 = ia;
+        up.parent = a.parent;
+        a.parent = iup;
+        if (up.parent != kNull) {
+            (nodes_[up.parent].child1 == ia ? nodes_[up.parent].child1 : nodes_[up.parent].child2) = iup;
+        }
+        else {
+            root_ = iup;
+        }
+    };
+
+    // rotate c up
+    if (balance > 1) {
+        const int32_t if_ = c.child1;
+        const int32_t ig = c.child2;
+        Node& f = nodes_[if_];
+        Node& g = nodes_[ig];
+        promote(ic, c);
+        // the taller grandchild stays with c, the other goes to a
+        const bool f_taller = f.height > g.height;
+        const int32_t ikeep = f_taller ? if_ : ig;
+        const int32_t imove = f_taller ? ig : if_;
+        c.child2 = ikeep;
+        a.child2 = imove;
+        nodes_[imove].parent = ia;
+        a.box = Aabb::Union(b.box, nodes_[imove].box);
+        c.box = Aabb::Union(a.box, nodes_[ikeep].box);
+        a.height = 1 + std::max(b.height, nodes_[imove].height);
+        c.height = 1 + std::max(a.height, nodes_[ikeep].height);
+        return ic;
+    }
+
+    // rotate b up
+    if (balance < -1) {
+        const int32_t id = b.child1;
+        const int32_t ie = b.child2;
+        Node& d = nodes_[id];
+        Node& e = nodes_[ie];
+        promote(ib, b);
+        const bool d_taller = d.height > e.height;
+        const int32_t ikeep = d_taller ? id : ie;
+        const int32_t imove = d_taller ? ie : id;
+        b.child2 = ikeep;
+        a.child1 = imove;
+        nodes_[imove].parent = ia;
+        a.box = Aabb::Union(c.box, nodes_[imove].box);
+        b.box = Aabb::Union(a.box, nodes_[ikeep].box);
+        a.height = 1 + std::max(c.height, nodes_[imove].height);
+        b.height = 1 + std::max(a.height, nodes_[ikeep].height);
+        return ib;
+    }
+
+    return ia;
+}
+
+}  // namespace firstgame::render
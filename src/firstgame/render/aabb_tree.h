@@ -0,0 +1,157 @@
+#ifndef FIRSTGAME_RENDER_AABB_TREE_H_
+#define FIRSTGAME_RENDER_AABB_TREE_H_
+
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+#include <glm/vec3.hpp>
+
+#include "firstgame/system/log.h"
+#include "aabb.h"
+#include "frustum.h"
+
+namespace firstgame::render {
+
+/// AabbTree is a dynamic bounding volume hierarchy over boxes ("proxies") that carry a user value.
+/// Leaves store boxes fattened by a margin, so that objects moving a little do not touch the tree at all.
+/// An object leaving its fat box gets the leaf enlarged and its ancestors refitted, which keeps the topology;
+/// only objects that teleport away from their previous box are removed and re-inserted.
+/// Insertion picks the sibling with the least surface area cost, and rotations keep the tree balanced.
+/// Example:
+/// ```
+///  int32_t proxy = tree.CreateProxy(box, entity);
+///  tree.MoveProxy(proxy, new_box);
+///  tree.Query(frustum, [&](uint32_t entity) { visible.push_back(entity); return true; });
+/// ```
+class AabbTree final {
+   public:
+    /// Invalid node index
+    static constexpr int32_t kNull = -1;
+
+    /// Create a tree whose leaves are fattened by `margin` on every side
+    explicit AabbTree(float margin = 0.1f) : margin_(margin) {}
+
+    /// Insert a box, returning the proxy ID that identifies it
+    int32_t CreateProxy(const Aabb& box, uint32_t user_data);
+
+    /// Remove a proxy
+    void DestroyProxy(int32_t proxy);
+
+    /// Update the box of a proxy. Returns true if the tree changed, false if the box still fits the fat box.
+    bool MoveProxy(int32_t proxy, const Aabb& box);
+
+    /// Remove all proxies, keeping the allocated memory
+    void Clear();
+
+    /// User value of a proxy
+    [[nodiscard]] uint32_t UserData(int32_t proxy) const { return nodes_[proxy].user_data; }
+
+    /// Fat box of a proxy
+    [[nodiscard]] const Aabb& FatBox(int32_t proxy) const { return nodes_[proxy].box; }
+
+    /// Number of proxies in the tree
+    [[nodiscard]] size_t size() const { return num_proxies_; }
+
+    /// Height of the tree, zero for a single leaf
+    [[nodiscard]] int32_t Height() const { return root_ == kNull ? 0 : nodes_[root_].height; }
+
+    /// Call `func(user_data)` for every proxy whose fat box overlaps the box, until it returns false
+    template<typename Func>
+    void Query(const Aabb& box, Func&& func) const
+    {
+        Traverse([&](const Aabb& node) { return node.Overlaps(box); }, func);
+    }
+
+    /// Call `func(user_data)` for every proxy whose fat box intersects the frustum, until it returns false
+    template<typename Func>
+    void Query(const Frustum& frustum, Func&& func) const
+    {
+        Traverse([&](const Aabb& node) { return node.Intersects(frustum); }, func);
+    }
+
+    /// Call `func(user_data, distance)` for every proxy whose fat box is hit by the ray within `max_distance`,
+    /// where `distance` is where the ray enters the fat box. The callback returns the new maximum distance,
+    /// which lets it clip the ray to the closest hit found so far, or zero to stop.
+    /// Zero components of `direction` are fine, the ray then runs parallel to those axes.
+    template<typename Func>
+    void RayCast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, Func&& func) const
+    {
+        const glm::vec3 inv_direction = 1.0f / direction;
+        Traverse(
+            [&](const Aabb& node) { return node.Intersects(origin, inv_direction, max_distance) >= 0.0f; },
+            [&](uint32_t user_data, const Aabb& leaf) {
+                max_distance = func(user_data, leaf.Intersects(origin, inv_direction, max_distance));
+                return max_distance > 0.0f;
+            });
+    }
+
+   private:
+    struct Node {
+        Aabb box;
+        uint32_t user_data;
+        int32_t parent;  ///< parent node, or next free node while in the free list
+        int32_t child1;
+        int32_t child2;
+        int32_t height;  ///< leaves are 0, free nodes are -1
+
+        [[nodiscard]] bool IsLeaf() const { return child1 == kNull; }
+    };
+
+    /// Maximum depth of the traversal stack, the tree is balanced so this allows for far more proxies than memory
+    static constexpr int kStackSize = 256;
+
+    /// Depth-first traversal of the nodes accepted by `filter`, calling `visit` on the leaves until it returns false
+    template<typename Filter, typename Visit>
+    void Traverse(Filter&& filter, Visit&& visit) const
+    {
+        if (root_ == kNull) {
+            return;
+        }
+        int32_t stack[kStackSize];
+        int count = 0;
+        stack[count++] = root_;
+        while (count) {
+            const Node& node = nodes_[stack[--count]];
+            if (not filter(node.box)) {
+                continue;
+            }
+            if (node.IsLeaf()) {
+                bool proceed;
+                if constexpr (std::is_invocable_v<Visit, uint32_t, const Aabb&>) {
+                    proceed = visit(node.user_data, node.box);
+                }
+                else {
+                    proceed = visit(node.user_data);
+                }
+                if (not proceed) {
+                    return;
+                }
+            }
+            else {
+                ASSERT(count + 2 <= kStackSize);
+                stack[count++] = node.child1;
+                stack[count++] = node.child2;
+            }
+        }
+    }
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t node);
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+    /// Recompute boxes and heights from a node up to the root, rebalancing on the way
+    void Refit(int32_t node);
+    /// Rotate the subtree at `a` if it is unbalanced, returning the new subtree root
+    int32_t Balance(int32_t a);
+
+   private:
+    std::vector<Node> nodes_;
+    int32_t root_ = kNull;
+    int32_t free_list_ = kNull;
+    size_t num_proxies_ = 0;
+    float margin_;
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_AABB_TREE_H_
@@ -76,6 +76,7 @@ class CameraPerspective final {
     }
 
     [[nodiscard]] const ViewProjection& Matrix() const { return matrix_; }
+    [[nodiscard]] const glm::vec3& Position() const { return position_; }
 
    private:
     [[nodiscard]] glm::mat4 CalculateView() const
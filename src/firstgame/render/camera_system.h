@@ -11,7 +11,6 @@
 #include "camera_perspective.h"
 #include "camera_orthographic.h"
 #include "render_pass.h"
-#include "firstgame/opengl/shader.h"
 
 namespace firstgame::render {
 
@@ -51,7 +50,11 @@ class CameraSystem {
         last_ypos = ypos;
     }
 
-    void Render(RenderPass pass, opengl::GLShader& shader) const;
+    /// View and projection matrices of the camera used for the render pass
+    [[nodiscard]] const ViewProjection& Matrix(RenderPass pass) const;
+
+    /// Position of the 3D camera in world space, around which the world is streamed
+    [[nodiscard]] const glm::vec3& Position() const { return perspective_.Position(); }
 
    private:
     CameraPerspective perspective_;
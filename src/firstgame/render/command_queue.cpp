@@ -0,0 +1,67 @@
+#include "command_queue.h"
+
+#include <utility>
+#include <algorithm>
+
+namespace firstgame::render {
+
+/**************************************************************************************************/
+
+uint64_t CommandQueue::MakeKey(RenderPass pass, MyShader shader, uint16_t material, GLuint vao, float depth)
+{
+    constexpr uint32_t kDepthMax = (1u << 24) - 1;
+    const auto quantized_depth = static_cast<uint32_t>(std::clamp(depth, 0.0f, 1.0f) * kDepthMax);
+    return (static_cast<uint64_t>(pass) & 0xF) << 60 | (static_cast<uint64_t>(shader) & 0xFF) << 52 |
+           (static_cast<uint64_t>(material) & 0xFFF) << 40 | (static_cast<uint64_t>(vao) & 0xFFFF) << 24 |
+           quantized_depth;
+}
+
+/**************************************************************************************************/
+
+void CommandQueue::Clear()
+{
+    entries_.clear();
+    commands_.clear();
+}
+
+/**************************************************************************************************/
+
+void CommandQueue::Push(uint64_t key, const DrawCommand& command)
+{
+    entries_.push_back({ key, static_cast<uint32_t>(commands_.size()) });
+    commands_.push_back(command);
+}
+
+/**************************************************************************************************/
+
+void CommandQueue::Sort()
+{
+    constexpr int kNumDigits = sizeof(uint64_t);
+    // histograms of all digits in a single pass over the keys
+    size_t counts[kNumDigits][256]{};
+    for (const Entry& entry : entries_) {
+        for (int digit = 0; digit < kNumDigits; digit++) {
+            counts[digit][(entry.key >> (digit * 8)) & 0xFF]++;
+        }
+    }
+
+    scratch_.resize(entries_.size());
+    for (int digit = 0; digit < kNumDigits; digit++) {
+        size_t* count = counts[digit];
+        // skip digits that are the same for all keys, which is most of them within a frame
+        const size_t first = (entries_.empty() ? 0 : entries_.front().key >> (digit * 8)) & 0xFF;
+        if (count[first] == entries_.size()) {
+            continue;
+        }
+        size_t offset = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            offset += std::exchange(count[bucket], offset);
+        }
+        for (const Entry& entry : entries_) {
+            scratch_[count[(entry.key >> (digit * 8)) & 0xFF]++] = entry;
+        }
+        entries_.swap(scratch_);
+    }
+}
+
+}  // namespace firstgame::render
@@ -0,0 +1,93 @@
+#ifndef FIRSTGAME_RENDER_COMMAND_QUEUE_H_
+#define FIRSTGAME_RENDER_COMMAND_QUEUE_H_
+
+#include <vector>
+#include <cstdint>
+
+#include "firstgame/opengl/gl/types.h"
+#include "render_pass.h"
+#include "shader_lib.h"
+
+namespace firstgame::render {
+
+struct Mesh;
+
+/// Draw packet recorded by the renderer, replayed in sort key order.
+/// Model matrices are referenced by index into the recorded frame, so commands hold no GPU offsets
+/// and can be recorded away from the GL thread.
+struct DrawCommand final {
+    MyShader shader;
+    GLuint vao;                  ///< vertex array, zero for a batched draw
+    const Mesh* mesh;            ///< mesh of a batched draw, drawn with the batch vertex array of the mesh
+    GLsizei num_indices;
+    unsigned int num_instances;  ///< zero for a non-instanced draw, which uses the model uniform
+    uint32_t first_model;        ///< index of the model matrix, or of the first instance, in the frame's models
+    GLuint instance_buffer;      ///< static instance buffer, for instances not recorded in the frame's models
+};
+
+/// CommandQueue collects the draw commands of a frame with 64-bit sort keys, and sorts them before submission,
+/// so that draws sharing state end up next to each other. From the most to the least significant bits, the key
+/// holds the render pass, shader, material, vertex array and depth, which orders the frame by cost of state change:
+///
+///     | pass: 4 | shader: 8 | material: 12 | vertex array: 16 | depth: 24 |
+///
+/// Depth comes last, sorting draws with the same state front to back.
+/// Example:
+/// ```
+///  queue.Clear();
+///  queue.Push(CommandQueue::MakeKey(RenderPass::_3D, MyShader::SIMPLE, 0, vao, depth), command);
+///  queue.Sort();
+///  for (const DrawCommand& command : queue) { ... }
+/// ```
+class CommandQueue final {
+   public:
+    /// Compose a sort key, `depth` is normalized to [0, 1] and clamped
+    static uint64_t MakeKey(RenderPass pass, MyShader shader, uint16_t material, GLuint vao, float depth);
+
+    /// Discard the commands from the previous frame, keeping the allocated memory
+    void Clear();
+
+    /// Add a command to the queue
+    void Push(uint64_t key, const DrawCommand& command);
+
+    /// Sort the commands by key with a least-significant-digit radix sort, which is stable
+    void Sort();
+
+    /// Number of commands in the queue
+    [[nodiscard]] size_t size() const { return entries_.size(); }
+
+   private:
+    struct Entry {
+        uint64_t key;
+        uint32_t index;  ///< index of the command
+    };
+
+   public:
+    /// Iterator over the commands in key order (or submission order if not sorted)
+    class Iterator {
+       public:
+        Iterator(const DrawCommand* commands, const Entry* entry) : commands_(commands), entry_(entry) {}
+        const DrawCommand& operator*() const { return commands_[entry_->index]; }
+        Iterator& operator++()
+        {
+            ++entry_;
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return entry_ != other.entry_; }
+
+       private:
+        const DrawCommand* commands_;
+        const Entry* entry_;
+    };
+    [[nodiscard]] Iterator begin() const { return { commands_.data(), entries_.data() }; }
+    [[nodiscard]] Iterator end() const { return { commands_.data(), entries_.data() + entries_.size() }; }
+
+   private:
+    std::vector<Entry> entries_;
+    std::vector<Entry> scratch_;
+    std::vector<DrawCommand> commands_;
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_COMMAND_QUEUE_H_
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Culling definitions.
+/// For documentation, see the header file.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "culling.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace firstgame::render {
+
+/**************************************************************************************************/
+
+/// Whether a single sphere is inside or intersecting the frustum
+static bool SphereVisible(const Frustum& frustum, const glm::vec4& sphere)
+{
+    for (const glm::vec4& plane : frustum.planes) {
+        if (glm::dot(glm::vec3(plane), glm::vec3(sphere)) + plane.w < -sphere.w) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**************************************************************************************************/
+
+size_t CullSpheres(const Frustum& frustum, gsl::span<const glm::vec4> spheres, uint32_t* visible)
+{
+    size_t num_visible = 0;
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    // four spheres per iteration, transposed to x, y, z, radius vectors and tested against each plane
+    __m128 planes[6][4];
+    for (int p = 0; p < 6; p++) {
+        for (int c = 0; c < 4; c++) {
+            planes[p][c] = _mm_set1_ps(frustum.planes[p][c]);
+        }
+    }
+    for (; i + 4 <= spheres.size(); i += 4) {
+        __m128 x = _mm_loadu_ps(&spheres[i + 0].x);
+        __m128 y = _mm_loadu_ps(&spheres[i + 1].x);
+        __m128 z = _mm_loadu_ps(&spheres[i + 2].x);
+        __m128 r = _mm_loadu_ps(&spheres[i + 3].x);
+        _MM_TRANSPOSE4_PS(x, y, z, r);
+        const __m128 neg_r = _mm_sub_ps(_mm_setzero_ps(), r);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++) {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(planes[p][0], x), planes[p][3]);
+            distance = _mm_add_ps(distance, _mm_mul_ps(planes[p][1], y));
+            distance = _mm_add_ps(distance, _mm_mul_ps(planes[p][2], z));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, neg_r));
+        }
+        int mask = _mm_movemask_ps(inside);
+        while (mask) {
+            const int lane = __builtin_ctz(static_cast<unsigned int>(mask));
+            visible[num_visible++] = static_cast<uint32_t>(i + lane);
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i < spheres.size(); i++) {
+        if (SphereVisible(frustum, spheres[i])) {
+            visible[num_visible++] = static_cast<uint32_t>(i);
+        }
+    }
+    return num_visible;
+}
+
+}  // namespace firstgame::render
@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This file defines the culling of bounding volumes against the camera frustum, done on the CPU
+/// before submission so that objects outside of the view never reach the GPU.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FIRSTGAME_RENDER_CULLING_H_
+#define FIRSTGAME_RENDER_CULLING_H_
+
+#include <cstdint>
+#include <algorithm>
+#include <gsl/span>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/geometric.hpp>
+
+#include "frustum.h"
+
+namespace firstgame::render {
+
+/// Transform a bounding sphere (xyz: center, w: radius) from model space to world space,
+/// scaling the radius by the largest scale axis of the model matrix
+inline glm::vec4 TransformSphere(const glm::mat4& model, const glm::vec4& sphere)
+{
+    const glm::vec4 center = model * glm::vec4(glm::vec3(sphere), 1.0f);
+    const float scale = std::max({ glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])),
+                                   glm::length(glm::vec3(model[2])) });
+    return glm::vec4(glm::vec3(center), sphere.w * scale);
+}
+
+/// Test world space bounding spheres (xyz: center, w: radius) against the frustum, four at a time,
+/// writing the indices of the visible ones into `visible`, which must hold spheres.size() elements.
+/// Returns the number of visible spheres.
+size_t CullSpheres(const Frustum& frustum, gsl::span<const glm::vec4> spheres, uint32_t* visible);
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_CULLING_H_
@@ -0,0 +1,39 @@
+#ifndef FIRSTGAME_RENDER_FRAME_DATA_H_
+#define FIRSTGAME_RENDER_FRAME_DATA_H_
+
+#include <memory>
+#include <vector>
+#include <glm/mat4x4.hpp>
+
+#include "command_queue.h"
+#include "mesh.h"
+#include "render_stats.h"
+#include "view_projection.h"
+
+namespace firstgame::render {
+
+/// FrameData holds everything recorded from the registry to render one frame: the camera, the sorted draw
+/// commands and the model matrices they reference. Once recorded, the frame no longer depends on the registry,
+/// so it can be submitted on the GL thread while the registry is already being updated for the next frame.
+struct FrameData final {
+    ViewProjection camera{};
+    CommandQueue queue;
+    std::vector<glm::mat4> models;                    ///< model matrices referenced by the commands
+    std::vector<std::shared_ptr<const Mesh>> meshes;  ///< keeps the meshes of the commands alive until submitted
+    RenderStats stats;                                ///< culling stats when recorded, draw stats when submitted
+    bool recorded = false;                            ///< whether the frame is ready to be submitted
+
+    /// Discard the recorded frame, keeping the allocated memory
+    void Clear()
+    {
+        queue.Clear();
+        models.clear();
+        meshes.clear();
+        stats = {};
+        recorded = false;
+    }
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_FRAME_DATA_H_
@@ -0,0 +1,37 @@
+#ifndef FIRSTGAME_RENDER_FRUSTUM_H_
+#define FIRSTGAME_RENDER_FRUSTUM_H_
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/geometric.hpp>
+
+namespace firstgame::render {
+
+/// Frustum is the volume visible through a camera, bounded by six planes facing inwards.
+/// Each plane is stored as (normal.xyz, distance), normalized, so that dot(normal, point) + distance
+/// is the signed distance of a point to the plane.
+struct Frustum final {
+    glm::vec4 planes[6];  ///< left, right, bottom, top, near, far
+
+    /// Extract the frustum planes from a combined projection * view matrix (Gribb & Hartmann)
+    static Frustum FromMatrix(const glm::mat4& matrix)
+    {
+        const auto row = [&](int i) { return glm::vec4(matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i]); };
+        Frustum frustum{ {
+            row(3) + row(0),
+            row(3) - row(0),
+            row(3) + row(1),
+            row(3) - row(1),
+            row(3) + row(2),
+            row(3) - row(2),
+        } };
+        for (glm::vec4& plane : frustum.planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_FRUSTUM_H_
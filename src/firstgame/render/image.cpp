@@ -0,0 +1,189 @@
+#include "image.h"
+
+#include <string>
+#include <memory>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <stb_image.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "texture_format.h"
+
+namespace firstgame::render {
+
+using texture_format::LevelEntry;
+using texture_format::TextureHeader;
+
+/**************************************************************************************************/
+
+/// Size of the next mip level along one axis
+static uint32_t NextSize(uint32_t size)
+{
+    return std::max(size / 2, 1u);
+}
+
+/// Byte size of the whole mip chain of an image
+static size_t MipChainSize(uint32_t width, uint32_t height)
+{
+    size_t size = 0;
+    for (;;) {
+        size += size_t(width) * height * 4;
+        if (width == 1 && height == 1) {
+            return size;
+        }
+        width = NextSize(width);
+        height = NextSize(height);
+    }
+}
+
+/**************************************************************************************************/
+
+Image DecodeImage(gsl::span<const std::byte> bytes)
+{
+    if (bytes.size() > size_t(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("Image too large");
+    }
+    int width = 0, height = 0, channels = 0;
+    std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> decoded(
+        stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(bytes.data()), static_cast<int>(bytes.size()), &width,
+                              &height, &channels, 4),
+        &stbi_image_free);
+    if (not decoded) {
+        throw std::runtime_error(std::string("Failed to decode image: ") + stbi_failure_reason());
+    }
+
+    // room for the mip chain, so generating it does not copy the image again
+    Image image;
+    const size_t size = size_t(width) * size_t(height) * 4;
+    image.pixels.resize(MipChainSize(uint32_t(width), uint32_t(height)));
+    std::memcpy(image.pixels.data(), decoded.get(), size);
+    image.levels.push_back({ uint32_t(width), uint32_t(height), { image.pixels.data(), size } });
+    return image;
+}
+
+/**************************************************************************************************/
+
+void DownsampleRgba8(const std::byte* src, uint32_t src_width, uint32_t src_height, std::byte* dst)
+{
+    const uint32_t width = NextSize(src_width);
+    const uint32_t height = NextSize(src_height);
+    const size_t src_pitch = size_t(src_width) * 4;
+    for (uint32_t y = 0; y < height; y++) {
+        const auto* row0 = reinterpret_cast<const uint8_t*>(src) + std::min(2 * y, src_height - 1) * src_pitch;
+        const auto* row1 = reinterpret_cast<const uint8_t*>(src) + std::min(2 * y + 1, src_height - 1) * src_pitch;
+        auto* out = reinterpret_cast<uint8_t*>(dst) + size_t(y) * width * 4;
+        uint32_t x = 0;
+#if defined(__SSE2__)
+        // 4 output texels from 2 rows of 8 texels: average the rows, then the even and odd texels
+        if (src_width >= 2) {
+            for (; 2 * x + 8 <= src_width; x += 4) {
+                const __m128i lo = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8)),
+                                                _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8)));
+                const __m128i hi = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8 + 16)),
+                                                _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8 + 16)));
+                const __m128 lo_ps = _mm_castsi128_ps(lo);
+                const __m128 hi_ps = _mm_castsi128_ps(hi);
+                const __m128i even = _mm_castps_si128(_mm_shuffle_ps(lo_ps, hi_ps, _MM_SHUFFLE(2, 0, 2, 0)));
+                const __m128i odd = _mm_castps_si128(_mm_shuffle_ps(lo_ps, hi_ps, _MM_SHUFFLE(3, 1, 3, 1)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_avg_epu8(even, odd));
+            }
+        }
+#endif
+        for (; x < width; x++) {
+            const uint32_t x0 = std::min(2 * x, src_width - 1) * 4;
+            const uint32_t x1 = std::min(2 * x + 1, src_width - 1) * 4;
+            for (uint32_t c = 0; c < 4; c++) {
+                const unsigned int sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                out[x * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+/**************************************************************************************************/
+
+void GenerateMips(Image& image)
+{
+    if (image.levels.size() != 1) {
+        return;  // already has its mip chain
+    }
+    const ImageLevel base = image.levels.front();
+    const size_t chain_size = MipChainSize(base.width, base.height);
+    if (image.pixels.size() != chain_size || base.texels.data() != image.pixels.data()) {
+        std::vector<std::byte> pixels(chain_size);
+        std::copy(base.texels.begin(), base.texels.end(), pixels.begin());
+        image.pixels = std::move(pixels);
+        image.levels.front().texels = { image.pixels.data(), base.texels.size() };
+    }
+
+    size_t offset = base.texels.size();
+    while (image.levels.back().width > 1 || image.levels.back().height > 1) {
+        const ImageLevel& src = image.levels.back();
+        const ImageLevel level{ NextSize(src.width), NextSize(src.height), {} };
+        const size_t size = size_t(level.width) * level.height * 4;
+        DownsampleRgba8(src.texels.data(), src.width, src.height, image.pixels.data() + offset);
+        image.levels.push_back({ level.width, level.height, { image.pixels.data() + offset, size } });
+        offset += size;
+    }
+}
+
+/**************************************************************************************************/
+
+Image ParseTexture(gsl::span<const std::byte> bytes)
+{
+    TextureHeader header;
+    if (bytes.size() < sizeof(header)) {
+        throw std::runtime_error("Texture truncated");
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, texture_format::kMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Texture bad magic");
+    }
+    if (header.version != texture_format::kVersion) {
+        throw std::runtime_error("Texture unsupported version " + std::to_string(header.version));
+    }
+    if (header.codec != texture_format::Codec::RGBA8) {
+        throw std::runtime_error("Texture unsupported codec " + std::to_string(uint32_t(header.codec)));
+    }
+    if (header.num_levels == 0 || header.num_levels > texture_format::kMaxLevels ||
+        bytes.size() < sizeof(header) + header.num_levels * sizeof(LevelEntry)) {
+        throw std::runtime_error("Texture bad levels");
+    }
+
+    if (header.width == 0 || header.height == 0) {
+        throw std::runtime_error("Texture empty");
+    }
+
+    Image image;
+    uint32_t width = header.width;
+    uint32_t height = header.height;
+    for (uint32_t i = 0; i < header.num_levels; i++) {
+        LevelEntry entry;
+        std::memcpy(&entry, bytes.data() + sizeof(header) + i * sizeof(LevelEntry), sizeof(entry));
+        // levels follow the mip chain of the header's size, which ends at 1x1
+        if (i > 0 && width == 1 && height == 1) {
+            throw std::runtime_error("Texture has levels past 1x1");
+        }
+        if (i > 0) {
+            width = NextSize(width);
+            height = NextSize(height);
+        }
+        if (entry.width != width || entry.height != height) {
+            throw std::runtime_error("Texture level " + std::to_string(i) + " is " + std::to_string(entry.width) + "x" +
+                                     std::to_string(entry.height) + " instead of " + std::to_string(width) + "x" +
+                                     std::to_string(height));
+        }
+        if (entry.size != uint64_t(entry.width) * entry.height * 4 || entry.offset > bytes.size() ||
+            entry.size > bytes.size() - entry.offset) {
+            throw std::runtime_error("Texture level " + std::to_string(i) + " out of bounds");
+        }
+        image.levels.push_back({ entry.width, entry.height, bytes.subspan(entry.offset, entry.size) });
+    }
+    return image;
+}
+
+}  // namespace firstgame::render
@@ -0,0 +1,41 @@
+#ifndef FIRSTGAME_RENDER_IMAGE_H_
+#define FIRSTGAME_RENDER_IMAGE_H_
+
+#include <vector>
+#include <cstdint>
+#include <gsl/span>
+
+namespace firstgame::render {
+
+/// Mip level of an image, 8-bit rgba texels row by row without padding
+struct ImageLevel {
+    uint32_t width;
+    uint32_t height;
+    gsl::span<const std::byte> texels;
+};
+
+/// CPU image with its mip chain, level 0 being the full image.
+/// The levels point either into the pixels owned by the image or into the bytes the image was parsed from.
+struct Image {
+    std::vector<ImageLevel> levels;
+    std::vector<std::byte> pixels;  ///< storage of decoded and generated levels
+};
+
+/// Decode an image file (PNG, JPEG, TGA, BMP, ...) with stb_image into a single 8-bit rgba level.
+/// Throws std::runtime_error if the image cannot be decoded.
+Image DecodeImage(gsl::span<const std::byte> bytes);
+
+/// Generate the mip chain of a single level image down to 1x1, with a 2x2 box filter.
+void GenerateMips(Image& image);
+
+/// Validate a pre-processed texture (.fgtex) and view its levels in place, without copying.
+/// Throws std::runtime_error if the texture is malformed.
+Image ParseTexture(gsl::span<const std::byte> bytes);
+
+/// Downsample an 8-bit rgba level to half its size, rounding down but not under 1. Clamps at odd edges.
+/// Vectorized with SSE2 where available, averaging pairs which may round up by one unit.
+void DownsampleRgba8(const std::byte* src, uint32_t src_width, uint32_t src_height, std::byte* dst);
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_IMAGE_H_
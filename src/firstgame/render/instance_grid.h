@@ -0,0 +1,17 @@
+#ifndef FIRSTGAME_RENDER_INSTANCE_GRID_H_
+#define FIRSTGAME_RENDER_INSTANCE_GRID_H_
+
+namespace firstgame::render {
+
+/// InstanceGrid Component lays out the instances of a RenderableInstanced as a waving grid,
+/// whose instance transforms are re-written every frame, for the renderer to cull and stream.
+struct InstanceGrid final {
+    unsigned int rows;
+    unsigned int cols;
+    float amplitude = 0.5f;  ///< height of the wave
+    float time = 0.0f;       ///< elapsed animation time in seconds
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_INSTANCE_GRID_H_
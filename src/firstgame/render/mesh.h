@@ -0,0 +1,47 @@
+#ifndef FIRSTGAME_RENDER_MESH_H_
+#define FIRSTGAME_RENDER_MESH_H_
+
+#include <memory>
+#include <utility>
+#include <glm/vec4.hpp>
+
+#include "firstgame/opengl/vertex_array.h"
+#include "firstgame/opengl/buffer.h"
+
+namespace firstgame::render {
+
+/// Layout of the vertices in a mesh's vertex buffer
+enum class VertexFormat {
+    FLOAT,   ///< painter's vertices: float position and color
+    PACKED,  ///< imported mesh vertices: half float position and normalized byte color, see mesh_format.h
+};
+
+/// Mesh contains GPU-uploaded geometry (vertices and indices), ready to be rendered.
+/// Meshes are shared by all the Renderables drawing the same geometry,
+/// which is what allows the renderer to batch them together.
+struct Mesh final : std::enable_shared_from_this<Mesh> {
+    opengl::VertexArray vao{};  ///< vertex array
+    opengl::Buffer vbo{};       ///< vertex buffer
+    opengl::Buffer ebo{};       ///< element buffer
+    unsigned short num_indices{};
+    glm::vec4 bounds{};  ///< bounding sphere in model space (xyz: center, w: radius)
+    VertexFormat format = VertexFormat::FLOAT;
+
+    /// Create and generate the buffer objects on GPU
+    explicit Mesh(unsigned short num_indices, const glm::vec4& bounds = {}, VertexFormat format = VertexFormat::FLOAT)
+        : num_indices(num_indices), bounds(bounds), format(format)
+    {
+    }
+
+    /// Default Move constructor/assignment
+    Mesh(Mesh&& other) noexcept = default;
+    Mesh& operator=(Mesh&& other) noexcept = default;
+
+    /// Deleted Copy constructor/assignment
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_MESH_H_
@@ -0,0 +1,40 @@
+#ifndef FIRSTGAME_RENDER_MESH_FORMAT_H_
+#define FIRSTGAME_RENDER_MESH_FORMAT_H_
+
+#include <cstdint>
+
+/// Layout of the binary mesh (.fgmesh), written by the mesh import tool and uploaded by UploadMesh().
+/// All fields are little-endian, and the file is meant to be memory-mapped and uploaded in place:
+///
+///     | MeshHeader | PackedVertex[num_vertices] | pad | uint16_t[num_indices] |
+///
+/// Vertices and indices are already optimized for the post-transform vertex cache, overdraw and vertex fetch,
+/// so the runtime does no processing other than validating the header.
+namespace firstgame::render::mesh_format {
+
+inline constexpr char kMagic[4] = { 'F', 'G', 'M', 'S' };
+inline constexpr uint32_t kVersion = 1;
+inline constexpr uint64_t kMeshAlignment = 16;
+
+/// Quantized vertex, matching VertexFormat::PACKED
+struct PackedVertex {
+    uint16_t position[4];  ///< half float xyz, w is padding
+    uint8_t color[4];      ///< normalized rgba
+};
+static_assert(sizeof(PackedVertex) == 12);
+
+/// File header, at offset zero
+struct MeshHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t num_vertices;
+    uint32_t num_indices;
+    float bounds[4];         ///< bounding sphere in model space (xyz: center, w: radius)
+    uint64_t vertex_offset;  ///< byte offset of the PackedVertex array
+    uint64_t index_offset;   ///< byte offset of the uint16_t index array
+};
+static_assert(sizeof(MeshHeader) == 48);
+
+}  // namespace firstgame::render::mesh_format
+
+#endif  // FIRSTGAME_RENDER_MESH_FORMAT_H_
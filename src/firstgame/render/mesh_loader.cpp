@@ -0,0 +1,68 @@
+#include "mesh_loader.h"
+
+#include <limits>
+#include <cstring>
+#include <stdexcept>
+
+#include "painter.h"
+#include "firstgame/opengl/gl.h"
+#include "firstgame/opengl/state_cache.h"
+
+namespace firstgame::render {
+
+using mesh_format::MeshHeader;
+using mesh_format::PackedVertex;
+
+/**************************************************************************************************/
+
+/// Check the array of `count` elements of type T at `offset` lies within the bytes and is aligned for T
+template<typename T>
+static bool InBounds(gsl::span<const std::byte> bytes, uint64_t offset, uint64_t count)
+{
+    return offset <= bytes.size() && count <= (bytes.size() - offset) / sizeof(T) &&
+           reinterpret_cast<uintptr_t>(bytes.data() + offset) % alignof(T) == 0;
+}
+
+MeshData ParseMesh(gsl::span<const std::byte> bytes)
+{
+    MeshHeader header;
+    if (bytes.size() < sizeof(header)) {
+        throw std::runtime_error("Mesh truncated");
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, mesh_format::kMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Mesh bad magic");
+    }
+    if (header.version != mesh_format::kVersion) {
+        throw std::runtime_error("Mesh unsupported version " + std::to_string(header.version));
+    }
+    if (header.num_indices > std::numeric_limits<unsigned short>::max()) {
+        throw std::runtime_error("Mesh has too many indices: " + std::to_string(header.num_indices));
+    }
+    if (not InBounds<PackedVertex>(bytes, header.vertex_offset, header.num_vertices) ||
+        not InBounds<uint16_t>(bytes, header.index_offset, header.num_indices)) {
+        throw std::runtime_error("Mesh arrays out of bounds");
+    }
+    const auto* vertices = reinterpret_cast<const PackedVertex*>(bytes.data() + header.vertex_offset);
+    const auto* indices = reinterpret_cast<const uint16_t*>(bytes.data() + header.index_offset);
+    return MeshData{
+        .vertices = { vertices, header.num_vertices },
+        .indices = { indices, header.num_indices },
+        .bounds = { header.bounds[0], header.bounds[1], header.bounds[2], header.bounds[3] },
+    };
+}
+
+/**************************************************************************************************/
+
+std::shared_ptr<const Mesh> UploadMesh(const opengl::GLShader& shader, const MeshData& data)
+{
+    auto mesh = std::make_shared<Mesh>(static_cast<unsigned short>(data.indices.size()), data.bounds, VertexFormat::PACKED);
+    opengl::StateCache::current().BindVertexArray(mesh->vao);
+    SetupVertexAttribs(shader, mesh->vbo, VertexFormat::PACKED);
+    glBufferData(GL_ARRAY_BUFFER, data.vertices.size_bytes(), data.vertices.data(), GL_STATIC_DRAW);
+    opengl::StateCache::current().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size_bytes(), data.indices.data(), GL_STATIC_DRAW);
+    return mesh;
+}
+
+}  // namespace firstgame::render
@@ -0,0 +1,30 @@
+#ifndef FIRSTGAME_RENDER_MESH_LOADER_H_
+#define FIRSTGAME_RENDER_MESH_LOADER_H_
+
+#include <memory>
+#include <cstdint>
+#include <gsl/span>
+
+#include "mesh.h"
+#include "mesh_format.h"
+#include "firstgame/opengl/shader.h"
+
+namespace firstgame::render {
+
+/// Binary mesh validated in place, pointing into the bytes it was parsed from
+struct MeshData {
+    gsl::span<const mesh_format::PackedVertex> vertices;
+    gsl::span<const uint16_t> indices;
+    glm::vec4 bounds;
+};
+
+/// Validate a binary mesh (.fgmesh) and view its arrays in place, without copying.
+/// Throws std::runtime_error if the mesh is malformed or does not fit a Mesh.
+MeshData ParseMesh(gsl::span<const std::byte> bytes);
+
+/// Upload a parsed mesh to GPU, with the vertex layout of the shader. Must be called on the GL thread.
+std::shared_ptr<const Mesh> UploadMesh(const opengl::GLShader& shader, const MeshData& data);
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_MESH_LOADER_H_
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Motion integrator's scalar and SSE2 kernels, and dispatch.
+/// The AVX2 kernel lives in motion_integrator_avx2.cpp, which is built with AVX2 enabled.
+/// For documentation, see the header file.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "motion_integrator.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "motion.h"
+#include "motion_kernel.h"
+#include "transform.h"
+#include "firstgame/system/log.h"
+
+namespace firstgame::render {
+
+#if defined(FIRSTGAME_SIMD_AVX2)
+/// Defined in motion_integrator_avx2.cpp
+void IntegrateMotionAvx2(const MotionBatch& batch, float deltatime);
+#endif
+
+namespace {
+
+#if defined(__SSE2__)
+/// Lane of 4 floats with SSE2
+struct Sse2Lane {
+    using F = __m128;
+    using I = __m128i;
+    static constexpr size_t kWidth = 4;
+
+    static F load(const float* ptr) { return _mm_loadu_ps(ptr); }
+    static void store(float* ptr, F v) { _mm_storeu_ps(ptr, v); }
+    static F set1(float v) { return _mm_set1_ps(v); }
+    static I set1i(int32_t v) { return _mm_set1_epi32(v); }
+    static F add(F a, F b) { return _mm_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static F abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static I cvtt(F a) { return _mm_cvttps_epi32(a); }
+    static F cvt(I a) { return _mm_cvtepi32_ps(a); }
+    static I addi(I a, I b) { return _mm_add_epi32(a, b); }
+    static I andi(I a, I b) { return _mm_and_si128(a, b); }
+    static I andnoti(I a, I b) { return _mm_andnot_si128(a, b); }
+    static F sign_from_bit2(I a) { return _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(a, _mm_set1_epi32(4)), 29)); }
+    static F sign_of(F a) { return _mm_and_ps(a, _mm_set1_ps(-0.0f)); }
+    static F xor_sign(F a, F sign) { return _mm_xor_ps(a, sign); }
+    static F select_bit1_clear(I j, F a, F b)
+    {
+        const F mask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+};
+#endif
+
+}  // namespace
+
+/**************************************************************************************************/
+
+SimdLevel DetectSimdLevel()
+{
+#if defined(FIRSTGAME_SIMD_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+#endif
+#if defined(__SSE2__)
+    return SimdLevel::SSE2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+/**************************************************************************************************/
+
+void IntegrateMotion(const MotionBatch& batch, float deltatime)
+{
+    static const SimdLevel level = DetectSimdLevel();
+    IntegrateMotion(batch, deltatime, level);
+}
+
+/**************************************************************************************************/
+
+void IntegrateMotion(const MotionBatch& batch, float deltatime, SimdLevel level)
+{
+    switch (level) {
+#if defined(FIRSTGAME_SIMD_AVX2)
+        case SimdLevel::AVX2: IntegrateMotionAvx2(batch, deltatime); return;
+#endif
+#if defined(__SSE2__)
+        case SimdLevel::SSE2: IntegrateBatch<Sse2Lane>(batch, deltatime); return;
+#endif
+        case SimdLevel::Scalar: IntegrateBatch<ScalarLane>(batch, deltatime); return;
+        default: ASSERT_MSG(0, "Unsupported SimdLevel {}", static_cast<int>(level)); return;
+    }
+}
+
+/**************************************************************************************************/
+
+void IntegrateMotionReference(Transform& transform, Motion& motion, float deltatime)
+{
+    motion.velocity += motion.acceleration * deltatime;
+    glm::vec3 degrees = motion.velocity * deltatime;
+    transform.rotation *= glm::angleAxis(glm::radians(degrees.x), glm::vec3(1.0f, 0.0f, 0.0f));
+    transform.rotation *= glm::angleAxis(glm::radians(degrees.y), glm::vec3(0.0f, 1.0f, 0.0f));
+    transform.rotation *= glm::angleAxis(glm::radians(degrees.z), glm::vec3(0.0f, 0.0f, 1.0f));
+}
+
+}  // namespace firstgame::render
@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This file defines the vectorized Motion integration kernels, which operate on structure-of-arrays
+/// batches of Motion and Transform rotation data rather than on the components themselves.
+/// It does not include glm, as the AVX2 kernel's translation unit must not see its inline functions.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FIRSTGAME_RENDER_MOTION_INTEGRATOR_H_
+#define FIRSTGAME_RENDER_MOTION_INTEGRATOR_H_
+
+#include <cstddef>
+
+namespace firstgame::render {
+
+struct Motion;
+struct Transform;
+
+/// Structure-of-arrays view of a batch of entities' Motion and Transform rotation.
+/// All arrays hold `size` elements; rotation quaternions are split in x, y, z, w arrays.
+struct MotionBatch final {
+    float* velocity[3];
+    const float* acceleration[3];
+    float* rotation[4];
+    size_t size;
+};
+
+/// Instruction sets the integration kernel is available for
+enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+/// Best instruction set supported by both the build and the running CPU
+[[nodiscard]] SimdLevel DetectSimdLevel();
+
+/// Integrate one step of `deltatime` seconds for all entities in the batch with the best kernel available.
+/// The velocity integrates the acceleration, and the rotation integrates the resulting euler angles (degrees),
+/// composed into a single quaternion per entity.
+void IntegrateMotion(const MotionBatch& batch, float deltatime);
+
+/// Integrate with the kernel of a specific instruction set, which must be supported.
+void IntegrateMotion(const MotionBatch& batch, float deltatime, SimdLevel level);
+
+/// Reference per-entity integration, with three quaternion rotations in X, Y and Z order.
+/// The kernels match its results within floating point tolerance.
+void IntegrateMotionReference(Transform& transform, Motion& motion, float deltatime);
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_MOTION_INTEGRATOR_H_
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Motion integrator's AVX2 kernel.
+/// This translation unit is built with AVX2 enabled, and only called after checking CPU support.
+/// Keep it free of inline functions shared with other translation units (e.g. glm math or <cmath>), as the
+/// linker could otherwise pick their AVX2 build for callers running on CPUs without it: only code with
+/// internal linkage, like the kernel templates of motion_kernel.h instantiated with Avx2Lane, may live here.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <immintrin.h>
+
+#include "motion_integrator.h"
+#include "motion_kernel.h"
+
+namespace firstgame::render {
+namespace {
+
+/// Lane of 8 floats with AVX2
+struct Avx2Lane {
+    using F = __m256;
+    using I = __m256i;
+    static constexpr size_t kWidth = 8;
+
+    static F load(const float* ptr) { return _mm256_loadu_ps(ptr); }
+    static void store(float* ptr, F v) { _mm256_storeu_ps(ptr, v); }
+    static F set1(float v) { return _mm256_set1_ps(v); }
+    static I set1i(int32_t v) { return _mm256_set1_epi32(v); }
+    static F add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static I cvtt(F a) { return _mm256_cvttps_epi32(a); }
+    static F cvt(I a) { return _mm256_cvtepi32_ps(a); }
+    static I addi(I a, I b) { return _mm256_add_epi32(a, b); }
+    static I andi(I a, I b) { return _mm256_and_si256(a, b); }
+    static I andnoti(I a, I b) { return _mm256_andnot_si256(a, b); }
+    static F sign_from_bit2(I a)
+    {
+        return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(a, _mm256_set1_epi32(4)), 29));
+    }
+    static F sign_of(F a) { return _mm256_and_ps(a, _mm256_set1_ps(-0.0f)); }
+    static F xor_sign(F a, F sign) { return _mm256_xor_ps(a, sign); }
+    static F select_bit1_clear(I j, F a, F b)
+    {
+        const F mask =
+            _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+        return _mm256_blendv_ps(b, a, mask);
+    }
+};
+
+}  // namespace
+
+/**************************************************************************************************/
+
+void IntegrateMotionAvx2(const MotionBatch& batch, float deltatime)
+{
+    IntegrateBatch<Avx2Lane>(batch, deltatime);
+}
+
+}  // namespace firstgame::render
@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Internal header with the Motion integration kernel, written once against a "lane" interface and
+/// instantiated for every instruction set in the translation unit compiled for it.
+/// Everything here has internal linkage, so that instantiations compiled with different instruction
+/// sets never get merged by the linker. For the same reason it calls no inline function with external
+/// linkage, e.g. from <cmath> or glm, whose out-of-line copy could come from the AVX2 translation unit.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FIRSTGAME_RENDER_MOTION_KERNEL_H_
+#define FIRSTGAME_RENDER_MOTION_KERNEL_H_
+
+#include <cstdint>
+#include <cstring>
+
+#include "motion_integrator.h"
+
+namespace firstgame::render {
+namespace {
+
+/// Lane of a single float, the scalar fallback and the tail of the vectorized loops.
+/// A lane provides a float vector F, a matching int32 vector I, and the operations used by the kernel.
+struct ScalarLane {
+    using F = float;
+    using I = int32_t;
+    static constexpr size_t kWidth = 1;
+
+    static F load(const float* ptr) { return *ptr; }
+    static void store(float* ptr, F v) { *ptr = v; }
+    static F set1(float v) { return v; }
+    static I set1i(int32_t v) { return v; }
+    static F add(F a, F b) { return a + b; }
+    static F sub(F a, F b) { return a - b; }
+    static F mul(F a, F b) { return a * b; }
+    static F abs(F a) { return from_bits(to_bits(a) & 0x7fffffff); }
+    static I cvtt(F a) { return static_cast<int32_t>(a); }
+    static F cvt(I a) { return static_cast<float>(a); }
+    static I addi(I a, I b) { return a + b; }
+    static I andi(I a, I b) { return a & b; }
+    static I andnoti(I a, I b) { return ~a & b; }
+    /// Float with only the sign bit set where bit 2 of `a` is set
+    static F sign_from_bit2(I a) { return (a & 4) ? -0.0f : 0.0f; }
+    static F sign_of(F a) { return from_bits(to_bits(a) & 0x80000000); }
+    static F xor_sign(F a, F sign) { return from_bits(to_bits(a) ^ (to_bits(sign) & 0x80000000)); }
+    /// Select `a` where bit 1 of `j` is clear, `b` otherwise
+    static F select_bit1_clear(I j, F a, F b) { return (j & 2) == 0 ? a : b; }
+
+   private:
+    static uint32_t to_bits(F a)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &a, sizeof(bits));
+        return bits;
+    }
+    static F from_bits(uint32_t bits)
+    {
+        F a;
+        std::memcpy(&a, &bits, sizeof(a));
+        return a;
+    }
+};
+
+/// Vectorized single precision sine and cosine, ported from the Cephes library (sinf/cosf).
+/// Accurate to about 1 ulp within [-8192, +8192] radians.
+template<typename L>
+inline void SinCos(typename L::F x, typename L::F& out_sin, typename L::F& out_cos)
+{
+    using F = typename L::F;
+    using I = typename L::I;
+
+    const F sign_sin = L::sign_of(x);
+    x = L::abs(x);
+
+    // octant, rounded to even
+    I j = L::cvtt(L::mul(x, L::set1(1.27323954473516f)));  // 4/pi
+    j = L::addi(j, L::set1i(1));
+    j = L::andi(j, L::set1i(~1));
+    const F y = L::cvt(j);
+
+    // extended precision modular arithmetic
+    x = L::sub(x, L::mul(y, L::set1(0.78515625f)));
+    x = L::sub(x, L::mul(y, L::set1(2.4187564849853515625e-4f)));
+    x = L::sub(x, L::mul(y, L::set1(3.77489497744594108e-8f)));
+    const F z = L::mul(x, x);
+
+    // cosine polynomial for [-pi/4, pi/4]
+    F c = L::set1(2.443315711809948e-5f);
+    c = L::add(L::mul(c, z), L::set1(-1.388731625493765e-3f));
+    c = L::add(L::mul(c, z), L::set1(4.166664568298827e-2f));
+    c = L::mul(L::mul(c, z), z);
+    c = L::sub(c, L::mul(z, L::set1(0.5f)));
+    c = L::add(c, L::set1(1.0f));
+
+    // sine polynomial for [-pi/4, pi/4]
+    F s = L::set1(-1.9515295891e-4f);
+    s = L::add(L::mul(s, z), L::set1(8.3321608736e-3f));
+    s = L::add(L::mul(s, z), L::set1(-1.6666654611e-1f));
+    s = L::add(L::mul(L::mul(s, z), x), x);
+
+    // pick the polynomial and the sign for the octant
+    out_sin = L::select_bit1_clear(j, s, c);
+    out_cos = L::select_bit1_clear(j, c, s);
+    out_sin = L::xor_sign(L::xor_sign(out_sin, L::sign_from_bit2(j)), sign_sin);
+    out_cos = L::xor_sign(out_cos, L::sign_from_bit2(L::andnoti(L::addi(j, L::set1i(-2)), L::set1i(4))));
+}
+
+/// Integrate entities [begin, end) of the batch, `end - begin` must be a multiple of the lane width
+template<typename L>
+inline void IntegrateKernel(const MotionBatch& batch, size_t begin, size_t end, float deltatime)
+{
+    using F = typename L::F;
+
+    const F dt = L::set1(deltatime);
+    // degrees to radians, halved for the quaternion angle
+    const F half_radians = L::set1(deltatime * 3.14159265358979323846f / 360.0f);
+
+    for (size_t i = begin; i < end; i += L::kWidth) {
+        F vx = L::load(batch.velocity[0] + i);
+        F vy = L::load(batch.velocity[1] + i);
+        F vz = L::load(batch.velocity[2] + i);
+        vx = L::add(vx, L::mul(L::load(batch.acceleration[0] + i), dt));
+        vy = L::add(vy, L::mul(L::load(batch.acceleration[1] + i), dt));
+        vz = L::add(vz, L::mul(L::load(batch.acceleration[2] + i), dt));
+        L::store(batch.velocity[0] + i, vx);
+        L::store(batch.velocity[1] + i, vy);
+        L::store(batch.velocity[2] + i, vz);
+
+        F sx, cx, sy, cy, sz, cz;
+        SinCos<L>(L::mul(vx, half_radians), sx, cx);
+        SinCos<L>(L::mul(vy, half_radians), sy, cy);
+        SinCos<L>(L::mul(vz, half_radians), sz, cz);
+
+        // euler rotation qx * qy * qz composed in closed form
+        const F cxcy = L::mul(cx, cy);
+        const F sxsy = L::mul(sx, sy);
+        const F sxcy = L::mul(sx, cy);
+        const F cxsy = L::mul(cx, sy);
+        const F ew = L::sub(L::mul(cxcy, cz), L::mul(sxsy, sz));
+        const F ex = L::add(L::mul(sxcy, cz), L::mul(cxsy, sz));
+        const F ey = L::sub(L::mul(cxsy, cz), L::mul(sxcy, sz));
+        const F ez = L::add(L::mul(cxcy, sz), L::mul(sxsy, cz));
+
+        // rotation = rotation * euler
+        const F rx = L::load(batch.rotation[0] + i);
+        const F ry = L::load(batch.rotation[1] + i);
+        const F rz = L::load(batch.rotation[2] + i);
+        const F rw = L::load(batch.rotation[3] + i);
+        L::store(batch.rotation[0] + i, L::sub(L::add(L::add(L::mul(rw, ex), L::mul(rx, ew)), L::mul(ry, ez)), L::mul(rz, ey)));
+        L::store(batch.rotation[1] + i, L::sub(L::add(L::add(L::mul(rw, ey), L::mul(ry, ew)), L::mul(rz, ex)), L::mul(rx, ez)));
+        L::store(batch.rotation[2] + i, L::sub(L::add(L::add(L::mul(rw, ez), L::mul(rz, ew)), L::mul(rx, ey)), L::mul(ry, ex)));
+        L::store(batch.rotation[3] + i, L::sub(L::sub(L::sub(L::mul(rw, ew), L::mul(rx, ex)), L::mul(ry, ey)), L::mul(rz, ez)));
+    }
+}
+
+/// Integrate the whole batch with lane L, finishing the remainder with the scalar lane
+template<typename L>
+inline void IntegrateBatch(const MotionBatch& batch, float deltatime)
+{
+    const size_t vector_end = batch.size - (batch.size % L::kWidth);
+    IntegrateKernel<L>(batch, 0, vector_end, deltatime);
+    IntegrateKernel<ScalarLane>(batch, vector_end, batch.size, deltatime);
+}
+
+}  // namespace
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_MOTION_KERNEL_H_
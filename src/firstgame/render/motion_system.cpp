@@ -0,0 +1,90 @@
+#include "motion_system.h"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/epsilon.hpp>
+#include <entt/entity/registry.hpp>
+
+#include "motion.h"
+#include "motion_integrator.h"
+#include "transform.h"
+#include "world_matrix.h"
+#include "firstgame/system/log.h"
+
+namespace firstgame::render {
+
+/**************************************************************************************************/
+
+MotionSystem::MotionSystem(entt::registry& registry)
+{
+    // create the owning group up front so that components are packed as they are emplaced
+    (void) registry.group<Transform, Motion, WorldMatrix>();
+}
+
+/**************************************************************************************************/
+
+void MotionSystem::Update(entt::registry& registry, system::JobSystem& jobs, float deltatime)
+{
+    PROFILE_ZONE("MotionSystem");
+    auto group = registry.group<Transform, Motion, WorldMatrix>();
+    Transform* transforms = group.raw<Transform>();
+    Motion* motions = group.raw<Motion>();
+    WorldMatrix* worlds = group.raw<WorldMatrix>();
+
+#ifndef NDEBUG
+    // validate the kernel against the reference integration on the first entity
+    std::optional<std::pair<Transform, Motion>> reference;
+    if (group.size()) {
+        reference.emplace(transforms[0], motions[0]);
+        IntegrateMotionReference(reference->first, reference->second, deltatime);
+    }
+#endif
+
+    jobs.ParallelFor(group.size(), kChunkSize, [=](size_t begin, size_t end) {
+        // transpose the components into structure-of-arrays batches on the stack, integrate, and transpose back
+        alignas(32) float velocity[3][kBatchSize];
+        alignas(32) float acceleration[3][kBatchSize];
+        alignas(32) float rotation[4][kBatchSize];
+        for (size_t first = begin; first < end; first += kBatchSize) {
+            const size_t size = std::min(kBatchSize, end - first);
+            for (size_t i = 0; i < size; i++) {
+                const Motion& motion = motions[first + i];
+                const glm::quat& quat = transforms[first + i].rotation;
+                for (int axis : { 0, 1, 2 }) {
+                    velocity[axis][i] = motion.velocity[axis];
+                    acceleration[axis][i] = motion.acceleration[axis];
+                }
+                rotation[0][i] = quat.x;
+                rotation[1][i] = quat.y;
+                rotation[2][i] = quat.z;
+                rotation[3][i] = quat.w;
+            }
+            const MotionBatch batch{
+                .velocity = { velocity[0], velocity[1], velocity[2] },
+                .acceleration = { acceleration[0], acceleration[1], acceleration[2] },
+                .rotation = { rotation[0], rotation[1], rotation[2], rotation[3] },
+                .size = size,
+            };
+            IntegrateMotion(batch, deltatime);
+            for (size_t i = 0; i < size; i++) {
+                motions[first + i].velocity = glm::vec3(velocity[0][i], velocity[1][i], velocity[2][i]);
+                transforms[first + i].rotation = glm::quat(rotation[3][i], rotation[0][i], rotation[1][i], rotation[2][i]);
+                worlds[first + i].model = ComposeWorldMatrix(transforms[first + i]);
+            }
+        }
+    });
+
+#ifndef NDEBUG
+    if (reference) {
+        constexpr float kTolerance = 1e-4f;
+        ASSERT(glm::all(glm::epsilonEqual(reference->first.rotation, transforms[0].rotation, kTolerance)));
+        ASSERT(glm::all(glm::epsilonEqual(reference->second.velocity, motions[0].velocity, kTolerance)));
+    }
+#endif
+
+    num_integrated_ = group.size();
+}
+
+}  // namespace firstgame::render
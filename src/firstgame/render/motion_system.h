@@ -0,0 +1,36 @@
+#ifndef FIRSTGAME_RENDER_MOTION_SYSTEM_H_
+#define FIRSTGAME_RENDER_MOTION_SYSTEM_H_
+
+#include <entt/entity/fwd.hpp>
+#include "firstgame/system/job_system.h"
+
+namespace firstgame::render {
+
+/// MotionSystem integrates the Motion of entities into their Transform, and refreshes their WorldMatrix.
+/// Entities are kept packed in an owning group of Transform, Motion and WorldMatrix, so that the integration
+/// runs over contiguous arrays, split in chunks across the threads of the JobSystem.
+/// Each chunk is transposed into structure-of-arrays batches for the vectorized integration kernel.
+/// Entities only join the group once the TransformSystem gave them a WorldMatrix.
+class MotionSystem final {
+   public:
+    explicit MotionSystem(entt::registry& registry);
+
+    /// Integrate one step of `deltatime` seconds
+    void Update(entt::registry& registry, system::JobSystem& jobs, float deltatime);
+
+    /// Number of entities integrated in the last update
+    [[nodiscard]] size_t NumIntegrated() const { return num_integrated_; }
+
+   private:
+    /// Number of entities per job chunk
+    static constexpr size_t kChunkSize = 2048;
+    /// Number of entities per structure-of-arrays batch
+    static constexpr size_t kBatchSize = 256;
+
+   private:
+    size_t num_integrated_ = 0;
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_MOTION_SYSTEM_H_
@@ -1,13 +1,21 @@
 #include "painter.h"
 
+#include <map>
+#include <memory>
+#include <limits>
+#include <algorithm>
 #include <gsl/span>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 #include <glm/mat4x4.hpp>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "firstgame/opengl/gl.h"
+#include "firstgame/opengl/state_cache.h"
 #include "firstgame/system/log.h"
+#include "mesh_format.h"
 
 namespace firstgame::render {
 
@@ -20,6 +28,9 @@ struct Instance {
     glm::mat4 model;
 };
 
+std::shared_ptr<const Mesh> GenerateMesh(const opengl::GLShader& shader, gsl::span<const Vertex> vertices,
+                                         gsl::span<const unsigned short> indices);
+
 Renderable GenerateRenderable(const opengl::GLShader& shader, gsl::span<const Vertex> vertices,
                               gsl::span<const unsigned short> indices);
 
@@ -28,6 +39,25 @@ RenderableInstanced GenerateRenderableInstanced(const opengl::GLShader& shader,
 
 /**************************************************************************************************/
 
+/// Bounding sphere of the vertices, centered on their bounding box
+static glm::vec4 BoundingSphere(gsl::span<const Vertex> vertices)
+{
+    glm::vec3 min{ std::numeric_limits<float>::max() };
+    glm::vec3 max{ std::numeric_limits<float>::lowest() };
+    for (const Vertex& vertex : vertices) {
+        min = glm::min(min, vertex.position);
+        max = glm::max(max, vertex.position);
+    }
+    const glm::vec3 center = (min + max) * 0.5f;
+    float radius = 0.0f;
+    for (const Vertex& vertex : vertices) {
+        radius = std::max(radius, glm::distance(center, vertex.position));
+    }
+    return glm::vec4(center, radius);
+}
+
+/**************************************************************************************************/
+
 // Move this to a Painter/Designer of common polygons
 // The painter should be by Draw mode (triangles, triangles strip, etc) because of the indices.
 
@@ -130,24 +160,36 @@ RenderableInstanced GenerateCubeInstanced(const opengl::GLShader& shader, unsign
 
 /**************************************************************************************************/
 
-Renderable GenerateRenderable(const opengl::GLShader& shader, gsl::span<const Vertex> vertices,
-                              gsl::span<const unsigned short> indices)
+std::shared_ptr<const Mesh> GenerateMesh(const opengl::GLShader& shader, gsl::span<const Vertex> vertices,
+                                         gsl::span<const unsigned short> indices)
 {
     ASSERT(indices.size() <= std::numeric_limits<unsigned short>::max());
 
-    Renderable renderable{ static_cast<unsigned short>(indices.size()) };
-    glBindVertexArray(renderable.vao);
-    glBindBuffer(GL_ARRAY_BUFFER, renderable.vbo);
+    auto mesh = std::make_shared<Mesh>(static_cast<unsigned short>(indices.size()), BoundingSphere(vertices));
+    opengl::StateCache::current().BindVertexArray(mesh->vao);
+    SetupVertexAttribs(shader, mesh->vbo);
     glBufferData(GL_ARRAY_BUFFER, vertices.size_bytes(), vertices.data(), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(shader.attr_loc(opengl::GLAttr::POSITION));
-    glVertexAttribPointer(shader.attr_loc(opengl::GLAttr::POSITION), 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                          (void*) offsetof(Vertex, position));
-    glEnableVertexAttribArray(shader.attr_loc(opengl::GLAttr::COLOR));
-    glVertexAttribPointer(shader.attr_loc(opengl::GLAttr::COLOR), 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                          (void*) offsetof(Vertex, color));
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderable.ebo);
+    opengl::StateCache::current().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ebo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size_bytes(), indices.data(), GL_STATIC_DRAW);
-    return renderable;
+    return mesh;
+}
+
+/**************************************************************************************************/
+
+Renderable GenerateRenderable(const opengl::GLShader& shader, gsl::span<const Vertex> vertices,
+                              gsl::span<const unsigned short> indices)
+{
+    // Meshes generated from the same static geometry are shared for as long as any Renderable uses them,
+    // keyed by shader too because the vertex array is bound to the shader's attribute locations.
+    static std::map<std::pair<const opengl::GLShader*, const Vertex*>, std::weak_ptr<const Mesh>> cache;
+
+    auto& cached = cache[{ &shader, vertices.data() }];
+    if (auto mesh = cached.lock()) {
+        return { std::move(mesh) };
+    }
+    auto mesh = GenerateMesh(shader, vertices, indices);
+    cached = mesh;
+    return { std::move(mesh) };
 }
 
 /**************************************************************************************************/
@@ -159,33 +201,61 @@ RenderableInstanced GenerateRenderableInstanced(const opengl::GLShader& shader,
     ASSERT(instances.size() <= std::numeric_limits<unsigned int>::max());
 
     RenderableInstanced renderable{ static_cast<unsigned short>(indices.size()), static_cast<unsigned int>(instances.size()) };
+    renderable.bounds = BoundingSphere(vertices);
+    renderable.models.reserve(instances.size());
+    for (const Instance& instance : instances) {
+        renderable.models.push_back(instance.model);
+    }
 
-    glBindVertexArray(renderable.vao);
+    opengl::StateCache::current().BindVertexArray(renderable.vao);
 
-    glBindBuffer(GL_ARRAY_BUFFER, renderable.vbo);
+    SetupVertexAttribs(shader, renderable.vbo);
     glBufferData(GL_ARRAY_BUFFER, vertices.size_bytes(), vertices.data(), GL_STATIC_DRAW);
 
+    SetupInstanceAttribs(shader, renderable.ibo, 0);
+    glBufferData(GL_ARRAY_BUFFER, instances.size_bytes(), instances.data(), GL_STATIC_DRAW);
+
+    opengl::StateCache::current().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderable.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size_bytes(), indices.data(), GL_STATIC_DRAW);
+
+    return renderable;
+}
+
+/**************************************************************************************************/
+
+void SetupVertexAttribs(const opengl::GLShader& shader, GLuint vbo, VertexFormat format)
+{
+    opengl::StateCache::current().BindBuffer(GL_ARRAY_BUFFER, vbo);
+    if (format == VertexFormat::PACKED) {
+        using mesh_format::PackedVertex;
+        glEnableVertexAttribArray(shader.attr_loc(opengl::GLAttr::POSITION));
+        glVertexAttribPointer(shader.attr_loc(opengl::GLAttr::POSITION), 3, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex),
+                              (void*) offsetof(PackedVertex, position));
+        glEnableVertexAttribArray(shader.attr_loc(opengl::GLAttr::COLOR));
+        glVertexAttribPointer(shader.attr_loc(opengl::GLAttr::COLOR), 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PackedVertex),
+                              (void*) offsetof(PackedVertex, color));
+        return;
+    }
     glEnableVertexAttribArray(shader.attr_loc(opengl::GLAttr::POSITION));
     glVertexAttribPointer(shader.attr_loc(opengl::GLAttr::POSITION), 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
                           (void*) offsetof(Vertex, position));
     glEnableVertexAttribArray(shader.attr_loc(opengl::GLAttr::COLOR));
     glVertexAttribPointer(shader.attr_loc(opengl::GLAttr::COLOR), 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
                           (void*) offsetof(Vertex, color));
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, renderable.ibo);
-    glBufferData(GL_ARRAY_BUFFER, instances.size_bytes(), instances.data(), GL_STATIC_DRAW);
+/**************************************************************************************************/
 
+void SetupInstanceAttribs(const opengl::GLShader& shader, GLuint ibo, GLintptr offset)
+{
+    opengl::StateCache::current().BindBuffer(GL_ARRAY_BUFFER, ibo);
     for (unsigned index : { 0, 1, 2, 3 }) {
         const unsigned location = shader.attr_loc(opengl::GLAttr::MODEL) + index;
         glEnableVertexAttribArray(location);
-        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*) (index * sizeof(glm::mat4::col_type)));
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                              (void*) (offset + index * sizeof(glm::mat4::col_type)));
         glVertexAttribDivisor(location, 1);
     }
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderable.ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size_bytes(), indices.data(), GL_STATIC_DRAW);
-
-    return renderable;
 }
 
 }  // namespace firstgame::render
@@ -3,6 +3,7 @@
 
 #include "renderable.h"
 #include "renderable_instanced.h"
+#include "firstgame/opengl/gl/types.h"
 #include "firstgame/opengl/shader.h"
 
 namespace firstgame::render {
@@ -13,6 +14,13 @@ Renderable GenerateCube(const opengl::GLShader& shader);
 
 RenderableInstanced GenerateCubeInstanced(const opengl::GLShader& shader, unsigned int rows, unsigned int cols);
 
+/// Specify the vertex layout, sourced from `vbo`, into the currently bound vertex array.
+void SetupVertexAttribs(const opengl::GLShader& shader, GLuint vbo, VertexFormat format = VertexFormat::FLOAT);
+
+/// Specify the per-instance model matrix attributes, sourced from `ibo` starting at byte `offset`,
+/// into the currently bound vertex array.
+void SetupInstanceAttribs(const opengl::GLShader& shader, GLuint ibo, GLintptr offset);
+
 }  // namespace firstgame::render
 
 #endif  // FIRSTGAME_RENDER_PAINTER_H_
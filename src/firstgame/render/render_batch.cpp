@@ -0,0 +1,66 @@
+#include "render_batch.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "firstgame/opengl/gl.h"
+#include "firstgame/opengl/state_cache.h"
+#include "painter.h"
+
+namespace firstgame::render {
+
+/**************************************************************************************************/
+
+unsigned int RenderBatch::Record(RenderPass pass, MyShader shader, FrameData& frame)
+{
+    // group objects of the same mesh together
+    std::sort(items_.begin(), items_.end(),
+              [](const Item& lhs, const Item& rhs) { return std::less<const Mesh*>{}(lhs.mesh, rhs.mesh); });
+
+    unsigned int num_groups = 0;
+    for (size_t first = 0; first < items_.size();) {
+        const Mesh* mesh = items_[first].mesh;
+        const auto first_model = static_cast<uint32_t>(frame.models.size());
+        size_t last = first;
+        while (last < items_.size() && items_[last].mesh == mesh) {
+            frame.models.push_back(items_[last].model);
+            last++;
+        }
+        frame.meshes.push_back(mesh->shared_from_this());
+        frame.queue.Push(CommandQueue::MakeKey(pass, shader, 0, mesh->vao, 0.0f),
+                         DrawCommand{
+                             .shader = shader,
+                             .vao = 0,
+                             .mesh = mesh,
+                             .num_indices = mesh->num_indices,
+                             .num_instances = static_cast<unsigned int>(last - first),
+                             .first_model = first_model,
+                             .instance_buffer = 0,
+                         });
+        num_groups++;
+        first = last;
+    }
+    return num_groups;
+}
+
+/**************************************************************************************************/
+
+GLuint RenderBatch::GroupArray(const opengl::GLShader& shader, const Mesh& mesh)
+{
+    Group& group = groups_[&mesh];
+    if (group.mesh.lock().get() != &mesh) {
+        // first time seeing this mesh, or a new mesh took the address of a destroyed one
+        group.mesh = mesh.shared_from_this();
+        group.vao = opengl::VertexArray{};
+        opengl::StateCache::current().BindVertexArray(group.vao);
+        SetupVertexAttribs(shader, mesh.vbo, mesh.format);
+        opengl::StateCache::current().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+        // forget vertex arrays of meshes that no longer exist, once in a while as new meshes come in
+        for (auto it = groups_.begin(); it != groups_.end();) {
+            it = it->second.mesh.expired() ? groups_.erase(it) : std::next(it);
+        }
+    }
+    return group.vao;
+}
+
+}  // namespace firstgame::render
@@ -0,0 +1,69 @@
+#ifndef FIRSTGAME_RENDER_RENDER_BATCH_H_
+#define FIRSTGAME_RENDER_RENDER_BATCH_H_
+
+#include <vector>
+#include <unordered_map>
+#include <glm/mat4x4.hpp>
+
+#include "mesh.h"
+#include "frame_data.h"
+#include "render_pass.h"
+#include "shader_lib.h"
+#include "firstgame/opengl/vertex_array.h"
+#include "firstgame/opengl/shader.h"
+
+namespace firstgame::render {
+
+/// RenderBatch groups non-instanced objects by mesh and records each group as a single instanced draw command.
+/// The model matrices of all objects are packed into the frame's models, streamed as instance data on submission,
+/// so submitting N objects of M distinct meshes costs M draw calls instead of N.
+/// Recording only touches CPU memory; the vertex arrays of the groups are made on the GL thread by GroupArray().
+/// Example:
+/// ```
+///  batch.Clear();
+///  view.each([&](auto& transform, auto& renderable) { batch.Add(*renderable.mesh, model); });
+///  unsigned int num_groups = batch.Record(RenderPass::_3D, MyShader::SIMPLE_INSTANCE, frame);
+/// ```
+class RenderBatch final {
+   public:
+    RenderBatch() = default;
+    RenderBatch(const RenderBatch&) = delete;
+    RenderBatch& operator=(const RenderBatch&) = delete;
+
+    /// Discard the objects from the previous frame, keeping the allocated memory
+    void Clear() { items_.clear(); }
+
+    /// Add an object to be drawn with the given mesh and model matrix
+    void Add(const Mesh& mesh, const glm::mat4& model) { items_.push_back({ &mesh, model }); }
+
+    /// Number of objects added since last Clear()
+    [[nodiscard]] size_t size() const { return items_.size(); }
+
+    /// Append the model matrices to the frame and record a draw command for every mesh group with the
+    /// instancing shader. Returns the number of commands recorded.
+    unsigned int Record(RenderPass pass, MyShader shader, FrameData& frame);
+
+    /// Get the vertex array combining the mesh's vertices with the instance attributes, made on first use
+    GLuint GroupArray(const opengl::GLShader& shader, const Mesh& mesh);
+
+   private:
+    /// Object added to the batch
+    struct Item {
+        const Mesh* mesh;
+        glm::mat4 model;
+    };
+    /// Vertex array of a mesh group, invalidated when the mesh is destroyed
+    struct Group {
+        std::weak_ptr<const Mesh> mesh;
+        opengl::VertexArray vao{ opengl::VertexArray::Null{} };
+    };
+
+    // recording
+    std::vector<Item> items_;
+    // submission
+    std::unordered_map<const Mesh*, Group> groups_;
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_RENDER_BATCH_H_
@@ -0,0 +1,29 @@
+#ifndef FIRSTGAME_RENDER_RENDER_STATS_H_
+#define FIRSTGAME_RENDER_RENDER_STATS_H_
+
+#include <cstdint>
+
+namespace firstgame::render {
+
+/// Number of objects visible and culled by a render pass
+struct CullStats final {
+    unsigned int visible{};
+    unsigned int culled{};
+};
+
+/// Statistics about the last rendered frame, reset at the beginning of every frame.
+struct RenderStats final {
+    unsigned int draw_calls{};      ///< number of draw calls issued
+    unsigned int objects{};         ///< number of non-instanced objects submitted
+    unsigned int batches{};         ///< number of mesh groups drawn by the batched pass
+    unsigned int shader_binds{};    ///< number of shader programs bound
+    unsigned int vao_binds{};       ///< number of vertex arrays bound
+    uint64_t state_calls_issued{};  ///< number of GL state calls forwarded by the state cache
+    uint64_t state_calls_elided{};  ///< number of redundant GL state calls dropped by the state cache
+    CullStats simple;               ///< non-instanced objects
+    CullStats instanced;            ///< instances of instanced objects
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_RENDER_STATS_H_
@@ -3,6 +3,9 @@
 
 #include <tuple>
 #include <utility>
+#include <vector>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
 
 #include "firstgame/opengl/vertex_array.h"
 #include "firstgame/opengl/buffer.h"
@@ -17,6 +20,11 @@ struct RenderableInstanced final {
     opengl::Buffer ebo{};       ///< element buffer
     unsigned short num_indices{};
     unsigned int num_instances{};
+    glm::vec4 bounds{};  ///< bounding sphere of one instance in model space (xyz: center, w: radius)
+
+    /// CPU copy of the instance transforms. When not empty, the renderer culls the instances against
+    /// the camera frustum and streams only the visible ones, ignoring the static buffer.
+    std::vector<glm::mat4> models{};
 
     /// Create and generate the buffer objects on GPU
     explicit RenderableInstanced(unsigned short num_indices, unsigned int num_instances)
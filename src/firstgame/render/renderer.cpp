@@ -1,26 +1,40 @@
 #include "renderer.h"
 
 #include <new>
+#include <vector>
+#include <cstring>
 #include <optional>
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include <glm/gtx/quaternion.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <entt/entity/handle.hpp>
 #include <entt/entity/registry.hpp>
 
 #include "firstgame/opengl/gl.h"
+#include "firstgame/opengl/gpu_timer.h"
 #include "firstgame/opengl/shader.h"
+#include "firstgame/opengl/state_cache.h"
+#include "firstgame/opengl/stream_buffer.h"
 #include "firstgame/system/log.h"
 #include "firstgame/system/asset_mgr.h"
+#include "firstgame/system/job_system.h"
+#include "firstgame/system/profiler.h"
 #include "firstgame/util/scoped.h"
 #include "firstgame/util/filesystem_literals.h"
 
 #include "camera_perspective.h"
 #include "renderable.h"
 #include "renderable_instanced.h"
-#include "transform.h"
+#include "render_batch.h"
+#include "render_stats.h"
+#include "world_matrix.h"
 #include "camera_system.h"
+#include "command_queue.h"
+#include "frame_data.h"
+#include "aabb_tree.h"
+#include "culling.h"
+#include "frustum.h"
+#include "painter.h"
 #include "shader_lib.h"
 
 namespace firstgame::render {
@@ -39,24 +53,74 @@ class RendererImpl final {
     explicit RendererImpl(Size size);
     ~RendererImpl();
     void Render(const entt::registry& registry);
+    void Record(const entt::registry& registry);
+    void Swap();
+    void Submit();
     void OnResize(Size size);
     void OnZoom(float offset);
     void OnCursorMove(float xpos, float ypos);
     void OnKeystroke(event::KeyEvent key_event, float deltatime);
+    [[nodiscard]] glm::vec3 CameraPosition() const { return camera_.Position(); }
+    void SetBatching(bool enabled) { batching_ = enabled; }
+    [[nodiscard]] bool Batching() const { return batching_; }
+    void SetCulling(bool enabled) { culling_ = enabled; }
+    [[nodiscard]] bool Culling() const { return culling_; }
+    void SetSorting(bool enabled) { sorting_ = enabled; }
+    [[nodiscard]] bool Sorting() const { return sorting_; }
+    [[nodiscard]] const RenderStats& Stats() const { return stats_; }
+    void InvalidateState() { state_.Invalidate(); }
 
    private:
+    /// Cull the non-instanced objects against the frustum, collecting the visible ones
+    void CullObjects(const entt::registry& registry, const Frustum& frustum, FrameData& frame);
+
+    /// Cull the instances of instanced objects against the frustum, recording the visible ones
+    void CullInstances(const entt::registry& registry, const Frustum& frustum, FrameData& frame);
+
+    /// Set the camera uniforms of the bound shader
+    void SetCamera(const GLShader& shader, const ViewProjection& camera);
+
+   private:
+    /// Size of each frame region of the instance stream, enough for 128k model matrices
+    static constexpr GLsizeiptr kStreamRegionSize = 8 * 1024 * 1024;
+    /// Number of instances culled by a job
+    static constexpr size_t kCullChunkSize = 4096;
+
+   private:
+    opengl::StateCache state_;
     CameraSystem camera_;
     ShaderLibrary shader_lib_;
+    opengl::StreamBuffer stream_{ kStreamRegionSize };
+    opengl::GpuTimer gpu_timer_;
+    RenderBatch batch_;
+    RenderStats stats_;
+    bool batching_ = true;
+    bool culling_ = true;
+    bool sorting_ = true;
+    // frames being recorded and submitted, swapped in between
+    FrameData frames_[2];
+    unsigned int record_frame_ = 0;
+    // per-frame culling state, kept to reuse the allocations
+    struct Object {
+        const Renderable* renderable;
+        const glm::mat4* model;
+    };
+    std::vector<Object> objects_;
+    std::vector<glm::vec4> spheres_;
+    std::vector<uint32_t> visible_;
+    std::vector<uint32_t> chunk_visible_;
 };
 
+
 /**************************************************************************************************/
 
 RendererImpl::RendererImpl(Size size) : camera_(size)
 {
     OnResize(size);
 
-    shader_lib_.load<MyShader::SIMPLE>();
-    shader_lib_.load<MyShader::SIMPLE_INSTANCE>();
+    // built in the background, draws wait for their shader
+    shader_lib_.load_async(MyShader::SIMPLE);
+    shader_lib_.load_async(MyShader::SIMPLE_INSTANCE);
 
     TRACE("Created RendererImpl");
 }
@@ -72,44 +136,281 @@ RendererImpl::~RendererImpl()
 
 void RendererImpl::Render(const entt::registry& registry)
 {
+    Record(registry);
+    Swap();
+    Submit();
+}
+
+/**************************************************************************************************/
+
+void RendererImpl::Record(const entt::registry& registry)
+{
+    PROFILE_ZONE("Record");
+    FrameData& frame = frames_[record_frame_];
+    frame.Clear();
+    frame.camera = camera_.Matrix(RenderPass::_3D);
+
+    const ViewProjection& matrix = frame.camera;
+    const Frustum frustum = Frustum::FromMatrix(matrix.projection * matrix.view);
+    CullObjects(registry, frustum, frame);
+    CullInstances(registry, frustum, frame);
+
+    if (batching_) {
+        // objects grouped by mesh
+        batch_.Clear();
+        for (const Object& object : objects_) {
+            batch_.Add(*object.renderable->mesh, *object.model);
+        }
+        frame.stats.batches += batch_.Record(RenderPass::_3D, MyShader::SIMPLE_INSTANCE, frame);
+        frame.stats.objects += static_cast<unsigned int>(batch_.size());
+    }
+    else {
+        // objects sorted front to back, by distance along the view direction up to the far plane
+        const float far = matrix.projection[3][2] / (matrix.projection[2][2] + 1.0f);
+        for (const Object& object : objects_) {
+            const Mesh& mesh = *object.renderable->mesh;
+            const float depth = -(matrix.view * (*object.model)[3]).z / far;
+            frame.queue.Push(CommandQueue::MakeKey(RenderPass::_3D, MyShader::SIMPLE, 0, mesh.vao, depth),
+                             DrawCommand{
+                                 .shader = MyShader::SIMPLE,
+                                 .vao = mesh.vao,
+                                 .mesh = nullptr,
+                                 .num_indices = mesh.num_indices,
+                                 .num_instances = 0,
+                                 .first_model = static_cast<uint32_t>(frame.models.size()),
+                                 .instance_buffer = 0,
+                             });
+            frame.models.push_back(*object.model);
+            frame.meshes.push_back(object.renderable->mesh);
+            frame.stats.objects++;
+        }
+    }
+    if (sorting_) {
+        frame.queue.Sort();
+    }
+    frame.recorded = true;
+}
+
+/**************************************************************************************************/
+
+void RendererImpl::Swap()
+{
+    record_frame_ ^= 1;
+    // a frame dropped without being submitted releases its meshes here, on the GL thread
+    frames_[record_frame_].meshes.clear();
+    frames_[record_frame_].recorded = false;
+}
+
+/**************************************************************************************************/
+
+void RendererImpl::Submit()
+{
+    PROFILE_ZONE("Submit");
+    gpu_timer_.BeginFrame(system::Profiler::current().FrameNumber());
+    FrameData& frame = frames_[record_frame_ ^ 1];
+    state_.ResetCounters();
+
     // settings
-    glEnable(GL_DEPTH_TEST);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    state_.Enable(GL_DEPTH_TEST);
+    state_.PolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     // clear buffers
-    glClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+    state_.ClearColor(0.1f, 0.2f, 0.3f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    {
-        auto& shader = shader_lib_.get(MyShader::SIMPLE);
-        shader.bind();
-        // unifs
-        camera_.Render(RenderPass::_3D, shader);
-        // objects
-        auto view = registry.view<const Transform, const Renderable>();
-        view.each([&](const Transform& transform, const Renderable& renderable) {
-            glm::mat4 translation = glm::translate(glm::mat4(1.0f), transform.position);
-            glm::mat4 rotation = glm::toMat4(transform.rotation);
-            glm::mat4 scale = glm::scale(glm::mat4(1.0f), transform.scale);
-            glm::mat4 model = translation * rotation * scale;
-            glUniformMatrix4fv(shader.unif_loc(GLUnif::MODEL), 1, GL_FALSE, glm::value_ptr(model));
-            glBindVertexArray(renderable.vao);
-            glDrawElements(GL_TRIANGLES, renderable.num_indices, GL_UNSIGNED_SHORT, nullptr);
-        });
+    if (not frame.recorded) {
+        stats_ = {};
+        return;
     }
-    {
-        auto& shader = shader_lib_.get(MyShader::SIMPLE_INSTANCE);
-        shader.bind();
-        // unifs
-        camera_.Render(RenderPass::_3D, shader);
-        // objects
-        auto view = registry.view<const RenderableInstanced>();
-        view.each([](const RenderableInstanced& renderable) {
-            glBindVertexArray(renderable.vao);
-            glDrawElementsInstanced(GL_TRIANGLES, renderable.num_indices, GL_UNSIGNED_SHORT, nullptr, renderable.num_instances);
-        });
+
+    // upload the model matrices of the frame, sourced by the instanced draws
+    std::optional<GLintptr> models_offset;
+    if (not frame.models.empty()) {
+        const auto size = static_cast<GLsizeiptr>(frame.models.size() * sizeof(glm::mat4));
+        if (auto slice = stream_.Allocate(size)) {
+            std::memcpy(slice->data, frame.models.data(), static_cast<size_t>(size));
+            models_offset = slice->offset;
+        }
     }
+    stream_.Flush();
+
+    // replay the commands, binding shaders and vertex arrays only when they change
+    gpu_timer_.Begin("3D");
+    GLShader* shader = nullptr;
+    MyShader bound_shader = MyShader::COUNT;
+    GLuint bound_vao = 0;
+    for (const DrawCommand& command : frame.queue) {
+        if (command.num_instances && not command.instance_buffer && not models_offset) {
+            continue;  // instances lost with a full stream
+        }
+        if (command.shader != bound_shader) {
+            shader = shader_lib_.find(command.shader);
+            bound_shader = command.shader;
+            if (shader) {
+                shader->bind();
+                SetCamera(*shader, frame.camera);
+                frame.stats.shader_binds++;
+            }
+        }
+        if (not shader) {
+            continue;  // still loading
+        }
+        const GLuint vao = command.mesh ? batch_.GroupArray(*shader, *command.mesh) : command.vao;
+        if (vao != bound_vao) {
+            state_.BindVertexArray(vao);
+            bound_vao = vao;
+            frame.stats.vao_binds++;
+        }
+        if (command.num_instances) {
+            if (command.instance_buffer) {
+                SetupInstanceAttribs(*shader, command.instance_buffer, 0);
+            }
+            else {
+                SetupInstanceAttribs(*shader, GLuint(stream_),
+                                     *models_offset + static_cast<GLintptr>(command.first_model * sizeof(glm::mat4)));
+            }
+            glDrawElementsInstanced(GL_TRIANGLES, command.num_indices, GL_UNSIGNED_SHORT, nullptr,
+                                    static_cast<GLsizei>(command.num_instances));
+        }
+        else {
+            state_.UniformMatrix4fv(shader->unif_loc(GLUnif::MODEL), glm::value_ptr(frame.models[command.first_model]));
+            glDrawElements(GL_TRIANGLES, command.num_indices, GL_UNSIGNED_SHORT, nullptr);
+        }
+        frame.stats.draw_calls++;
+    }
+    gpu_timer_.End();
+
     // undo
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    state_.PolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    // fence this frame's instance data
+    stream_.Advance();
+
+    frame.stats.state_calls_issued = state_.counters().issued;
+    frame.stats.state_calls_elided = state_.counters().elided;
+    stats_ = frame.stats;
+    // the last references to meshes removed from the registry are released on the GL thread
+    frame.meshes.clear();
+    frame.recorded = false;
+}
+
+/**************************************************************************************************/
+
+void RendererImpl::SetCamera(const GLShader& shader, const ViewProjection& camera)
+{
+    state_.UniformMatrix4fv(shader.unif_loc(GLUnif::VIEW), glm::value_ptr(camera.view));
+    state_.UniformMatrix4fv(shader.unif_loc(GLUnif::PROJECTION), glm::value_ptr(camera.projection));
+}
+
+/**************************************************************************************************/
+
+void RendererImpl::CullObjects(const entt::registry& registry, const Frustum& frustum, FrameData& frame)
+{
+    PROFILE_ZONE("CullObjects");
+    objects_.clear();
+    spheres_.clear();
+    const auto add = [&](const WorldMatrix& world, const Renderable& renderable) {
+        objects_.push_back({ &renderable, &world.model });
+        if (culling_) {
+            spheres_.push_back(TransformSphere(world.model, renderable.mesh->bounds));
+        }
+    };
+
+    // candidates come from the spatial index when there is one, leaving out whole subtrees outside of the view
+    size_t num_objects;
+    const auto* tree = registry.try_ctx<AabbTree>();
+    if (culling_ && tree) {
+        tree->Query(frustum, [&](uint32_t user_data) {
+            const auto entity = static_cast<entt::entity>(user_data);
+            add(registry.get<WorldMatrix>(entity), registry.get<Renderable>(entity));
+            return true;
+        });
+        num_objects = tree->size();
+    }
+    else {
+        registry.view<const WorldMatrix, const Renderable>().each(add);
+        num_objects = objects_.size();
+    }
+    if (not culling_) {
+        frame.stats.simple.visible = static_cast<unsigned int>(objects_.size());
+        return;
+    }
+
+    visible_.resize(spheres_.size());
+    const size_t num_visible = CullSpheres(frustum, spheres_, visible_.data());
+    // compact in place, visible indices are ascending
+    for (size_t i = 0; i < num_visible; i++) {
+        objects_[i] = objects_[visible_[i]];
+    }
+    objects_.resize(num_visible);
+    frame.stats.simple.visible = static_cast<unsigned int>(num_visible);
+    frame.stats.simple.culled = static_cast<unsigned int>(num_objects - num_visible);
+}
+
+/**************************************************************************************************/
+
+void RendererImpl::CullInstances(const entt::registry& registry, const Frustum& frustum, FrameData& frame)
+{
+    PROFILE_ZONE("CullInstances");
+    auto view = registry.view<const RenderableInstanced>();
+    view.each([&](const RenderableInstanced& renderable) {
+        const uint64_t key = CommandQueue::MakeKey(RenderPass::_3D, MyShader::SIMPLE_INSTANCE, 0, renderable.vao, 0.0f);
+        DrawCommand command{
+            .shader = MyShader::SIMPLE_INSTANCE,
+            .vao = renderable.vao,
+            .mesh = nullptr,
+            .num_indices = renderable.num_indices,
+            .num_instances = renderable.num_instances,
+            .first_model = static_cast<uint32_t>(frame.models.size()),
+            .instance_buffer = GLuint(renderable.ibo),
+        };
+
+        // instances without a CPU copy are drawn as they are
+        if (renderable.models.empty()) {
+            frame.queue.Push(key, command);
+            frame.stats.instanced.visible += renderable.num_instances;
+            return;
+        }
+
+        const size_t num_models = renderable.models.size();
+        if (not culling_) {
+            frame.models.insert(frame.models.end(), renderable.models.begin(), renderable.models.end());
+            command.num_instances = static_cast<unsigned int>(num_models);
+            command.instance_buffer = 0;
+            frame.queue.Push(key, command);
+            frame.stats.instanced.visible += static_cast<unsigned int>(num_models);
+            return;
+        }
+
+        // cull chunks of instances in parallel, each writing its visible indices at the start of its own range
+        const size_t num_chunks = (num_models + kCullChunkSize - 1) / kCullChunkSize;
+        spheres_.resize(num_models);
+        visible_.resize(num_models);
+        chunk_visible_.resize(num_chunks);
+        system::JobSystem::current().ParallelFor(num_models, kCullChunkSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                spheres_[i] = TransformSphere(renderable.models[i], renderable.bounds);
+            }
+            const gsl::span<const glm::vec4> chunk{ spheres_.data() + begin, end - begin };
+            const size_t num_visible = CullSpheres(frustum, chunk, visible_.data() + begin);
+            chunk_visible_[begin / kCullChunkSize] = static_cast<uint32_t>(num_visible);
+        });
+
+        size_t num_visible = 0;
+        for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+            const size_t begin = chunk * kCullChunkSize;
+            for (size_t i = 0; i < chunk_visible_[chunk]; i++) {
+                frame.models.push_back(renderable.models[begin + visible_[begin + i]]);
+            }
+            num_visible += chunk_visible_[chunk];
+        }
+        frame.stats.instanced.visible += static_cast<unsigned int>(num_visible);
+        frame.stats.instanced.culled += static_cast<unsigned int>(num_models - num_visible);
+        if (num_visible == 0) {
+            return;
+        }
+        command.num_instances = static_cast<unsigned int>(num_visible);
+        command.instance_buffer = 0;
+        frame.queue.Push(key, command);
+    });
 }
 
 /**************************************************************************************************/
@@ -186,6 +487,21 @@ void Renderer::Render(const entt::registry& registry)
     reinterpret_cast<RendererImpl*>(impl_)->Render(registry);
 }
 
+void Renderer::Record(const entt::registry& registry)
+{
+    reinterpret_cast<RendererImpl*>(impl_)->Record(registry);
+}
+
+void Renderer::Swap()
+{
+    reinterpret_cast<RendererImpl*>(impl_)->Swap();
+}
+
+void Renderer::Submit()
+{
+    reinterpret_cast<RendererImpl*>(impl_)->Submit();
+}
+
 void Renderer::OnResize(Size size)
 {
     reinterpret_cast<RendererImpl*>(impl_)->OnResize(size);
@@ -206,4 +522,49 @@ void Renderer::OnKeystroke(event::KeyEvent key_event, float deltatime)
     reinterpret_cast<RendererImpl*>(impl_)->OnKeystroke(key_event, deltatime);
 }
 
+glm::vec3 Renderer::CameraPosition() const
+{
+    return reinterpret_cast<const RendererImpl*>(impl_)->CameraPosition();
+}
+
+void Renderer::InvalidateState()
+{
+    reinterpret_cast<RendererImpl*>(impl_)->InvalidateState();
+}
+
+void Renderer::SetBatching(bool enabled)
+{
+    reinterpret_cast<RendererImpl*>(impl_)->SetBatching(enabled);
+}
+
+bool Renderer::Batching() const
+{
+    return reinterpret_cast<const RendererImpl*>(impl_)->Batching();
+}
+
+void Renderer::SetCulling(bool enabled)
+{
+    reinterpret_cast<RendererImpl*>(impl_)->SetCulling(enabled);
+}
+
+bool Renderer::Culling() const
+{
+    return reinterpret_cast<const RendererImpl*>(impl_)->Culling();
+}
+
+void Renderer::SetSorting(bool enabled)
+{
+    reinterpret_cast<RendererImpl*>(impl_)->SetSorting(enabled);
+}
+
+bool Renderer::Sorting() const
+{
+    return reinterpret_cast<const RendererImpl*>(impl_)->Sorting();
+}
+
+const RenderStats& Renderer::Stats() const
+{
+    return reinterpret_cast<const RendererImpl*>(impl_)->Stats();
+}
+
 }  // namespace firstgame::render
@@ -2,8 +2,10 @@
 #define FIRSTGAME_RENDER_RENDERER_H_
 
 #include <entt/entity/fwd.hpp>
+#include <glm/vec3.hpp>
 #include "firstgame/util/size.h"
 #include "firstgame/event/key.h"
+#include "render_stats.h"
 
 namespace firstgame::render {
 
@@ -15,10 +17,34 @@ class Renderer final {
 
     // Interface
     void Render(const entt::registry& registry);
+
+    // Pipelined frame, Render() is Record() + Swap() + Submit()
+    /// Record the draw commands of the next frame from the registry, without any GL call.
+    /// May run on another thread than the GL context's, concurrently with Submit() of the previous frame,
+    /// as long as nothing creates or destroys GL objects meanwhile.
+    void Record(const entt::registry& registry);
+    /// Make the recorded frame the one to submit, with neither Record() nor Submit() running
+    void Swap();
+    /// Replay the frame recorded before the last Swap(), on the GL context's thread
+    void Submit();
+
     void OnResize(util::Size size);
     void OnScroll(float offset);
     void OnCursorMove(float xpos, float ypos);
     void OnKeystroke(event::KeyEvent key_event, float deltatime);
+    /// Position of the 3D camera, changed only by the events above
+    [[nodiscard]] glm::vec3 CameraPosition() const;
+    /// Forget the GL state the renderer shadows, after GL calls made around it, like the UI the platform renders
+    void InvalidateState();
+
+    // Settings/Stats
+    void SetBatching(bool enabled);
+    [[nodiscard]] bool Batching() const;
+    void SetCulling(bool enabled);
+    [[nodiscard]] bool Culling() const;
+    void SetSorting(bool enabled);
+    [[nodiscard]] bool Sorting() const;
+    [[nodiscard]] const RenderStats& Stats() const;
 
     // Copy/Move
     Renderer(Renderer&&) = delete;
@@ -28,7 +54,7 @@ class Renderer final {
 
    private:
     //! Implementation object buffer
-    alignas(8) unsigned char impl_[1024]{};
+    alignas(8) unsigned char impl_[2048]{};
 };
 
 }  // namespace firstgame::render
@@ -0,0 +1,364 @@
+#include "scene_snapshot.h"
+
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <entt/entity/entity.hpp>
+#include <entt/entity/registry.hpp>
+#include <entt/entity/snapshot.hpp>
+
+#include "motion.h"
+#include "renderable.h"
+#include "transform.h"
+#include "firstgame/system/log.h"
+
+namespace firstgame::render {
+
+/// Layout of the binary scene (.fgscene), little-endian:
+///
+///     | SceneHeader | mesh names | pad | Section | entity ids | pad | values | pad | Section ...
+///
+/// Mesh names are a uint32_t length followed by the characters. The first section lists the entities, with no
+/// values, the next ones a component each, as the column of the entities having it and the column of its values.
+/// Columns are aligned so a mapped scene is inserted into the registry straight from the file.
+namespace scene_format {
+
+inline constexpr char kMagic[4] = { 'F', 'G', 'S', 'C' };
+inline constexpr uint32_t kVersion = 1;
+inline constexpr uint64_t kAlignment = 16;
+
+enum class SectionKind : uint32_t {
+    ENTITIES = 0,
+    TRANSFORM = 1,
+    MOTION = 2,
+    RENDERABLE = 3,  ///< values are uint32_t indices into the mesh names
+};
+
+struct SceneHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t num_meshes;
+    uint32_t num_sections;
+};
+
+struct SectionHeader {
+    SectionKind kind;
+    uint32_t stride;  ///< size of a value, zero for the entities
+    uint64_t count;
+};
+
+}  // namespace scene_format
+
+using scene_format::SceneHeader;
+using scene_format::SectionHeader;
+using scene_format::SectionKind;
+using entity_type = entt::entt_traits<entt::entity>::entity_type;
+
+static_assert(std::is_trivially_copyable_v<Transform> && std::is_trivially_copyable_v<Motion>);
+
+/**************************************************************************************************/
+
+/// Component values in a column, along with the column of their entities
+template<typename T>
+struct Column {
+    std::vector<entity_type> entities;
+    std::vector<T> values;
+};
+
+/// Output archive of an entt::snapshot, collecting the entities and each component into columns
+class ColumnArchive {
+   public:
+    explicit ColumnArchive(const MeshTable& meshes)
+    {
+        for (size_t i = 0; i < meshes.size(); i++) {
+            mesh_indices_.emplace(meshes[i].second.get(), static_cast<uint32_t>(i));
+        }
+    }
+
+    /// Size of the next entities or components, the columns are reserved from the registry instead
+    void operator()(entity_type) {}
+
+    void operator()(entt::entity entity) { entities.push_back(entt::to_integral(entity)); }
+
+    void operator()(entt::entity entity, const Transform& transform) { Push(transforms, entity, transform); }
+
+    void operator()(entt::entity entity, const Motion& motion) { Push(motions, entity, motion); }
+
+    void operator()(entt::entity entity, const Renderable& renderable)
+    {
+        const auto it = mesh_indices_.find(renderable.mesh.get());
+        if (it == mesh_indices_.end()) {
+            num_skipped++;
+            return;
+        }
+        Push(renderables, entity, it->second);
+    }
+
+   private:
+    template<typename T>
+    static void Push(Column<T>& column, entt::entity entity, const T& value)
+    {
+        column.entities.push_back(entt::to_integral(entity));
+        column.values.push_back(value);
+    }
+
+   public:
+    std::vector<entity_type> entities;
+    Column<Transform> transforms;
+    Column<Motion> motions;
+    Column<uint32_t> renderables;
+    size_t num_skipped = 0;  ///< renderables with a mesh out of the table
+
+   private:
+    std::unordered_map<const Mesh*, uint32_t> mesh_indices_;
+};
+
+/**************************************************************************************************/
+
+static void Append(std::vector<std::byte>& bytes, const void* data, size_t size)
+{
+    const auto* first = static_cast<const std::byte*>(data);
+    bytes.insert(bytes.end(), first, first + size);
+}
+
+static void Pad(std::vector<std::byte>& bytes)
+{
+    bytes.resize((bytes.size() + scene_format::kAlignment - 1) / scene_format::kAlignment * scene_format::kAlignment);
+}
+
+template<typename T>
+static void AppendSection(std::vector<std::byte>& bytes, SectionKind kind, const Column<T>& column)
+{
+    const SectionHeader header{ .kind = kind, .stride = sizeof(T), .count = column.entities.size() };
+    Append(bytes, &header, sizeof(header));
+    Append(bytes, column.entities.data(), column.entities.size() * sizeof(entity_type));
+    Pad(bytes);
+    Append(bytes, column.values.data(), column.values.size() * sizeof(T));
+    Pad(bytes);
+}
+
+std::vector<std::byte> SaveScene(const entt::registry& registry, const MeshTable& meshes)
+{
+    ColumnArchive archive(meshes);
+    archive.entities.reserve(registry.alive());
+    archive.transforms.entities.reserve(registry.size<Transform>());
+    archive.transforms.values.reserve(registry.size<Transform>());
+    archive.motions.entities.reserve(registry.size<Motion>());
+    archive.motions.values.reserve(registry.size<Motion>());
+    archive.renderables.entities.reserve(registry.size<Renderable>());
+    archive.renderables.values.reserve(registry.size<Renderable>());
+    entt::snapshot{ registry }.entities(archive).component<Transform, Motion, Renderable>(archive);
+    if (archive.num_skipped) {
+        WARN("Scene saved without {} renderables, their mesh is not in the mesh table", archive.num_skipped);
+    }
+
+    std::vector<std::byte> bytes;
+    bytes.reserve(sizeof(SceneHeader) + archive.entities.size() * sizeof(entity_type) +
+                  archive.transforms.values.size() * (sizeof(entity_type) + sizeof(Transform)) +
+                  archive.motions.values.size() * (sizeof(entity_type) + sizeof(Motion)) +
+                  archive.renderables.values.size() * (sizeof(entity_type) + sizeof(uint32_t)) + 1024);
+    SceneHeader header{
+        .magic = {},
+        .version = scene_format::kVersion,
+        .num_meshes = static_cast<uint32_t>(meshes.size()),
+        .num_sections = 4,
+    };
+    std::memcpy(header.magic, scene_format::kMagic, sizeof(header.magic));
+    Append(bytes, &header, sizeof(header));
+    for (const auto& [name, mesh] : meshes) {
+        const auto length = static_cast<uint32_t>(name.size());
+        Append(bytes, &length, sizeof(length));
+        Append(bytes, name.data(), name.size());
+    }
+    Pad(bytes);
+
+    const SectionHeader entities{ .kind = SectionKind::ENTITIES, .stride = 0, .count = archive.entities.size() };
+    Append(bytes, &entities, sizeof(entities));
+    Append(bytes, archive.entities.data(), archive.entities.size() * sizeof(entity_type));
+    Pad(bytes);
+    AppendSection(bytes, SectionKind::TRANSFORM, archive.transforms);
+    AppendSection(bytes, SectionKind::MOTION, archive.motions);
+    AppendSection(bytes, SectionKind::RENDERABLE, archive.renderables);
+    return bytes;
+}
+
+/**************************************************************************************************/
+
+/// Sequential reader of the scene bytes, checking bounds
+class SceneReader {
+   public:
+    explicit SceneReader(gsl::span<const std::byte> bytes) : bytes_(bytes) {}
+
+    template<typename T>
+    T Read()
+    {
+        T value;
+        std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    /// View a column of `count` values of T in place, or copied into `fallback` if the bytes are misaligned for T
+    template<typename T>
+    gsl::span<const T> Column(uint64_t count, std::vector<T>& fallback)
+    {
+        if (count > (bytes_.size() - offset_) / sizeof(T)) {
+            throw std::runtime_error("Scene truncated");
+        }
+        const std::byte* data = Take(count * sizeof(T));
+        Align();
+        if (reinterpret_cast<uintptr_t>(data) % alignof(T) == 0) {
+            return { reinterpret_cast<const T*>(data), static_cast<size_t>(count) };
+        }
+        fallback.resize(count);
+        std::memcpy(fallback.data(), data, count * sizeof(T));
+        return fallback;
+    }
+
+    const std::byte* Take(uint64_t size)
+    {
+        if (size > bytes_.size() - offset_) {
+            throw std::runtime_error("Scene truncated");
+        }
+        const std::byte* data = bytes_.data() + offset_;
+        offset_ += size;
+        return data;
+    }
+
+    void Align()
+    {
+        const uint64_t aligned = (offset_ + scene_format::kAlignment - 1) / scene_format::kAlignment * scene_format::kAlignment;
+        offset_ = std::min<uint64_t>(aligned, bytes_.size());
+    }
+
+   private:
+    gsl::span<const std::byte> bytes_;
+    uint64_t offset_ = 0;
+};
+
+/// Map the entities of a column to the entities created for them
+static void MapEntities(gsl::span<const entity_type> column, const std::vector<entt::entity>& remap,
+                        std::vector<entt::entity>& mapped)
+{
+    mapped.resize(column.size());
+    for (size_t i = 0; i < column.size(); i++) {
+        const auto index = column[i] & entt::entt_traits<entt::entity>::entity_mask;
+        if (index >= remap.size() || remap[index] == entt::null) {
+            throw std::runtime_error("Scene component of an unknown entity");
+        }
+        mapped[i] = remap[index];
+    }
+}
+
+/// Bulk insert a column of component values
+template<typename T>
+static void InsertColumn(SceneReader& reader, const SectionHeader& section, entt::registry& registry,
+                         const std::vector<entt::entity>& remap, std::vector<entt::entity>& mapped)
+{
+    if (section.stride != sizeof(T)) {
+        throw std::runtime_error("Scene component of mismatching size " + std::to_string(section.stride));
+    }
+    std::vector<entity_type> entities_fallback;
+    std::vector<T> values_fallback;
+    const auto entities = reader.Column<entity_type>(section.count, entities_fallback);
+    const auto values = reader.Column<T>(section.count, values_fallback);
+    MapEntities(entities, remap, mapped);
+    registry.insert<T>(mapped.begin(), mapped.end(), values.begin(), values.end());
+}
+
+size_t LoadScene(gsl::span<const std::byte> bytes, entt::registry& registry, const MeshTable& meshes)
+{
+    SceneReader reader(bytes);
+    const auto header = reader.Read<SceneHeader>();
+    if (std::memcmp(header.magic, scene_format::kMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Scene bad magic");
+    }
+    if (header.version != scene_format::kVersion) {
+        throw std::runtime_error("Scene unsupported version " + std::to_string(header.version));
+    }
+
+    // resolve the meshes by name
+    std::vector<std::shared_ptr<const Mesh>> scene_meshes(header.num_meshes);
+    for (auto& scene_mesh : scene_meshes) {
+        const auto length = reader.Read<uint32_t>();
+        const std::string_view name(reinterpret_cast<const char*>(reader.Take(length)), length);
+        for (const auto& [table_name, mesh] : meshes) {
+            if (table_name == name) {
+                scene_mesh = mesh;
+                break;
+            }
+        }
+        if (not scene_mesh) {
+            WARN("Scene mesh '{}' is not in the mesh table, its renderables are left out", name);
+        }
+    }
+    reader.Align();
+
+    // entities are created anew, remapped from their identifier in the scene
+    std::vector<entt::entity> remap;
+    std::vector<entt::entity> mapped;
+    size_t num_entities = 0;
+    for (uint32_t s = 0; s < header.num_sections; s++) {
+        const auto section = reader.Read<SectionHeader>();
+        switch (section.kind) {
+            case SectionKind::ENTITIES: {
+                std::vector<entity_type> fallback;
+                const auto entities = reader.Column<entity_type>(section.count, fallback);
+                std::vector<entt::entity> created(entities.size());
+                registry.create(created.begin(), created.end());
+                for (size_t i = 0; i < entities.size(); i++) {
+                    const auto index = entities[i] & entt::entt_traits<entt::entity>::entity_mask;
+                    if (index >= remap.size()) {
+                        remap.resize(index + 1, entt::null);
+                    }
+                    remap[index] = created[i];
+                }
+                num_entities += created.size();
+                break;
+            }
+            case SectionKind::TRANSFORM: InsertColumn<Transform>(reader, section, registry, remap, mapped); break;
+            case SectionKind::MOTION: InsertColumn<Motion>(reader, section, registry, remap, mapped); break;
+            case SectionKind::RENDERABLE: {
+                if (section.stride != sizeof(uint32_t)) {
+                    throw std::runtime_error("Scene renderables of mismatching size " + std::to_string(section.stride));
+                }
+                std::vector<entity_type> entities_fallback;
+                std::vector<uint32_t> indices_fallback;
+                const auto entities = reader.Column<entity_type>(section.count, entities_fallback);
+                const auto indices = reader.Column<uint32_t>(section.count, indices_fallback);
+                MapEntities(entities, remap, mapped);
+                std::vector<entt::entity> drawn;
+                std::vector<Renderable> renderables;
+                drawn.reserve(mapped.size());
+                renderables.reserve(mapped.size());
+                for (size_t i = 0; i < mapped.size(); i++) {
+                    if (indices[i] >= scene_meshes.size()) {
+                        throw std::runtime_error("Scene renderable of an unknown mesh");
+                    }
+                    if (scene_meshes[indices[i]]) {
+                        drawn.push_back(mapped[i]);
+                        renderables.push_back(Renderable{ scene_meshes[indices[i]] });
+                    }
+                }
+                registry.insert<Renderable>(drawn.begin(), drawn.end(), renderables.begin(), renderables.end());
+                break;
+            }
+            default: {
+                // component unknown to this version, skipped
+                if (section.stride && section.count > std::numeric_limits<uint64_t>::max() / section.stride) {
+                    throw std::runtime_error("Scene truncated");
+                }
+                std::vector<entity_type> fallback;
+                reader.Column<entity_type>(section.count, fallback);
+                reader.Take(section.count * section.stride);
+                reader.Align();
+                break;
+            }
+        }
+    }
+    return num_entities;
+}
+
+}  // namespace firstgame::render
@@ -0,0 +1,31 @@
+#ifndef FIRSTGAME_RENDER_SCENE_SNAPSHOT_H_
+#define FIRSTGAME_RENDER_SCENE_SNAPSHOT_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <entt/entity/fwd.hpp>
+#include <gsl/span>
+
+#include "mesh.h"
+
+namespace firstgame::render {
+
+/// Meshes that scenes may reference, by name. Meshes live on the GPU, so a scene stores the names of the meshes
+/// of its Renderables and resolves them with the table of the program loading it.
+using MeshTable = std::vector<std::pair<std::string, std::shared_ptr<const Mesh>>>;
+
+/// Save the entities of the registry with their Transform, Motion and Renderable components into a binary scene
+/// (.fgscene). Each component is written as a column of entities followed by a column of values, so that loading
+/// is a bulk insertion into the component storage. Renderables whose mesh is not in the table are left out.
+std::vector<std::byte> SaveScene(const entt::registry& registry, const MeshTable& meshes);
+
+/// Load a binary scene into the registry, as new entities, and return their number. Meshes whose name is not in
+/// the table are left out, along with their Renderables. Throws std::runtime_error if the scene is malformed.
+size_t LoadScene(gsl::span<const std::byte> bytes, entt::registry& registry, const MeshTable& meshes);
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_SCENE_SNAPSHOT_H_
@@ -1,8 +1,17 @@
 #include <firstgame/opengl/shader.h>
 #include "shader_lib.h"
 
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <stdexcept>
+#include <filesystem>
+
 #include "firstgame/system/log.h"
 #include "firstgame/system/asset_mgr.h"
+#include "firstgame/system/asset_loader.h"
+#include "firstgame/system/asset_watcher.h"
 #include "firstgame/util/filesystem_literals.h"
 #include "firstgame/util/scoped.h"
 
@@ -20,42 +29,213 @@ opengl::GLShader& ShaderLibrary::get(MyShader my_shader)
     throw std::runtime_error("MyShader not loaded");
 }
 
-template<>
-void ShaderLibrary::load<MyShader::SIMPLE>()
+opengl::GLShader* ShaderLibrary::find(MyShader my_shader)
 {
-    auto& asset_mgr = system::AssetManager::current();
-    auto vert = asset_mgr.Open("shaders"_path / "main.vert").Assert()->ReadToString();
-    auto frag = asset_mgr.Open("shaders"_path / "main.frag").Assert()->ReadToString();
-    auto shader = opengl::GLShader::build("simple", { vert, frag }).Assert();
-    shader->load_attr_loc({
-        { opengl::GLAttr::POSITION, "aPosition" },
-        { opengl::GLAttr::COLOR, "aColor" },
-    });
-    shader->load_unif_loc({
-        { opengl::GLUnif::MODEL, "uModel" },
-        { opengl::GLUnif::VIEW, "uView" },
-        { opengl::GLUnif::PROJECTION, "uProjection" },
-    });
-    shaders_[static_cast<size_t>(MyShader::SIMPLE)] = std::move(shader);
+    auto idx = static_cast<size_t>(my_shader);
+    return shaders_[idx].exists() ? &shaders_[idx].get() : nullptr;
 }
 
-template<>
-void ShaderLibrary::load<MyShader::SIMPLE_INSTANCE>()
+/// Source files of a shader
+struct ShaderFiles {
+    std::filesystem::path vertex;
+    std::filesystem::path fragment;
+};
+
+/// Get the source files of a shader
+static auto Files(MyShader my_shader) -> ShaderFiles
+{
+    switch (my_shader) {
+        case MyShader::SIMPLE: return { "shaders"_path / "main.vert", "shaders"_path / "main.frag" };
+        case MyShader::SIMPLE_INSTANCE: return { "shaders"_path / "instance.vert", "shaders"_path / "main.frag" };
+        case MyShader::COUNT: break;
+    }
+    abort();  //< unreachable
+}
+
+/// Program name of a shader, also naming its cached binary
+static auto Name(MyShader my_shader) -> std::string_view
+{
+    switch (my_shader) {
+        case MyShader::SIMPLE: return "simple";
+        case MyShader::SIMPLE_INSTANCE: return "instance";
+        case MyShader::COUNT: break;
+    }
+    abort();  //< unreachable
+}
+
+/// Read the locations of the variables of a shader program
+static void LoadLocations(MyShader my_shader, opengl::GLShader& shader)
+{
+    switch (my_shader) {
+        case MyShader::SIMPLE: {
+            shader.load_attr_loc({
+                { opengl::GLAttr::POSITION, "aPosition" },
+                { opengl::GLAttr::COLOR, "aColor" },
+            });
+            shader.load_unif_loc({
+                { opengl::GLUnif::MODEL, "uModel" },
+                { opengl::GLUnif::VIEW, "uView" },
+                { opengl::GLUnif::PROJECTION, "uProjection" },
+            });
+            return;
+        }
+        case MyShader::SIMPLE_INSTANCE: {
+            shader.load_attr_loc({
+                { opengl::GLAttr::POSITION, "aPosition" },
+                { opengl::GLAttr::COLOR, "aColor" },
+                { opengl::GLAttr::MODEL, "aModel" },
+            });
+            shader.load_unif_loc({
+                { opengl::GLUnif::VIEW, "uView" },
+                { opengl::GLUnif::PROJECTION, "uProjection" },
+            });
+            return;
+        }
+        case MyShader::COUNT: break;
+    }
+    abort();  //< unreachable
+}
+
+opengl::ProgramCache& ShaderLibrary::program_cache()
+{
+    if (not program_cache_) {
+        program_cache_ = std::make_shared<opengl::ProgramCache>(system::AssetManager::current().Storage());
+    }
+    return *program_cache_;
+}
+
+auto ShaderLibrary::create(MyShader my_shader, std::string_view vert, std::string_view frag, uint64_t key,
+                           std::optional<opengl::ProgramBinary> binary) -> util::Scoped<opengl::GLShader>
+{
+    const auto start = std::chrono::steady_clock::now();
+    const std::string name(Name(my_shader));
+    util::Scoped<opengl::GLShader> shader;
+    if (binary) {
+        shader = opengl::GLShader::from_binary(name, *binary);
+        (shader ? stats_.cached : stats_.rejected)++;
+    }
+    if (not shader) {
+        shader = opengl::GLShader::build(name, { vert, frag }, program_cache_->enabled());
+        if (not shader) {
+            return {};
+        }
+        stats_.built++;
+        if (auto built = program_cache_->enabled() ? shader->binary() : std::nullopt) {
+            // only the retrieval is on the GL thread, the file is written on a loader thread
+            system::AssetLoader::current().Async([cache = program_cache_, name, key, built = std::move(*built)] {
+                cache->write(name, key, built);
+                return [] {};
+            });
+        }
+    }
+    LoadLocations(my_shader, *shader);
+
+    const float create_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    stats_.create_ms += create_ms;
+    DEBUG("Created MyShader '{}' in {:.3f} ms", name, create_ms);
+    return shader;
+}
+
+void ShaderLibrary::load(MyShader my_shader)
 {
     auto& asset_mgr = system::AssetManager::current();
-    auto vert = asset_mgr.Open("shaders"_path / "instance.vert").Assert()->ReadToString();
-    auto frag = asset_mgr.Open("shaders"_path / "main.frag").Assert()->ReadToString();
-    auto shader = opengl::GLShader::build("instance", { vert, frag }).Assert();
-    shader->load_attr_loc({
-        { opengl::GLAttr::POSITION, "aPosition" },
-        { opengl::GLAttr::COLOR, "aColor" },
-        { opengl::GLAttr::MODEL, "aModel" },
+    const ShaderFiles files = Files(my_shader);
+    auto vert = asset_mgr.Load(files.vertex);
+    auto frag = asset_mgr.Load(files.fragment);
+    ASSERT(vert && frag);
+    const auto& cache = program_cache();
+    const uint64_t key = cache.key({ vert->View(), frag->View() });
+    shaders_[static_cast<size_t>(my_shader)] =
+        create(my_shader, vert->View(), frag->View(), key, cache.read(Name(my_shader), key)).Assert();
+    loads_[static_cast<size_t>(my_shader)] = {};
+    watch(my_shader);
+}
+
+void ShaderLibrary::load_async(MyShader my_shader)
+{
+    auto future = system::AssetLoader::current().Async([this, my_shader, cache = &program_cache()] {
+        // read the sources and cached binary on the loader thread, sources shared between shaders are read once
+        auto& asset_mgr = system::AssetManager::current();
+        const ShaderFiles files = Files(my_shader);
+        auto vert = asset_mgr.Load(files.vertex);
+        auto frag = asset_mgr.Load(files.fragment);
+        if (not vert || not frag) {
+            throw std::runtime_error("Failed to read MyShader sources");
+        }
+        const uint64_t key = cache->key({ vert->View(), frag->View() });
+        auto binary = cache->read(Name(my_shader), key);
+        // create on the GL thread
+        return [this, my_shader, vert, frag, key, binary = std::move(binary)]() mutable {
+            shaders_[static_cast<size_t>(my_shader)] =
+                create(my_shader, vert->View(), frag->View(), key, std::move(binary)).Assert();
+        };
     });
-    shader->load_unif_loc({
-        { opengl::GLUnif::VIEW, "uView" },
-        { opengl::GLUnif::PROJECTION, "uProjection" },
+    loads_[static_cast<size_t>(my_shader)] = future.share();
+    watch(my_shader);
+}
+
+void ShaderLibrary::reload(MyShader my_shader)
+{
+    system::AssetLoader::current().Async([this, my_shader, cache = &program_cache()] {
+        auto& asset_mgr = system::AssetManager::current();
+        const ShaderFiles files = Files(my_shader);
+        auto vert = asset_mgr.Load(files.vertex);
+        auto frag = asset_mgr.Load(files.fragment);
+        if (not vert || not frag) {
+            WARN("Failed to read MyShader '{}' sources for reload", Name(my_shader));
+            throw std::runtime_error("Failed to read MyShader sources");
+        }
+        const uint64_t key = cache->key({ vert->View(), frag->View() });
+        auto binary = cache->read(Name(my_shader), key);
+        // swap on the GL thread, between frames
+        return [this, my_shader, vert, frag, key, binary = std::move(binary)]() mutable {
+            auto& current = shaders_[static_cast<size_t>(my_shader)];
+            auto shader = create(my_shader, vert->View(), frag->View(), key, std::move(binary));
+            if (not shader) {
+                WARN("Failed to reload MyShader '{}', keeping the current program", Name(my_shader));
+                return;
+            }
+            for (size_t attr = 0; current && attr < static_cast<size_t>(opengl::GLAttr::COUNT); attr++) {
+                const auto gl_attr = static_cast<opengl::GLAttr>(attr);
+                if (shader->attr_loc(gl_attr) != current->attr_loc(gl_attr)) {
+                    WARN("Reloaded MyShader '{}' moved its vertex attributes, keeping the current program",
+                         Name(my_shader));
+                    return;
+                }
+            }
+            current = std::move(shader);
+            stats_.reloaded++;
+            DEBUG("Reloaded MyShader '{}'", Name(my_shader));
+        };
     });
-    shaders_[static_cast<size_t>(MyShader::SIMPLE_INSTANCE)] = std::move(shader);
+}
+
+void ShaderLibrary::watch(MyShader my_shader)
+{
+    auto& watched = watched_[static_cast<size_t>(my_shader)];
+    if (watched) {
+        return;
+    }
+    watched = true;
+    auto& watcher = system::AssetWatcher::current();
+    const ShaderFiles files = Files(my_shader);
+    for (const auto& file : { files.vertex, files.fragment }) {
+        watcher.Watch(this, file, [this, my_shader] {
+            if (find(my_shader)) {
+                reload(my_shader);
+            }
+        });
+    }
+}
+
+ShaderLibrary::~ShaderLibrary()
+{
+    system::AssetWatcher::current().Unwatch(this);
+}
+
+std::shared_future<void> ShaderLibrary::loading(MyShader my_shader) const
+{
+    return loads_[static_cast<size_t>(my_shader)];
 }
 
 void ShaderLibrary::unload(MyShader my_shader)
@@ -1,9 +1,15 @@
 #ifndef FIRSTGAME_RENDER_SHADERS_H_
 #define FIRSTGAME_RENDER_SHADERS_H_
 
+#include <future>
+#include <memory>
+#include <optional>
+#include <string_view>
+
 #include "firstgame/util/currenton.h"
 #include "firstgame/util/scoped.h"
 #include "firstgame/opengl/shader.h"
+#include "firstgame/opengl/program_cache.h"
 
 namespace firstgame::render {
 
@@ -22,13 +28,25 @@ enum class MyShader {
     COUNT,
 };
 
+/// Startup cost of the shaders, to compare launches with a cold and a warm program cache
+struct ShaderStats {
+    unsigned int built;     ///< programs compiled and linked from sources
+    unsigned int cached;    ///< programs created from a cached binary
+    unsigned int rejected;  ///< cached binaries rejected by the driver, then built from sources
+    unsigned int reloaded;  ///< programs replaced after their sources changed
+    float create_ms;        ///< time spent creating the programs on the GL thread
+};
+
 /// ShadersLibrary contains all shaders used throughout the engine.
+/// Programs are created from the binaries of the ProgramCache when valid, and built from sources otherwise.
 /// Since it is a Currenton, anyone can retrieve a shader object with get().
-/// Remember to load the shaders before they are queried.
+/// Remember to load the shaders before they are queried, load_async() returns before the shader is built,
+/// so either wait for loading() to be ready or use find().
 /// Also for current() to work, the global ShaderLibrary needs to be instanced somewhere in the program.
 class ShaderLibrary final : public util::Currenton<ShaderLibrary> {
    public:
     ShaderLibrary() = default;
+    ~ShaderLibrary() override;
     ShaderLibrary(const ShaderLibrary&) = delete;
     ShaderLibrary& operator=(const ShaderLibrary&) = delete;
 
@@ -36,16 +54,53 @@ class ShaderLibrary final : public util::Currenton<ShaderLibrary> {
     /// Get shader from library
     [[nodiscard]] opengl::GLShader& get(MyShader my_shader);
 
-    /// Load shader into library
-    template<MyShader>
-    void load();
+    /// Get shader from library, or null if not loaded yet
+    [[nodiscard]] opengl::GLShader* find(MyShader my_shader);
+
+    /// Load shader into library, reading its sources and building it right away
+    void load(MyShader my_shader);
+
+    /// Load shader into library in the background with the AssetLoader,
+    /// reading the sources on a loader thread and building the program on the GL thread
+    void load_async(MyShader my_shader);
+
+    /// Rebuild a loaded shader from its current sources in the background, replacing the program between frames.
+    /// The current program is kept if the new one fails to build or moves its vertex attributes, as the vertex arrays
+    /// of the meshes drawn with it are bound to their locations. Called when the sources change.
+    void reload(MyShader my_shader);
+
+    /// Get the pending background load of a shader, ready once the shader is in the library.
+    /// Invalid if the shader was not loaded in the background.
+    [[nodiscard]] std::shared_future<void> loading(MyShader my_shader) const;
 
     /// Unload shader from library
     void unload(MyShader my_shader);
 
+    /// Startup cost of the shaders loaded so far
+    [[nodiscard]] const ShaderStats& stats() const { return stats_; }
+
+   private:
+    /// Get the program cache, created on first use
+    opengl::ProgramCache& program_cache();
+
+    /// Reload the shader whenever its source files change
+    void watch(MyShader my_shader);
+
+    /// Create a shader program, from its cached binary if any and accepted, otherwise from its sources,
+    /// writing the binary to the program cache in the background. Empty if the sources fail to build.
+    auto create(MyShader my_shader, std::string_view vert, std::string_view frag, uint64_t key,
+                std::optional<opengl::ProgramBinary> binary) -> util::Scoped<opengl::GLShader>;
+
    private:
     /// Library of shaders
     util::Scoped<opengl::GLShader> shaders_[static_cast<size_t>(MyShader::COUNT)];
+    /// Background loads of shaders
+    std::shared_future<void> loads_[static_cast<size_t>(MyShader::COUNT)];
+    /// Cache of program binaries, shared with its background writes
+    std::shared_ptr<opengl::ProgramCache> program_cache_;
+    ShaderStats stats_{};
+    /// Shaders whose source files are watched
+    bool watched_[static_cast<size_t>(MyShader::COUNT)] = {};
 };
 
 }  // namespace firstgame::render
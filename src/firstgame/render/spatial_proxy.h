@@ -0,0 +1,16 @@
+#ifndef FIRSTGAME_RENDER_SPATIAL_PROXY_H_
+#define FIRSTGAME_RENDER_SPATIAL_PROXY_H_
+
+#include <cstdint>
+
+namespace firstgame::render {
+
+/// SpatialProxy Component links an entity to its leaf in the spatial index.
+/// It is managed by the SpatialSystem and removed along with the entity's Renderable or WorldMatrix.
+struct SpatialProxy final {
+    int32_t id;
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_SPATIAL_PROXY_H_
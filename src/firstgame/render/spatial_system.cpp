@@ -0,0 +1,82 @@
+#include "spatial_system.h"
+
+#include <entt/entity/registry.hpp>
+
+#include "culling.h"
+#include "motion.h"
+#include "renderable.h"
+#include "spatial_proxy.h"
+#include "world_matrix.h"
+#include "firstgame/system/log.h"
+
+namespace firstgame::render {
+
+/**************************************************************************************************/
+
+/// Remove the SpatialProxy of an entity that is no longer renderable
+static void Untrack(entt::registry& registry, entt::entity entity)
+{
+    registry.remove_if_exists<SpatialProxy>(entity);
+}
+
+/// World bounds of a renderable entity
+static Aabb WorldBounds(const WorldMatrix& world, const Renderable& renderable)
+{
+    return Aabb::FromSphere(TransformSphere(world.model, renderable.mesh->bounds));
+}
+
+/**************************************************************************************************/
+
+SpatialSystem::SpatialSystem(entt::registry& registry)
+    : tree_(&registry.set<AabbTree>()),
+      dirty_(registry, entt::collector.group<WorldMatrix, Renderable>().update<WorldMatrix>().update<Renderable>())
+{
+    destroy_proxy_ = registry.on_destroy<SpatialProxy>().connect<&SpatialSystem::OnDestroyProxy>(*this);
+    destroy_renderable_ = registry.on_destroy<Renderable>().connect<&Untrack>();
+    destroy_world_ = registry.on_destroy<WorldMatrix>().connect<&Untrack>();
+    // the observer only sees changes from now on, so index the entities that already exist
+    for (const entt::entity entity : registry.view<const WorldMatrix, const Renderable>()) {
+        Track(registry, entity);
+    }
+}
+
+/**************************************************************************************************/
+
+void SpatialSystem::Update(entt::registry& registry)
+{
+    PROFILE_ZONE("SpatialSystem");
+    num_changed_ = 0;
+    dirty_.each([&](entt::entity entity) {
+        if (registry.has<WorldMatrix, Renderable>(entity)) {
+            Track(registry, entity);
+        }
+    });
+    // moving entities have their WorldMatrix refreshed in place by the MotionSystem, unseen by the observer
+    auto view = registry.view<const WorldMatrix, const Renderable, const Motion, const SpatialProxy>();
+    view.each([&](const WorldMatrix& world, const Renderable& renderable, const Motion&, const SpatialProxy& proxy) {
+        num_changed_ += tree_->MoveProxy(proxy.id, WorldBounds(world, renderable));
+    });
+}
+
+/**************************************************************************************************/
+
+void SpatialSystem::Track(entt::registry& registry, entt::entity entity)
+{
+    const Aabb bounds = WorldBounds(registry.get<WorldMatrix>(entity), registry.get<Renderable>(entity));
+    if (const auto* proxy = registry.try_get<SpatialProxy>(entity)) {
+        num_changed_ += tree_->MoveProxy(proxy->id, bounds);
+    }
+    else {
+        registry.emplace<SpatialProxy>(entity, tree_->CreateProxy(bounds, entt::to_integral(entity)));
+        num_changed_++;
+    }
+}
+
+/**************************************************************************************************/
+
+void SpatialSystem::OnDestroyProxy(entt::registry& registry, entt::entity entity)
+{
+    tree_->DestroyProxy(registry.get<SpatialProxy>(entity).id);
+}
+
+}  // namespace firstgame::render
@@ -0,0 +1,48 @@
+#ifndef FIRSTGAME_RENDER_SPATIAL_SYSTEM_H_
+#define FIRSTGAME_RENDER_SPATIAL_SYSTEM_H_
+
+#include <entt/entity/fwd.hpp>
+#include <entt/entity/observer.hpp>
+#include <entt/signal/sigh.hpp>
+
+#include "aabb_tree.h"
+
+namespace firstgame::render {
+
+/// SpatialSystem maintains a spatial index of the world bounds of renderable entities, for frustum,
+/// ray and box queries. The index is an AabbTree stored in the registry context, so that systems with
+/// read-only access to the registry, such as the renderer, can query it.
+/// Entities are inserted and updated incrementally from the WorldMatrix changes seen by an observer,
+/// plus the moving entities, which are checked every frame and only touch the tree when leaving their fat box.
+class SpatialSystem final {
+   public:
+    explicit SpatialSystem(entt::registry& registry);
+
+    /// Bring the index up to date with the world bounds of the entities
+    void Update(entt::registry& registry);
+
+    /// The spatial index
+    [[nodiscard]] const AabbTree& Tree() const { return *tree_; }
+
+    /// Number of proxies inserted or moved in the tree in the last update
+    [[nodiscard]] size_t NumChanged() const { return num_changed_; }
+
+   private:
+    /// Insert or move the proxy of an entity
+    void Track(entt::registry& registry, entt::entity entity);
+
+    /// Remove the proxy of an entity from the tree, before its SpatialProxy is destroyed
+    void OnDestroyProxy(entt::registry& registry, entt::entity entity);
+
+   private:
+    AabbTree* tree_;
+    entt::observer dirty_;
+    entt::scoped_connection destroy_proxy_;
+    entt::scoped_connection destroy_renderable_;
+    entt::scoped_connection destroy_world_;
+    size_t num_changed_ = 0;
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_SPATIAL_SYSTEM_H_
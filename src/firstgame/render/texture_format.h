@@ -0,0 +1,47 @@
+#ifndef FIRSTGAME_RENDER_TEXTURE_FORMAT_H_
+#define FIRSTGAME_RENDER_TEXTURE_FORMAT_H_
+
+#include <cstdint>
+
+/// Layout of the pre-processed texture (.fgtex), written by the texture tool and uploaded by LoadTextureAsync().
+/// All fields are little-endian, and the file is meant to be memory-mapped and uploaded in place:
+///
+///     | TextureHeader | LevelEntry[num_levels] | pad | level 0 | pad | level 1 | ... |
+///
+/// Every mip level down to 1x1 is stored, level 0 being the full image, so loads skip decoding and mip generation.
+namespace firstgame::render::texture_format {
+
+inline constexpr char kMagic[4] = { 'F', 'G', 'T', 'X' };
+inline constexpr uint32_t kVersion = 1;
+inline constexpr uint64_t kTextureAlignment = 16;
+inline constexpr uint32_t kMaxLevels = 16;  ///< up to 32768x32768
+
+/// Encoding of the texels
+enum class Codec : uint32_t {
+    RGBA8 = 0,  ///< raw 8-bit rgba
+    // reserved for BC and ETC block compression, once an encoder is available to the tools
+};
+
+/// File header, at offset zero
+struct TextureHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t num_levels;
+    Codec codec;
+};
+static_assert(sizeof(TextureHeader) == 24);
+
+/// Mip level entry, following the header
+struct LevelEntry {
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;  ///< byte offset of the texels
+    uint64_t size;    ///< byte size of the texels
+};
+static_assert(sizeof(LevelEntry) == 24);
+
+}  // namespace firstgame::render::texture_format
+
+#endif  // FIRSTGAME_RENDER_TEXTURE_FORMAT_H_
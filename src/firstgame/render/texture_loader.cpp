@@ -0,0 +1,110 @@
+#include "texture_loader.h"
+
+#include <chrono>
+#include <stdexcept>
+
+#include "firstgame/opengl/gl.h"
+#include "firstgame/system/log.h"
+#include "firstgame/system/asset_loader.h"
+#include "firstgame/system/asset_mgr.h"
+
+namespace firstgame::render {
+
+using clock = std::chrono::steady_clock;
+
+/// Milliseconds elapsed since `start`
+static float ElapsedMs(clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(clock::now() - start).count();
+}
+
+/**************************************************************************************************/
+
+std::shared_ptr<Texture> UploadTexture(const Image& image)
+{
+    ASSERT(not image.levels.empty());
+    auto texture = std::make_shared<Texture>();
+    texture->width = image.levels.front().width;
+    texture->height = image.levels.front().height;
+    texture->num_levels = static_cast<uint32_t>(image.levels.size());
+
+    glBindTexture(GL_TEXTURE_2D, texture->id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+#ifdef FIRSTGAME_OPENGL_ES3
+    // immutable storage of all the levels at once, core in OpenGL ES 3.0
+    glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(image.levels.size()), GL_RGBA8,
+                   static_cast<GLsizei>(texture->width), static_cast<GLsizei>(texture->height));
+    for (size_t level = 0; level < image.levels.size(); level++) {
+        const ImageLevel& data = image.levels[level];
+        glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0, static_cast<GLsizei>(data.width),
+                        static_cast<GLsizei>(data.height), GL_RGBA, GL_UNSIGNED_BYTE, data.texels.data());
+    }
+#else
+    // glTexStorage2D is only core since OpenGL 4.2, the OpenGL 3.3 target allocates the levels one by one
+    for (size_t level = 0; level < image.levels.size(); level++) {
+        const ImageLevel& data = image.levels[level];
+        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(GL_RGBA8),
+                     static_cast<GLsizei>(data.width), static_cast<GLsizei>(data.height), 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     data.texels.data());
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(image.levels.size() - 1));
+#endif
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(GL_LINEAR_MIPMAP_LINEAR));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(GL_LINEAR));
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+/**************************************************************************************************/
+
+std::future<std::shared_ptr<const Texture>> LoadTextureAsync(const std::filesystem::path& assetpath)
+{
+    return system::AssetLoader::current().Async([assetpath] {
+        auto& assets = system::AssetManager::current();
+        TextureTimings timings{};
+        Image image;
+
+        // the pre-processed texture is uploaded in place, the blob keeps it alive until then
+        auto start = clock::now();
+        std::shared_ptr<const system::Blob> blob;
+        if (assetpath.extension() == kPreprocessedTextureExtension) {
+            blob = assets.Load(assetpath);
+            if (not blob) {
+                throw std::runtime_error("Failed to open asset " + assetpath.string());
+            }
+            image = ParseTexture(blob->Bytes());
+            timings.read_ms = ElapsedMs(start);
+            timings.preprocessed = true;
+        }
+        else {
+            // decoded once, no point in caching the encoded image
+            auto asset = assets.Open(assetpath);
+            if (not asset) {
+                throw std::runtime_error("Failed to open asset " + assetpath.string());
+            }
+            const auto bytes = asset->Bytes();
+            timings.read_ms = ElapsedMs(start);
+            start = clock::now();
+            image = DecodeImage(bytes);
+            timings.decode_ms = ElapsedMs(start);
+            start = clock::now();
+            GenerateMips(image);
+            timings.mip_ms = ElapsedMs(start);
+        }
+
+        return [assetpath, blob = std::move(blob), image = std::move(image), timings]() mutable {
+            const auto start = clock::now();
+            auto texture = UploadTexture(image);
+            timings.upload_ms = ElapsedMs(start);
+            texture->timings = timings;
+            DEBUG("Loaded texture {} {}x{} ({} levels{}): read {:.3f} ms, decode {:.3f} ms, mips {:.3f} ms, "
+                  "upload {:.3f} ms",
+                  assetpath.string(), texture->width, texture->height, texture->num_levels,
+                  timings.preprocessed ? ", pre-processed" : "", timings.read_ms, timings.decode_ms, timings.mip_ms,
+                  timings.upload_ms);
+            return std::shared_ptr<const Texture>(std::move(texture));
+        };
+    });
+}
+
+}  // namespace firstgame::render
@@ -0,0 +1,46 @@
+#ifndef FIRSTGAME_RENDER_TEXTURE_LOADER_H_
+#define FIRSTGAME_RENDER_TEXTURE_LOADER_H_
+
+#include <future>
+#include <memory>
+#include <cstdint>
+#include <filesystem>
+
+#include "image.h"
+#include "firstgame/opengl/texture.h"
+
+namespace firstgame::render {
+
+/// Time spent in each step of a texture load
+struct TextureTimings {
+    float read_ms;      ///< reading or mapping the file
+    float decode_ms;    ///< decoding the image, zero if pre-processed
+    float mip_ms;       ///< generating the mip chain, zero if pre-processed
+    float upload_ms;    ///< uploading the levels on the GL thread
+    bool preprocessed;  ///< loaded from the pre-processed texture, skipping decode and mip generation
+};
+
+/// Texture uploaded to GPU with its full mip chain
+struct Texture final {
+    opengl::Texture id{};
+    uint32_t width{};
+    uint32_t height{};
+    uint32_t num_levels{};
+    TextureTimings timings{};
+};
+
+/// Extension of the pre-processed textures, built offline from images by the texture tool
+inline constexpr char kPreprocessedTextureExtension[] = ".fgtex";
+
+/// Upload an image and its mip levels to a new texture, with trilinear filtering. Must be called on the GL thread.
+std::shared_ptr<Texture> UploadTexture(const Image& image);
+
+/// Load a texture in the background with the AssetLoader. A pre-processed texture is uploaded in place, skipping
+/// decode entirely; any other image is decoded and has its mips generated on a loader thread, so several textures
+/// decode in parallel.
+/// The levels are uploaded on the GL thread, and the timings of every step are logged and kept in the texture.
+std::future<std::shared_ptr<const Texture>> LoadTextureAsync(const std::filesystem::path& assetpath);
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_TEXTURE_LOADER_H_
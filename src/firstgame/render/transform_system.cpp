@@ -0,0 +1,36 @@
+#include "transform_system.h"
+
+#include <entt/entity/registry.hpp>
+
+#include "transform.h"
+#include "world_matrix.h"
+#include "firstgame/system/log.h"
+
+namespace firstgame::render {
+
+/**************************************************************************************************/
+
+TransformSystem::TransformSystem(entt::registry& registry)
+    : dirty_(registry, entt::collector.group<Transform>().update<Transform>())
+{
+    // the observer only sees changes from now on, so cache the entities that already exist
+    registry.view<const Transform>().each([&](entt::entity entity, const Transform& transform) {
+        registry.emplace_or_replace<WorldMatrix>(entity, ComposeWorldMatrix(transform));
+    });
+}
+
+/**************************************************************************************************/
+
+void TransformSystem::Update(entt::registry& registry)
+{
+    PROFILE_ZONE("TransformSystem");
+    num_recomputed_ = 0;
+    dirty_.each([&](entt::entity entity) {
+        if (const auto* transform = registry.try_get<Transform>(entity)) {
+            registry.emplace_or_replace<WorldMatrix>(entity, ComposeWorldMatrix(*transform));
+            num_recomputed_++;
+        }
+    });
+}
+
+}  // namespace firstgame::render
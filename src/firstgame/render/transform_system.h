@@ -0,0 +1,31 @@
+#ifndef FIRSTGAME_RENDER_TRANSFORM_SYSTEM_H_
+#define FIRSTGAME_RENDER_TRANSFORM_SYSTEM_H_
+
+#include <entt/entity/fwd.hpp>
+#include <entt/entity/observer.hpp>
+
+namespace firstgame::render {
+
+/// TransformSystem maintains the WorldMatrix cache of entities whose Transform changed.
+/// Changes are tracked by an observer of Transform construction and updates, so Transforms must be
+/// modified through the registry (`registry.patch<Transform>()`, `replace` or `emplace_or_replace`)
+/// for the cache to notice. Entities that did not change cost nothing per frame.
+/// Moving entities are the exception: their cache is refreshed by the MotionSystem as it integrates them.
+class TransformSystem final {
+   public:
+    explicit TransformSystem(entt::registry& registry);
+
+    /// Recompute the WorldMatrix of entities whose Transform changed since the last update
+    void Update(entt::registry& registry);
+
+    /// Number of world matrices recomputed in the last update
+    [[nodiscard]] size_t NumRecomputed() const { return num_recomputed_; }
+
+   private:
+    entt::observer dirty_;
+    size_t num_recomputed_ = 0;
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_TRANSFORM_SYSTEM_H_
@@ -0,0 +1,30 @@
+#ifndef FIRSTGAME_RENDER_WORLD_MATRIX_H_
+#define FIRSTGAME_RENDER_WORLD_MATRIX_H_
+
+#include <glm/mat4x4.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "transform.h"
+
+namespace firstgame::render {
+
+/// WorldMatrix Component caches the model matrix composed from the entity's Transform.
+/// It is kept up to date by the TransformSystem (for Transforms changed through the registry)
+/// and by the MotionSystem (for moving entities), so that static entities cost no matrix math per frame.
+struct WorldMatrix final {
+    glm::mat4 model;
+};
+
+/// Compose the model matrix of a Transform
+inline glm::mat4 ComposeWorldMatrix(const Transform& transform)
+{
+    glm::mat4 translation = glm::translate(glm::mat4(1.0f), transform.position);
+    glm::mat4 rotation = glm::toMat4(transform.rotation);
+    glm::mat4 scale = glm::scale(glm::mat4(1.0f), transform.scale);
+    return translation * rotation * scale;
+}
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_WORLD_MATRIX_H_
@@ -0,0 +1,373 @@
+#include "world_streamer.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <unordered_set>
+#include <entt/entity/registry.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "painter.h"
+#include "mesh_loader.h"
+#include "shader_lib.h"
+#include "spatial_proxy.h"
+#include "world_matrix.h"
+#include "firstgame/system/log.h"
+#include "firstgame/system/asset_loader.h"
+#include "firstgame/util/frame_arena.h"
+
+namespace firstgame::render {
+
+using mesh_format::PackedVertex;
+
+// Each component is stored densely along with the entity, plus a sparse entry per entity
+const size_t WorldStreamer::kEntityBytes = sizeof(Transform) + sizeof(WorldMatrix) + sizeof(Renderable) +
+                                           sizeof(SpatialProxy) + 4 * 2 * sizeof(entt::entity) + sizeof(entt::entity);
+
+/**************************************************************************************************/
+
+/// Height of the terrain at a world position, continuous so that tiles meet seamlessly
+static float TerrainHeight(float x, float z)
+{
+    return -6.0f + 1.5f * std::sin(0.15f * x) * std::cos(0.11f * z) + 0.5f * std::sin(0.37f * (x + z));
+}
+
+/// Next number of the SplitMix64 sequence
+static uint64_t SplitMix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/// Uniform number in [0, 1)
+static float Uniform(uint64_t& state)
+{
+    return float(SplitMix64(state) >> 40) / float(1 << 24);
+}
+
+static uint8_t PackUnorm(float value)
+{
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+CellData GenerateCell(CellCoord coord, float cell_size)
+{
+    static constexpr int kSegments = 16;
+    const float step = cell_size / kSegments;
+    const float origin_x = float(coord.x) * cell_size;
+    const float origin_z = float(coord.z) * cell_size;
+
+    CellData data;
+    data.vertices.reserve((kSegments + 1) * (kSegments + 1));
+    float min_height = std::numeric_limits<float>::max();
+    float max_height = std::numeric_limits<float>::lowest();
+    for (int i = 0; i <= kSegments; i++) {
+        for (int j = 0; j <= kSegments; j++) {
+            const float x = float(i) * step;
+            const float z = float(j) * step;
+            const float height = TerrainHeight(origin_x + x, origin_z + z);
+            const float shade = (height + 8.0f) / 4.0f;  // 0 in valleys to 1 on crests
+            PackedVertex& vertex = data.vertices.emplace_back();
+            vertex.position[0] = glm::packHalf1x16(x);
+            vertex.position[1] = glm::packHalf1x16(height);
+            vertex.position[2] = glm::packHalf1x16(z);
+            vertex.position[3] = 0;
+            vertex.color[0] = PackUnorm(0.25f + 0.35f * shade);
+            vertex.color[1] = PackUnorm(0.45f + 0.15f * shade);
+            vertex.color[2] = PackUnorm(0.20f);
+            vertex.color[3] = 255;
+            min_height = std::min(min_height, height);
+            max_height = std::max(max_height, height);
+        }
+    }
+    data.indices.reserve(kSegments * kSegments * 6);
+    for (int i = 0; i < kSegments; i++) {
+        for (int j = 0; j < kSegments; j++) {
+            const auto a = static_cast<uint16_t>(i * (kSegments + 1) + j);
+            const auto b = static_cast<uint16_t>(a + kSegments + 1);
+            data.indices.insert(data.indices.end(), { a, uint16_t(a + 1), b, b, uint16_t(a + 1), uint16_t(b + 1) });
+        }
+    }
+    const float half_size = cell_size * 0.5f;
+    const float half_height = (max_height - min_height) * 0.5f;
+    data.bounds = glm::vec4(half_size, min_height + half_height, half_size,
+                            std::sqrt(2.0f * half_size * half_size + half_height * half_height));
+
+    // scatter cubes on the tile, seeded by the cell so it is the same every time it is loaded
+    uint64_t state = (uint64_t(uint32_t(coord.x)) << 32) | uint32_t(coord.z);
+    const auto num_objects = 2 + SplitMix64(state) % 6;
+    for (uint64_t k = 0; k < num_objects; k++) {
+        const float x = origin_x + Uniform(state) * cell_size;
+        const float z = origin_z + Uniform(state) * cell_size;
+        const float scale = 0.3f + 0.5f * Uniform(state);
+        data.objects.push_back(Transform{
+            .position = glm::vec3(x, TerrainHeight(x, z) + scale, z),
+            .scale = glm::vec3(scale),
+            .rotation = glm::angleAxis(Uniform(state) * 6.2831853f, glm::vec3(0.0f, 1.0f, 0.0f)),
+        });
+    }
+    return data;
+}
+
+/**************************************************************************************************/
+
+WorldStreamer::WorldStreamer(StreamingConfig config, CellSource source)
+    : config_(config), source_(std::move(source))
+{
+    auto& shaders = ShaderLibrary::current();
+    object_loading_ = system::AssetLoader::current().Async(
+        [] { return [] { return GenerateCube(ShaderLibrary::current().get(MyShader::SIMPLE)); }; },
+        shaders.loading(MyShader::SIMPLE));
+}
+
+WorldStreamer::~WorldStreamer() = default;
+
+/**************************************************************************************************/
+
+CellCoord WorldStreamer::CellAt(const glm::vec3& position) const
+{
+    return CellCoord{
+        .x = static_cast<int32_t>(std::floor(position.x / config_.cell_size)),
+        .z = static_cast<int32_t>(std::floor(position.z / config_.cell_size)),
+    };
+}
+
+/**************************************************************************************************/
+
+void WorldStreamer::Update(entt::registry& registry, const glm::vec3& camera_position)
+{
+    PROFILE_ZONE("WorldStreamer");
+    // objects of all cells share the cube mesh, wait for it before streaming any cell
+    if (object_loading_.valid()) {
+        if (object_loading_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        try {
+            object_ = object_loading_.get();
+        }
+        catch (const std::exception& e) {
+            ERROR("Failed to load the mesh of streamed objects: {}", e.what());
+        }
+    }
+
+    AttachLoaded(registry);
+
+    // retire the meshes of the dropped loads as they complete
+    for (auto it = dropped_.begin(); it != dropped_.end();) {
+        if (it->wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+        try {
+            retired_.push_back(it->get().tile.mesh);
+        }
+        catch (const std::exception&) {
+            // nothing to release
+        }
+        it = dropped_.erase(it);
+    }
+
+    // candidate cells, nearest first, up to the margin beyond the radius
+    const float cell_size = config_.cell_size;
+    const float reach = config_.radius + cell_size;
+    const int32_t range = static_cast<int32_t>(std::ceil(reach / cell_size));
+    const CellCoord center = CellAt(camera_position);
+    candidates_.clear();
+    for (int32_t x = center.x - range; x <= center.x + range; x++) {
+        for (int32_t z = center.z - range; z <= center.z + range; z++) {
+            const float dx = (float(x) + 0.5f) * cell_size - camera_position.x;
+            const float dz = (float(z) + 0.5f) * cell_size - camera_position.z;
+            const float distance = std::sqrt(dx * dx + dz * dz);
+            if (distance <= reach) {
+                candidates_.emplace_back(distance, CellCoord{ .x = x, .z = z });
+            }
+        }
+    }
+    std::sort(candidates_.begin(), candidates_.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    // keep the nearest cells fitting the budgets, estimating the cells not resident yet from the resident ones
+    size_t num_resident = 0;
+    size_t resident_cpu = 0;
+    size_t resident_gpu = 0;
+    for (const auto& [key, cell] : cells_) {
+        if (not cell.loading.valid()) {
+            num_resident++;
+            resident_cpu += cell.cpu_bytes;
+            resident_gpu += cell.gpu_bytes;
+        }
+    }
+    const size_t estimate_cpu = num_resident ? resident_cpu / num_resident : 0;
+    const size_t estimate_gpu = num_resident ? resident_gpu / num_resident : 0;
+    // per-update scratch, from the frame arena
+    std::pmr::memory_resource* arena = util::FrameArena::current().Resource();
+    std::pmr::vector<CellCoord> kept(arena);
+    std::pmr::vector<CellCoord> missing(arena);
+    size_t cpu_bytes = 0;
+    size_t gpu_bytes = 0;
+    for (const auto& [distance, coord] : candidates_) {
+        const auto it = cells_.find(Key(coord));
+        const bool resident = it != cells_.end() && not it->second.loading.valid();
+        const size_t cell_cpu = resident ? it->second.cpu_bytes : estimate_cpu;
+        const size_t cell_gpu = resident ? it->second.gpu_bytes : estimate_gpu;
+        if (cpu_bytes + cell_cpu > config_.cpu_budget || gpu_bytes + cell_gpu > config_.gpu_budget) {
+            break;
+        }
+        cpu_bytes += cell_cpu;
+        gpu_bytes += cell_gpu;
+        kept.push_back(coord);
+        if (it == cells_.end() && distance <= config_.radius) {
+            missing.push_back(coord);
+        }
+    }
+
+    UnloadUnwanted(registry, kept);
+
+    // request the missing cells, nearest first, without flooding the loader
+    size_t in_flight = dropped_.size();
+    for (const auto& [key, cell] : cells_) {
+        in_flight += cell.loading.valid() ? 1 : 0;
+    }
+    for (const CellCoord coord : missing) {
+        if (in_flight >= config_.max_loads) {
+            break;
+        }
+        RequestLoad(coord);
+        in_flight++;
+    }
+
+    // stats
+    stats_.resident_cells = 0;
+    stats_.loading_cells = 0;
+    stats_.cpu_bytes = 0;
+    stats_.gpu_bytes = 0;
+    for (const auto& [key, cell] : cells_) {
+        if (cell.loading.valid()) {
+            stats_.loading_cells++;
+            continue;
+        }
+        stats_.resident_cells++;
+        stats_.cpu_bytes += cell.cpu_bytes;
+        stats_.gpu_bytes += cell.gpu_bytes;
+    }
+}
+
+/**************************************************************************************************/
+
+void WorldStreamer::AttachLoaded(entt::registry& registry)
+{
+    for (auto& [key, cell] : cells_) {
+        if (not cell.loading.valid() || cell.loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            continue;
+        }
+        LoadedCell loaded;
+        try {
+            loaded = cell.loading.get();
+        }
+        catch (const std::exception& e) {
+            // left resident and empty, so it is not requested again every frame
+            ERROR("Failed to load cell ({}, {}): {}", cell.coord.x, cell.coord.z, e.what());
+            continue;
+        }
+
+        const auto tile = registry.create();
+        registry.emplace<Transform>(tile, Transform{
+                                              .position = glm::vec3(float(cell.coord.x) * config_.cell_size, 0.0f,
+                                                                    float(cell.coord.z) * config_.cell_size),
+                                              .scale = glm::vec3(1.0f),
+                                              .rotation = glm::quat(1.0f, glm::vec3(0.0f)),
+                                          });
+        registry.emplace<Renderable>(tile, loaded.tile);
+        cell.entities.push_back(tile);
+        if (object_.mesh) {
+            for (const Transform& transform : loaded.objects) {
+                const auto object = registry.create();
+                registry.emplace<Transform>(object, transform);
+                registry.emplace<Renderable>(object, object_);
+                cell.entities.push_back(object);
+            }
+        }
+        cell.mesh = std::move(loaded.tile.mesh);
+        cell.cpu_bytes = cell.entities.size() * kEntityBytes;
+        cell.gpu_bytes = loaded.gpu_bytes;
+
+        const float load_ms = std::chrono::duration<float, std::milli>(clock::now() - cell.requested).count();
+        stats_.loads++;
+        stats_.last_load_ms = load_ms;
+        stats_.avg_load_ms += (load_ms - stats_.avg_load_ms) / float(stats_.loads);
+        stats_.max_load_ms = std::max(stats_.max_load_ms, load_ms);
+    }
+}
+
+/**************************************************************************************************/
+
+void WorldStreamer::UnloadUnwanted(entt::registry& registry, const std::pmr::vector<CellCoord>& kept)
+{
+    std::pmr::unordered_set<uint64_t> kept_keys(kept.get_allocator().resource());
+    kept_keys.reserve(kept.size());
+    for (const CellCoord coord : kept) {
+        kept_keys.insert(Key(coord));
+    }
+    for (auto it = cells_.begin(); it != cells_.end();) {
+        if (kept_keys.count(it->first)) {
+            ++it;
+            continue;
+        }
+        Cell& cell = it->second;
+        if (cell.loading.valid()) {
+            dropped_.push_back(std::move(cell.loading));
+        }
+        else {
+            for (const entt::entity entity : cell.entities) {
+                if (registry.valid(entity)) {
+                    registry.destroy(entity);
+                }
+            }
+            if (cell.mesh) {
+                retired_.push_back(std::move(cell.mesh));
+            }
+            stats_.unloads++;
+        }
+        it = cells_.erase(it);
+    }
+}
+
+/**************************************************************************************************/
+
+void WorldStreamer::RequestLoad(CellCoord coord)
+{
+    Cell& cell = cells_[Key(coord)];
+    cell.coord = coord;
+    cell.requested = clock::now();
+    cell.loading = system::AssetLoader::current().Async(
+        [source = source_, coord, cell_size = config_.cell_size] {
+            CellData data = source(coord, cell_size);
+            if (data.vertices.size() > std::numeric_limits<uint16_t>::max() + 1u ||
+                data.indices.size() > std::numeric_limits<unsigned short>::max()) {
+                throw std::runtime_error("Cell tile does not fit a mesh");
+            }
+            return [data = std::move(data)]() mutable {
+                const MeshData mesh{ .vertices = data.vertices, .indices = data.indices, .bounds = data.bounds };
+                return LoadedCell{
+                    .tile = Renderable{ UploadMesh(ShaderLibrary::current().get(MyShader::SIMPLE), mesh) },
+                    .objects = std::move(data.objects),
+                    .gpu_bytes = mesh.vertices.size_bytes() + mesh.indices.size_bytes(),
+                };
+            };
+        },
+        ShaderLibrary::current().loading(MyShader::SIMPLE));
+}
+
+/**************************************************************************************************/
+
+void WorldStreamer::ReleaseRetired()
+{
+    retired_.clear();
+}
+
+}  // namespace firstgame::render
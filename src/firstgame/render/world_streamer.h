@@ -0,0 +1,148 @@
+#ifndef FIRSTGAME_RENDER_WORLD_STREAMER_H_
+#define FIRSTGAME_RENDER_WORLD_STREAMER_H_
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <unordered_map>
+#include <entt/entity/fwd.hpp>
+#include <entt/entity/entity.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "mesh.h"
+#include "mesh_format.h"
+#include "renderable.h"
+#include "transform.h"
+
+namespace firstgame::render {
+
+/// Coordinates of a cell in the grid the world is split into, on the XZ plane
+struct CellCoord {
+    int32_t x;
+    int32_t z;
+
+    bool operator==(const CellCoord& other) const { return x == other.x && z == other.z; }
+};
+
+/// Content of a cell, generated or read on a loader thread: a terrain tile and the objects placed on it
+struct CellData {
+    std::vector<mesh_format::PackedVertex> vertices;  ///< tile vertices, relative to the cell origin
+    std::vector<uint16_t> indices;
+    glm::vec4 bounds{};                               ///< bounding sphere of the tile in cell space (xyz: center, w: radius)
+    std::vector<Transform> objects;                   ///< world transforms of the objects, drawn with a shared cube mesh
+};
+
+/// Produces the content of a cell, called on loader threads so it must be thread-safe
+using CellSource = std::function<CellData(CellCoord coord, float cell_size)>;
+
+/// Generate the content of a cell procedurally: a rolling terrain tile, seamless across cells, and a few cubes
+/// scattered on it. Deterministic, the same cell always gets the same content.
+CellData GenerateCell(CellCoord coord, float cell_size);
+
+/// Streaming settings, the budgets bound the memory of the resident cells
+struct StreamingConfig {
+    float cell_size = 16.0f;              ///< side of a cell in world units
+    float radius = 64.0f;                 ///< cells within this distance of the camera are loaded
+    size_t cpu_budget = 2 * 1024 * 1024;  ///< bytes of entity components of the resident cells
+    size_t gpu_budget = 1024 * 1024;      ///< bytes of vertex and index buffers of the resident cells
+    unsigned int max_loads = 4;           ///< cells loading at once, bounds the loader queue
+};
+
+/// Streaming statistics, updated every frame
+struct StreamingStats {
+    unsigned int resident_cells;
+    unsigned int loading_cells;
+    size_t cpu_bytes;    ///< of the resident cells
+    size_t gpu_bytes;    ///< of the resident cells
+    uint64_t loads;      ///< cells loaded so far
+    uint64_t unloads;    ///< cells unloaded so far
+    float last_load_ms;  ///< from request to entities created, of the last cell loaded
+    float avg_load_ms;
+    float max_load_ms;
+};
+
+/// WorldStreamer keeps the cells of the world around the camera resident, within memory budgets.
+/// The world is a grid of cells, each one a batch of entities along with their GPU meshes. Cells entering the
+/// streaming radius are loaded in the background with the AssetLoader, nearest first, their content produced on a
+/// loader thread and their tile mesh uploaded on the GL thread. Once loaded, their entities are created in the
+/// registry. Cells leaving the radius, or the farthest ones when over budget, are unloaded by destroying their
+/// entities. A margin of one cell beyond the radius keeps cells on the boundary from loading and unloading repeatedly.
+///
+/// Update() runs with the simulation, possibly off the GL thread. The meshes of unloaded cells are therefore not
+/// released there, but retired, then released by ReleaseRetired() on the GL thread.
+class WorldStreamer final {
+   public:
+    explicit WorldStreamer(StreamingConfig config = {}, CellSource source = GenerateCell);
+    ~WorldStreamer();
+    WorldStreamer(const WorldStreamer&) = delete;
+    WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+    /// Attach the loaded cells, unload the cells no longer wanted and request the missing ones around the camera
+    void Update(entt::registry& registry, const glm::vec3& camera_position);
+
+    /// Release the GPU meshes of unloaded cells. Must be called on the GL thread, while Update() is not running.
+    void ReleaseRetired();
+
+    [[nodiscard]] const StreamingConfig& Config() const { return config_; }
+    [[nodiscard]] const StreamingStats& Stats() const { return stats_; }
+
+    /// Cell containing a world position
+    [[nodiscard]] CellCoord CellAt(const glm::vec3& position) const;
+
+   private:
+    using clock = std::chrono::steady_clock;
+
+    /// Cell content once uploaded
+    struct LoadedCell {
+        Renderable tile;
+        std::vector<Transform> objects;
+        size_t gpu_bytes;
+    };
+
+    /// Cell loading or resident
+    struct Cell {
+        CellCoord coord;
+        std::future<LoadedCell> loading;  ///< valid while loading
+        clock::time_point requested;
+        std::vector<entt::entity> entities;
+        std::shared_ptr<const Mesh> mesh;
+        size_t cpu_bytes = 0;
+        size_t gpu_bytes = 0;
+    };
+
+    /// Create the entities of the cells whose load completed
+    void AttachLoaded(entt::registry& registry);
+
+    /// Unload the resident cells that are not kept, and drop the loads of the loading ones
+    void UnloadUnwanted(entt::registry& registry, const std::pmr::vector<CellCoord>& kept);
+
+    /// Request the load of a cell
+    void RequestLoad(CellCoord coord);
+
+    /// Key of a cell in the map
+    static uint64_t Key(CellCoord coord) { return (uint64_t(uint32_t(coord.x)) << 32) | uint32_t(coord.z); }
+
+   private:
+    /// Estimate of the components of an entity, Transform, WorldMatrix, Renderable, SpatialProxy and storage
+    static const size_t kEntityBytes;
+
+   private:
+    StreamingConfig config_;
+    CellSource source_;
+    std::future<Renderable> object_loading_;  ///< cube mesh shared by the objects of all cells
+    Renderable object_;
+    std::unordered_map<uint64_t, Cell> cells_;
+    std::vector<std::future<LoadedCell>> dropped_;  ///< loads of cells no longer wanted, still in flight
+    std::vector<std::shared_ptr<const Mesh>> retired_;
+    std::vector<std::pair<float, CellCoord>> candidates_;  ///< per-update scratch, kept for its allocation
+    StreamingStats stats_{};
+};
+
+}  // namespace firstgame::render
+
+#endif  // FIRSTGAME_RENDER_WORLD_STREAMER_H_
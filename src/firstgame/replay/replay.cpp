@@ -0,0 +1,310 @@
+#include "firstgame/replay/replay.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+#include "firstgame/util/overloaded.h"
+
+namespace firstgame::replay {
+
+/// Layout of the binary recording (.fgreplay), little-endian:
+///
+///     | ReplayHeader | Tag | payload | Tag | payload | ...
+///
+/// Records are not aligned. Events are recorded as the tag of their type followed by their fields, and each frame
+/// ends with a FRAME tag followed by its float delta time, so the events of a frame precede its update.
+namespace replay_format {
+
+inline constexpr char kMagic[4] = { 'F', 'G', 'R', 'P' };
+inline constexpr uint32_t kVersion = 1;
+
+struct ReplayHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    uint32_t num_frames;
+};
+
+enum class Tag : uint8_t {
+    FRAME = 0,     ///< float deltatime
+    KEY = 1,       ///< int16_t key, uint8_t action
+    CURSOR = 2,    ///< double xpos, double ypos
+    MOUSE = 3,     ///< int8_t button, uint8_t action
+    SCROLL = 4,    ///< double xoffset, double yoffset
+    JOYSTICK = 5,  ///< nothing
+    WINDOW = 6,    ///< WindowKind, then int32_t width, int32_t height for a resize, or uint8_t value otherwise
+};
+
+enum class WindowKind : uint8_t {
+    RESIZE = 0,
+    FOCUS = 1,
+    IMIZE = 2,
+};
+
+}  // namespace replay_format
+
+using replay_format::ReplayHeader;
+using replay_format::Tag;
+using replay_format::WindowKind;
+
+/**************************************************************************************************/
+
+template<typename T>
+static void Append(std::vector<std::byte>& bytes, T value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    const size_t offset = bytes.size();
+    bytes.resize(offset + sizeof(T));
+    std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+template<typename T>
+static T Read(const std::vector<std::byte>& bytes, size_t& offset)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (bytes.size() - offset < sizeof(T)) {
+        throw std::runtime_error("Truncated recording");
+    }
+    T value;
+    std::memcpy(&value, bytes.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+}
+
+/// Append the record of an event
+static void AppendEvent(std::vector<std::byte>& bytes, const event::Event& event)
+{
+    std::visit(util::Overloaded{
+                   [&](const event::KeyEvent& key) {
+                       Append(bytes, Tag::KEY);
+                       Append(bytes, static_cast<int16_t>(key.key));
+                       Append(bytes, static_cast<uint8_t>(key.action));
+                   },
+                   [&](const event::CursorEvent& cursor) {
+                       Append(bytes, Tag::CURSOR);
+                       Append(bytes, cursor.xpos);
+                       Append(bytes, cursor.ypos);
+                   },
+                   [&](const event::MouseEvent& mouse) {
+                       Append(bytes, Tag::MOUSE);
+                       Append(bytes, static_cast<int8_t>(mouse.button));
+                       Append(bytes, static_cast<uint8_t>(mouse.action));
+                   },
+                   [&](const event::ScrollEvent& scroll) {
+                       Append(bytes, Tag::SCROLL);
+                       Append(bytes, scroll.xoffset);
+                       Append(bytes, scroll.yoffset);
+                   },
+                   [&](const event::JoystickEvent&) { Append(bytes, Tag::JOYSTICK); },
+                   [&](const event::WindowEvent& window_event) {
+                       Append(bytes, Tag::WINDOW);
+                       std::visit(util::Overloaded{
+                                      [&](const event::WindowEvent::Resize& resize) {
+                                          Append(bytes, WindowKind::RESIZE);
+                                          Append(bytes, static_cast<int32_t>(resize.width));
+                                          Append(bytes, static_cast<int32_t>(resize.height));
+                                      },
+                                      [&](const event::WindowEvent::Focus& focus) {
+                                          Append(bytes, WindowKind::FOCUS);
+                                          Append(bytes, static_cast<uint8_t>(focus));
+                                      },
+                                      [&](const event::WindowEvent::Imize& imize) {
+                                          Append(bytes, WindowKind::IMIZE);
+                                          Append(bytes, static_cast<uint8_t>(imize));
+                                      },
+                                  },
+                                  window_event.variant);
+                   },
+               },
+               event);
+}
+
+/// Decode the record at the offset into an event, or into the delta time of a frame. Returns true if it ends a
+/// frame. Throws std::runtime_error if the record is malformed.
+static bool ReadRecord(const std::vector<std::byte>& bytes, size_t& offset, event::Event& event, float& deltatime)
+{
+    switch (Read<Tag>(bytes, offset)) {
+        case Tag::FRAME:
+            deltatime = Read<float>(bytes, offset);
+            return true;
+        case Tag::KEY: {
+            const auto key = static_cast<input::Key>(Read<int16_t>(bytes, offset));
+            event = event::KeyEvent{ key, static_cast<input::KeyAction>(Read<uint8_t>(bytes, offset)) };
+            return false;
+        }
+        case Tag::CURSOR: {
+            const auto xpos = Read<double>(bytes, offset);
+            event = event::CursorEvent{ xpos, Read<double>(bytes, offset) };
+            return false;
+        }
+        case Tag::MOUSE: {
+            const auto button = static_cast<input::MouseButton>(Read<int8_t>(bytes, offset));
+            event = event::MouseEvent{ button, static_cast<input::MouseAction>(Read<uint8_t>(bytes, offset)) };
+            return false;
+        }
+        case Tag::SCROLL: {
+            const auto xoffset = Read<double>(bytes, offset);
+            event = event::ScrollEvent{ xoffset, Read<double>(bytes, offset) };
+            return false;
+        }
+        case Tag::JOYSTICK:
+            event = event::JoystickEvent{};
+            return false;
+        case Tag::WINDOW:
+            switch (Read<WindowKind>(bytes, offset)) {
+                case WindowKind::RESIZE: {
+                    const auto width = Read<int32_t>(bytes, offset);
+                    event = event::WindowEvent{ event::WindowEvent::Resize{ width, Read<int32_t>(bytes, offset) } };
+                    return false;
+                }
+                case WindowKind::FOCUS:
+                    event = event::WindowEvent{ static_cast<event::WindowEvent::Focus>(Read<uint8_t>(bytes, offset)) };
+                    return false;
+                case WindowKind::IMIZE:
+                    event = event::WindowEvent{ static_cast<event::WindowEvent::Imize>(Read<uint8_t>(bytes, offset)) };
+                    return false;
+            }
+            break;
+    }
+    throw std::runtime_error("Unknown record in recording");
+}
+
+/**************************************************************************************************/
+
+Recorder::Recorder(std::unique_ptr<FirstGame> game, int width, int height,
+                   std::shared_ptr<platform::FileSystem> filesystem, std::filesystem::path path)
+    : game_(std::move(game)), filesystem_(std::move(filesystem)), path_(std::move(path))
+{
+    bytes_.reserve(1 << 20);  // minutes of input, so that recording seldom reallocates
+    ReplayHeader header{
+        .magic = {},
+        .version = replay_format::kVersion,
+        .width = width,
+        .height = height,
+        .num_frames = 0,
+    };
+    std::memcpy(header.magic, replay_format::kMagic, sizeof(header.magic));
+    Append(bytes_, header);
+    frame_end_ = bytes_.size();
+}
+
+Recorder::~Recorder()
+{
+    Save();
+}
+
+void Recorder::Update(float deltatime)
+{
+    Append(bytes_, Tag::FRAME);
+    Append(bytes_, deltatime);
+    num_frames_++;
+    frame_end_ = bytes_.size();
+    game_->Update(deltatime);
+}
+
+void Recorder::OnImGuiRender()
+{
+    game_->OnImGuiRender();
+}
+
+void Recorder::OnEvent(const event::Event& event)
+{
+    AppendEvent(bytes_, event);
+    game_->OnEvent(event);
+}
+
+bool Recorder::Save()
+{
+    std::memcpy(bytes_.data() + offsetof(ReplayHeader, num_frames), &num_frames_, sizeof(num_frames_));
+    // events received after the last frame are left out, no update would follow them on replay
+    return filesystem_->Write(path_.c_str(), bytes_.data(), frame_end_);
+}
+
+/**************************************************************************************************/
+
+Player::Player(std::vector<std::byte> bytes) : bytes_(std::move(bytes)), offset_(0)
+{
+    const auto header = Read<ReplayHeader>(bytes_, offset_);
+    if (std::memcmp(header.magic, replay_format::kMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Not a recording");
+    }
+    if (header.version != replay_format::kVersion) {
+        throw std::runtime_error("Unsupported recording version " + std::to_string(header.version));
+    }
+    width_ = header.width;
+    height_ = header.height;
+    num_frames_ = header.num_frames;
+
+    uint32_t num_frames = 0;
+    for (size_t offset = offset_; offset < bytes_.size();) {
+        event::Event event;
+        float deltatime;
+        num_frames += ReadRecord(bytes_, offset, event, deltatime);
+    }
+    if (num_frames != num_frames_) {
+        throw std::runtime_error("Recording has " + std::to_string(num_frames) + " frames instead of " +
+                                 std::to_string(num_frames_));
+    }
+}
+
+auto Player::Load(platform::FileSystem& filesystem, const std::filesystem::path& path) -> Player
+{
+    const auto file = filesystem.Open(path.c_str());
+    if (not file) {
+        throw std::runtime_error("Failed to open recording " + path.string());
+    }
+    std::vector<std::byte> bytes;
+    if (const auto view = file->Map()) {
+        bytes.assign(view->data, view->data + view->size);
+    }
+    else {
+        const std::string content = file->ReadToString();
+        bytes.resize(content.size());
+        std::memcpy(bytes.data(), content.data(), content.size());
+    }
+    file->Close();
+    return Player(std::move(bytes));
+}
+
+float Player::Step(FirstGame& game)
+{
+    event::Event event;
+    float deltatime;
+    while (not ReadRecord(bytes_, offset_, event, deltatime)) {
+        game.OnEvent(event);
+    }
+    frame_++;
+    game.Update(deltatime);
+    return deltatime;
+}
+
+auto Player::Run(FirstGame& game, Pace pace, const std::function<void()>& end_frame) -> std::vector<float>
+{
+    using Clock = std::chrono::steady_clock;
+    std::vector<float> frame_ms;
+    frame_ms.reserve(num_frames_ - frame_);
+    const Clock::time_point start = Clock::now();
+    std::chrono::duration<double> recorded{ 0.0 };
+    while (not Done()) {
+        const Clock::time_point frame_start = Clock::now();
+        const float deltatime = Step(game);
+        frame_ms.push_back(std::chrono::duration<float, std::milli>(Clock::now() - frame_start).count());
+        if (end_frame) {
+            end_frame();
+        }
+        if (pace == Pace::Fixed) {
+            recorded += std::chrono::duration<double>(deltatime);
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(recorded));
+        }
+    }
+    return frame_ms;
+}
+
+}  // namespace firstgame::replay
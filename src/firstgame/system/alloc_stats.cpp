@@ -0,0 +1,150 @@
+#include "alloc_stats.h"
+
+#include <new>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+
+namespace firstgame::system {
+
+/**************************************************************************************************/
+
+#ifdef FIRSTGAME_ALLOC_STATS
+
+namespace {
+
+std::atomic<uint64_t> g_count{ 0 };
+std::atomic<uint64_t> g_bytes{ 0 };
+
+void* Allocate(std::size_t size, std::size_t alignment, bool nothrow)
+{
+    g_count.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    size = size ? size : 1;
+    void* ptr = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        ptr = std::malloc(size);
+    }
+    else {
+        // aligned_alloc() wants a size multiple of the alignment
+        ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+    if (not ptr && not nothrow) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+}  // namespace
+
+AllocCounters Allocations()
+{
+    return AllocCounters{
+        .count = g_count.load(std::memory_order_relaxed),
+        .bytes = g_bytes.load(std::memory_order_relaxed),
+    };
+}
+
+#else
+
+AllocCounters Allocations()
+{
+    return AllocCounters{ .count = 0, .bytes = 0 };
+}
+
+#endif
+
+}  // namespace firstgame::system
+
+/**************************************************************************************************/
+
+// Replacements of the global allocation functions, counting the allocations of the whole program. This object is
+// linked in along with Allocations(), which the Profiler references. Built with FIRSTGAME_ALLOC_STATS only, on by
+// default in Debug and benchmark builds, so that release builds keep the allocator of the standard library.
+#ifdef FIRSTGAME_ALLOC_STATS
+
+using firstgame::system::Allocate;
+
+void* operator new(std::size_t size)
+{
+    return Allocate(size, 0, false);
+}
+void* operator new[](std::size_t size)
+{
+    return Allocate(size, 0, false);
+}
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return Allocate(size, static_cast<std::size_t>(alignment), false);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return Allocate(size, static_cast<std::size_t>(alignment), false);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size, 0, true);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size, 0, true);
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return Allocate(size, static_cast<std::size_t>(alignment), true);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return Allocate(size, static_cast<std::size_t>(alignment), true);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
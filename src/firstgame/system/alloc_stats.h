@@ -0,0 +1,20 @@
+#ifndef FIRSTGAME_SYSTEM_ALLOC_STATS_H_
+#define FIRSTGAME_SYSTEM_ALLOC_STATS_H_
+
+#include <cstdint>
+
+namespace firstgame::system {
+
+/// Heap allocations made through operator new
+struct AllocCounters {
+    uint64_t count;  ///< number of allocations
+    uint64_t bytes;  ///< bytes requested
+};
+
+/// Allocations made since the program started, by all threads. Counted by replacing the global operator new when
+/// built with FIRSTGAME_ALLOC_STATS, always zero otherwise. Differences of two calls give the allocations in between.
+AllocCounters Allocations();
+
+}  // namespace firstgame::system
+
+#endif  // FIRSTGAME_SYSTEM_ALLOC_STATS_H_
@@ -2,6 +2,10 @@
 #define FIRSTGAME_SYSTEM_ASSET_H_
 
 #include <memory>
+#include <string>
+#include <optional>
+#include <string_view>
+#include <gsl/span>
 #include "log.h"
 #include "firstgame/platform/filesystem.h"
 
@@ -13,6 +17,30 @@ class Asset final {
     // Interface
     [[nodiscard]] auto ReadToString() -> std::string { return file_->ReadToString(); }
 
+    /// Read-only view of the whole content, valid while the asset is alive. The file is memory-mapped
+    /// when the platform supports it, so loaders parse straight from the page cache without any copy;
+    /// otherwise it is read once into a buffer owned by the asset.
+    [[nodiscard]] auto Bytes() -> gsl::span<const std::byte>
+    {
+        if (not mapping_ && not buffer_) {
+            mapping_ = file_->Map();
+            if (not mapping_) {
+                buffer_ = std::make_unique<std::string>(file_->ReadToString());
+            }
+        }
+        if (mapping_) {
+            return { mapping_->data, mapping_->size };
+        }
+        return { reinterpret_cast<const std::byte*>(buffer_->data()), buffer_->size() };
+    }
+
+    /// Content as text, same as Bytes()
+    [[nodiscard]] auto View() -> std::string_view
+    {
+        const auto bytes = Bytes();
+        return { reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+    }
+
     // Con/Destructor
     explicit Asset(std::unique_ptr<platform::File>&& file, std::filesystem::path path)
         : path_(std::move(path)), file_(std::move(file))
@@ -30,6 +58,9 @@ class Asset final {
    private:
     std::filesystem::path path_;
     std::unique_ptr<platform::File> file_;
+    std::optional<platform::FileView> mapping_;  ///< content mapped by the file
+    std::unique_ptr<std::string> buffer_;        ///< content read when it could not be mapped, kept on the heap
+                                                 ///< as Scoped<Asset> moves are bitwise
 };
 
 }  // namespace firstgame::system
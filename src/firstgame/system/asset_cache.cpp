@@ -0,0 +1,139 @@
+#include "asset_cache.h"
+
+#include <algorithm>
+
+#include "firstgame/util/hash.h"
+
+namespace firstgame::system {
+
+/**************************************************************************************************/
+
+auto AssetCache::Find(const std::string& key) -> std::shared_ptr<const Blob>
+{
+    std::lock_guard lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        stats_.misses++;
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    stats_.hits++;
+    return it->second.blob;
+}
+
+/**************************************************************************************************/
+
+auto AssetCache::Insert(const std::string& key, std::shared_ptr<const Blob> blob) -> std::shared_ptr<const Blob>
+{
+    // hash outside of the lock, it reads the whole content
+    const uint64_t hash = Hash(*blob);
+
+    std::lock_guard lock(mutex_);
+    auto& content = contents_[hash];
+    if (auto existing = content.lock()) {
+        const auto lhs = existing->Bytes();
+        const auto rhs = blob->Bytes();
+        if (existing != blob && std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end())) {
+            blob = std::move(existing);
+            stats_.dedups++;
+        }
+    }
+    else {
+        content = blob;
+    }
+
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        // loaded concurrently by another thread, or reloaded
+        Discharge(it->second.blob);
+        it->second.blob = blob;
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+    }
+    else {
+        lru_.push_front(key);
+        entries_.emplace(key, Entry{ blob, lru_.begin() });
+    }
+    Charge(blob);
+    Evict();
+    return blob;
+}
+
+/**************************************************************************************************/
+
+void AssetCache::Erase(const std::string& key)
+{
+    std::lock_guard lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return;
+    }
+    Discharge(it->second.blob);
+    lru_.erase(it->second.lru);
+    entries_.erase(it);
+}
+
+/**************************************************************************************************/
+
+void AssetCache::SetBudget(size_t budget)
+{
+    std::lock_guard lock(mutex_);
+    budget_ = budget;
+    Evict();
+}
+
+/**************************************************************************************************/
+
+AssetCacheStats AssetCache::Stats() const
+{
+    std::lock_guard lock(mutex_);
+    AssetCacheStats stats = stats_;
+    stats.entries = entries_.size();
+    return stats;
+}
+
+/**************************************************************************************************/
+
+uint64_t AssetCache::Hash(const Blob& blob)
+{
+    const auto bytes = blob.Bytes();
+    return util::Fnv1a(reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size());
+}
+
+/**************************************************************************************************/
+
+void AssetCache::Charge(const std::shared_ptr<const Blob>& blob)
+{
+    if (charges_[blob.get()]++ == 0) {
+        stats_.bytes += blob->Bytes().size();
+    }
+}
+
+void AssetCache::Discharge(const std::shared_ptr<const Blob>& blob)
+{
+    auto it = charges_.find(blob.get());
+    if (--it->second == 0) {
+        stats_.bytes -= blob->Bytes().size();
+        charges_.erase(it);
+    }
+}
+
+/**************************************************************************************************/
+
+void AssetCache::Evict()
+{
+    while (stats_.bytes > budget_ && not lru_.empty()) {
+        auto it = entries_.find(lru_.back());
+        Discharge(it->second.blob);
+        entries_.erase(it);
+        lru_.pop_back();
+        stats_.evictions++;
+    }
+    // forget the contents no longer alive, once in a while as they pile up
+    if (contents_.size() > 2 * entries_.size() + 64) {
+        for (auto it = contents_.begin(); it != contents_.end();) {
+            it = it->second.expired() ? contents_.erase(it) : std::next(it);
+        }
+    }
+}
+
+}  // namespace firstgame::system
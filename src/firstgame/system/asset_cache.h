@@ -0,0 +1,103 @@
+#ifndef FIRSTGAME_SYSTEM_ASSET_CACHE_H_
+#define FIRSTGAME_SYSTEM_ASSET_CACHE_H_
+
+#include <list>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <gsl/span>
+
+#include "asset.h"
+
+namespace firstgame::system {
+
+/// Blob is the immutable content of an asset, shared by all of its users and released with the last of them.
+class Blob final {
+   public:
+    /// Take over the asset, reading or mapping its content
+    explicit Blob(Asset&& asset) : asset_(std::move(asset)), bytes_(asset_.Bytes()) {}
+    Blob(const Blob&) = delete;
+    Blob& operator=(const Blob&) = delete;
+
+    /// Content of the asset
+    [[nodiscard]] gsl::span<const std::byte> Bytes() const { return bytes_; }
+
+    /// Content as text
+    [[nodiscard]] std::string_view View() const
+    {
+        return { reinterpret_cast<const char*>(bytes_.data()), bytes_.size() };
+    }
+
+   private:
+    Asset asset_;
+    gsl::span<const std::byte> bytes_;
+};
+
+/// Counters of the asset cache
+struct AssetCacheStats {
+    uint64_t hits;       ///< loads served from the cache
+    uint64_t misses;     ///< loads that opened the asset
+    uint64_t dedups;     ///< misses whose content matched a blob in use, which was shared instead
+    uint64_t evictions;  ///< entries dropped to stay under the budget
+    size_t entries;      ///< number of paths cached
+    size_t bytes;        ///< size of the distinct blobs cached
+};
+
+/// AssetCache keeps the blobs of recently loaded assets, keyed by path, and evicts the least recently used ones
+/// once their total size exceeds the budget. Evicted blobs stay alive as long as someone uses them, and blobs are
+/// also indexed by content hash, so loading the same content again, by any path, shares the blob in use.
+/// Thread-safe.
+class AssetCache final {
+   public:
+    explicit AssetCache(size_t budget) : budget_(budget) {}
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+    /// Find the blob of a path, moving it to the front of the LRU order
+    auto Find(const std::string& key) -> std::shared_ptr<const Blob>;
+
+    /// Insert the blob loaded for a path, returns the blob to use, which is a blob in use with the same content if any
+    auto Insert(const std::string& key, std::shared_ptr<const Blob> blob) -> std::shared_ptr<const Blob>;
+
+    /// Drop the blob of a path, e.g. after its file changed, so the next load reads it again
+    void Erase(const std::string& key);
+
+    /// Set the maximum size of the cached blobs, evicting the least recently used ones to fit
+    void SetBudget(size_t budget);
+    [[nodiscard]] size_t Budget() const { return budget_; }
+
+    /// Cache counters
+    [[nodiscard]] AssetCacheStats Stats() const;
+
+   private:
+    /// Content hash of a blob
+    static uint64_t Hash(const Blob& blob);
+
+    /// Add or remove a reference of the cache to a blob, counting its size once
+    void Charge(const std::shared_ptr<const Blob>& blob);
+    void Discharge(const std::shared_ptr<const Blob>& blob);
+
+    /// Evict entries from the back of the LRU order until under the budget
+    void Evict();
+
+   private:
+    struct Entry {
+        std::shared_ptr<const Blob> blob;
+        std::list<std::string>::iterator lru;  ///< position in the LRU order
+    };
+
+    mutable std::mutex mutex_;
+    size_t budget_;
+    std::list<std::string> lru_;  ///< keys from the most to the least recently used
+    std::unordered_map<std::string, Entry> entries_;
+    std::unordered_map<uint64_t, std::weak_ptr<const Blob>> contents_;  ///< blobs alive by content hash
+    std::unordered_map<const Blob*, unsigned int> charges_;             ///< number of cache entries of each blob
+    AssetCacheStats stats_{};
+};
+
+}  // namespace firstgame::system
+
+#endif  // FIRSTGAME_SYSTEM_ASSET_CACHE_H_
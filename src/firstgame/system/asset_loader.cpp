@@ -0,0 +1,114 @@
+#include "asset_loader.h"
+
+#include <algorithm>
+
+#include "log.h"
+
+namespace firstgame::system {
+
+/**************************************************************************************************/
+
+AssetLoader::AssetLoader(unsigned int num_threads)
+{
+    threads_.reserve(num_threads);
+    for (unsigned int index = 0; index < num_threads; index++) {
+        threads_.emplace_back(&AssetLoader::ThreadLoop, this);
+    }
+    TRACE("Initialized AssetLoader with {} threads", num_threads);
+}
+
+/**************************************************************************************************/
+
+AssetLoader::~AssetLoader()
+{
+    {
+        std::lock_guard lock(decode_mutex_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    // loads left behind are abandoned, their futures report a broken promise
+    TRACE("De-initialized AssetLoader, {} loads abandoned", NumPending());
+}
+
+/**************************************************************************************************/
+
+void AssetLoader::Upload(std::chrono::microseconds budget)
+{
+    PROFILE_ZONE("Upload assets");
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    stats_.uploads = 0;
+
+    std::unique_lock lock(upload_mutex_);
+    for (size_t i = 0; i < uploads_.size();) {
+        if (stats_.uploads && clock::now() - start >= budget) {
+            break;
+        }
+        const std::shared_future<void>& after = uploads_[i].after;
+        if (after.valid() && after.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            i++;
+            continue;
+        }
+        std::function<void()> upload = std::move(uploads_[i].upload);
+        uploads_.erase(uploads_.begin() + static_cast<std::ptrdiff_t>(i));
+        // new upload steps may be queued meanwhile, always at the back
+        lock.unlock();
+        {
+            PROFILE_ZONE("Upload asset");
+            upload();
+        }
+        lock.lock();
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        stats_.uploads++;
+    }
+    lock.unlock();
+
+    stats_.upload_ms = std::chrono::duration<float, std::milli>(clock::now() - start).count();
+    stats_.max_upload_ms = std::max(stats_.max_upload_ms, stats_.upload_ms);
+}
+
+/**************************************************************************************************/
+
+void AssetLoader::QueueDecode(std::function<void()> decode)
+{
+    {
+        std::lock_guard lock(decode_mutex_);
+        decodes_.push_back(std::move(decode));
+    }
+    wake_.notify_one();
+}
+
+/**************************************************************************************************/
+
+void AssetLoader::QueueUpload(std::function<void()> upload, std::shared_future<void> after)
+{
+    std::lock_guard lock(upload_mutex_);
+    uploads_.push_back({ std::move(upload), std::move(after) });
+}
+
+/**************************************************************************************************/
+
+void AssetLoader::ThreadLoop()
+{
+    Profiler::NameThread("loader");
+    std::unique_lock lock(decode_mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return quit_ || not decodes_.empty(); });
+        if (quit_) {
+            return;
+        }
+        std::function<void()> decode = std::move(decodes_.front());
+        decodes_.pop_front();
+        lock.unlock();
+        {
+            PROFILE_ZONE("Decode asset");
+            decode();
+        }
+        lock.lock();
+    }
+}
+
+}  // namespace firstgame::system
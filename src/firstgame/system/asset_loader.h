@@ -0,0 +1,163 @@
+#ifndef FIRSTGAME_SYSTEM_ASSET_LOADER_H_
+#define FIRSTGAME_SYSTEM_ASSET_LOADER_H_
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include <functional>
+#include <filesystem>
+#include <type_traits>
+#include <condition_variable>
+
+#include "asset_mgr.h"
+#include "firstgame/util/currenton.h"
+
+namespace firstgame::system {
+
+/// Upload statistics of the last frame
+struct LoaderStats {
+    unsigned int uploads;  ///< number of upload steps run
+    float upload_ms;       ///< time spent running upload steps
+    float max_upload_ms;   ///< longest upload time of any frame so far, the worst loading hitch
+};
+
+/// AssetLoader loads assets in the background, in two steps. The decode step, reading and parsing files, runs
+/// on a pool of loader threads. It returns the upload step, creating GL objects, which is queued to the thread
+/// owning the GL context and run from Upload() under a per-frame time budget, so loads neither block startup
+/// nor cause frame hitches. The result of the upload step is delivered through a future.
+/// An upload step may wait for another load to complete, e.g. a mesh that needs the shader of its vertex layout.
+/// Example:
+/// ```
+///  std::future<Texture> texture = loader.Load("textures"_path / "wall.png", [](Asset& asset) {
+///      Image image = Decode(asset.Bytes());
+///      return [image = std::move(image)] { return Texture(image); };
+///  });
+///  ...
+///  loader.Upload(std::chrono::milliseconds(2));  // every frame, on the GL thread
+/// ```
+class AssetLoader final : public util::Currenton<AssetLoader> {
+   public:
+    explicit AssetLoader(unsigned int num_threads = kDefaultNumThreads);
+    ~AssetLoader() override;
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    /// Run `decode()` on a loader thread, then the upload step it returns on the GL thread once `after` is ready.
+    /// The future holds the result of the upload step, or the exception thrown by either step.
+    template<typename Decode>
+    auto Async(Decode decode, std::shared_future<void> after = {});
+
+    /// Open the asset and run `decode(asset)` on a loader thread, then the upload step it returns on the GL thread.
+    /// The asset is closed once decoded, the upload step must own whatever it needs.
+    template<typename Decode>
+    auto Load(std::filesystem::path path, Decode decode, std::shared_future<void> after = {});
+
+    /// Run the queued upload steps that are ready, in order, until the time budget is spent.
+    /// Must be called on the GL thread, at least one upload step runs per call if any is ready.
+    void Upload(std::chrono::microseconds budget);
+
+    /// Number of loads not completed yet
+    [[nodiscard]] size_t NumPending() const { return pending_.load(std::memory_order_relaxed); }
+
+    /// Upload statistics of the last call to Upload()
+    [[nodiscard]] const LoaderStats& Stats() const { return stats_; }
+
+   private:
+    /// Queue a decode step to the loader threads
+    void QueueDecode(std::function<void()> decode);
+
+    /// Queue an upload step to the GL thread
+    void QueueUpload(std::function<void()> upload, std::shared_future<void> after);
+
+    /// Loader thread main loop
+    void ThreadLoop();
+
+   private:
+    /// Number of loader threads, loads are mostly bound by I/O
+    static constexpr unsigned int kDefaultNumThreads = 2;
+
+    /// Upload step waiting to run on the GL thread
+    struct PendingUpload {
+        std::function<void()> upload;
+        std::shared_future<void> after;  ///< dependency, no dependency when invalid
+    };
+
+   private:
+    std::vector<std::thread> threads_;
+    std::mutex decode_mutex_;
+    std::condition_variable wake_;  ///< signals loader threads of a new decode step or quit
+    std::deque<std::function<void()>> decodes_;
+    bool quit_ = false;
+    std::mutex upload_mutex_;
+    std::deque<PendingUpload> uploads_;
+    std::atomic<size_t> pending_{ 0 };
+    LoaderStats stats_{};
+};
+
+/**************************************************************************************************/
+
+template<typename Decode>
+auto AssetLoader::Async(Decode decode, std::shared_future<void> after)
+{
+    using UploadStep = std::invoke_result_t<Decode&>;
+    using Result = std::invoke_result_t<UploadStep&>;
+
+    // steps are shared, as std::function requires copyable callables and upload steps may own move-only data
+    auto promise = std::make_shared<std::promise<Result>>();
+    auto future = promise->get_future();
+    auto shared_decode = std::make_shared<Decode>(std::move(decode));
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    QueueDecode([this, promise, shared_decode, after = std::move(after)] {
+        std::shared_ptr<UploadStep> upload;
+        try {
+            upload = std::make_shared<UploadStep>((*shared_decode)());
+        }
+        catch (...) {
+            promise->set_exception(std::current_exception());
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+        QueueUpload(
+            [promise, upload] {
+                try {
+                    if constexpr (std::is_void_v<Result>) {
+                        (*upload)();
+                        promise->set_value();
+                    }
+                    else {
+                        promise->set_value((*upload)());
+                    }
+                }
+                catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            },
+            after);
+    });
+    return future;
+}
+
+template<typename Decode>
+auto AssetLoader::Load(std::filesystem::path path, Decode decode, std::shared_future<void> after)
+{
+    return Async(
+        [path = std::move(path), decode = std::move(decode)]() mutable {
+            auto asset = AssetManager::current().Open(path);
+            if (not asset) {
+                throw std::runtime_error("Failed to open asset " + path.string());
+            }
+            return decode(*asset);
+        },
+        std::move(after));
+}
+
+}  // namespace firstgame::system
+
+#endif  // FIRSTGAME_SYSTEM_ASSET_LOADER_H_
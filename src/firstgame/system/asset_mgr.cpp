@@ -1,5 +1,7 @@
 #include "asset_mgr.h"
 
+#include <chrono>
+
 #include "log.h"
 #include "system.h"
 
@@ -9,8 +11,41 @@
 
 namespace firstgame::system {
 
+AssetManager::AssetManager(std::shared_ptr<platform::FileSystem> filesystem) : filesystem_(std::move(filesystem))
+{
+#ifdef FIRSTGAME_ASSETS_PACK_PATH
+    if (not Mount(FIRSTGAME_ASSETS_PACK_PATH)) {
+        WARN("Asset pack not found ({}), serving loose asset files", FIRSTGAME_ASSETS_PACK_PATH);
+    }
+#endif
+    TRACE("Initialized AssetManager");
+}
+
+/**************************************************************************************************/
+
+bool AssetManager::Mount(const std::filesystem::path& pack_path)
+{
+    [[maybe_unused]] const auto start = std::chrono::steady_clock::now();
+    auto pack = AssetPack::Open(*filesystem_, pack_path);
+    if (not pack) {
+        return false;
+    }
+    pack_ = std::move(pack);
+    DEBUG("Mounted asset pack ({}) with {} assets in {:.3f} ms", pack_path.c_str(), pack_->size(),
+          std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+    return true;
+}
+
+/**************************************************************************************************/
+
 auto AssetManager::Open(std::filesystem::path assetpath) -> util::Scoped<Asset>
 {
+    if (pack_) {
+        if (auto file = pack_->OpenFile(assetpath)) {
+            return util::make_scoped<Asset>(std::move(file), std::move(assetpath));
+        }
+    }
+
     static std::filesystem::path basepath(FIRSTGAME_ASSETS_DIR_PATH);
     std::filesystem::path fullpath = basepath / assetpath;
     std::unique_ptr<platform::File> file = filesystem_->Open(fullpath.c_str());
@@ -21,4 +56,26 @@ auto AssetManager::Open(std::filesystem::path assetpath) -> util::Scoped<Asset>
     return util::make_scoped<Asset>(std::move(file), std::move(assetpath));
 }
 
+/**************************************************************************************************/
+
+auto AssetManager::Load(const std::filesystem::path& assetpath) -> std::shared_ptr<const Blob>
+{
+    const std::string key = assetpath.lexically_normal().generic_string();
+    if (auto blob = cache_.Find(key)) {
+        return blob;
+    }
+    auto asset = Open(assetpath);
+    if (not asset) {
+        return nullptr;
+    }
+    return cache_.Insert(key, std::make_shared<const Blob>(asset.release()));
+}
+
+/**************************************************************************************************/
+
+void AssetManager::Invalidate(const std::filesystem::path& assetpath)
+{
+    cache_.Erase(assetpath.lexically_normal().generic_string());
+}
+
 }  // namespace firstgame::system
\ No newline at end of file
@@ -6,6 +6,8 @@
 
 #include "log.h"
 #include "asset.h"
+#include "asset_pack.h"
+#include "asset_cache.h"
 #include "firstgame/util/scoped.h"
 #include "firstgame/util/currenton.h"
 #include "firstgame/platform/filesystem.h"
@@ -13,17 +15,34 @@
 namespace firstgame::system {
 
 /// Asset Manager Interface
+/// Assets are served from the mounted asset pack when they are in it, otherwise from the assets directory.
 class AssetManager final : public util::Currenton<AssetManager> {
    public:
     // Interface
     [[nodiscard]] auto Open(std::filesystem::path assetpath) -> util::Scoped<Asset>;
 
+    /// Get the shared content of an asset, from the cache when loaded recently, or null if it could not be opened.
+    /// Prefer it to Open() for assets read by several users, the content is loaded once and released with its last user.
+    [[nodiscard]] auto Load(const std::filesystem::path& assetpath) -> std::shared_ptr<const Blob>;
+
+    /// Drop the cached content of an asset whose file changed, so the next Load() reads it again
+    void Invalidate(const std::filesystem::path& assetpath);
+
+    /// Cache of the assets loaded with Load()
+    [[nodiscard]] auto Cache() -> AssetCache& { return cache_; }
+
+    /// Platform file system serving the assets, also writing the engine's own files like caches
+    [[nodiscard]] auto Storage() const -> const std::shared_ptr<platform::FileSystem>& { return filesystem_; }
+
+    /// Serve assets from a packed archive, replacing the mounted one. Returns false if it could not be opened.
+    bool Mount(const std::filesystem::path& pack_path);
+
+    /// Stop serving assets from the mounted archive, if any, serving them from the assets directory only
+    void Unmount() { pack_.reset(); }
+
     // Con/Destructor
-    explicit AssetManager(std::shared_ptr<platform::FileSystem> filesystem)
-        : filesystem_(std::move(filesystem))
-    {
-        TRACE("Initialized AssetManager");
-    }
+    /// Mounts the build's asset pack if there is one
+    explicit AssetManager(std::shared_ptr<platform::FileSystem> filesystem);
     ~AssetManager() override { TRACE("De-initialized AssetManager"); }
 
     // Copy/Move
@@ -34,6 +53,11 @@ class AssetManager final : public util::Currenton<AssetManager> {
 
    private:
     std::shared_ptr<platform::FileSystem> filesystem_;
+    std::unique_ptr<AssetPack> pack_;
+    AssetCache cache_{ kDefaultCacheBudget };
+
+    /// Default budget of the asset cache
+    static constexpr size_t kDefaultCacheBudget = 64 * 1024 * 1024;
 };
 
 }  // namespace firstgame::system
@@ -0,0 +1,107 @@
+#include "asset_pack.h"
+
+#include <algorithm>
+#include <string>
+#include <cstring>
+
+#include "log.h"
+
+namespace firstgame::system {
+
+/**************************************************************************************************/
+
+/// Asset file viewing its blob in the archive's mapping
+class PackedFile final : public platform::File {
+   public:
+    PackedFile(std::shared_ptr<const void> archive, platform::FileView view, std::filesystem::path path)
+        : archive_(std::move(archive)), view_(view), path_(std::move(path))
+    {
+    }
+
+    auto ReadToString() -> std::string override
+    {
+        return { reinterpret_cast<const char*>(view_.data), view_.size };
+    }
+    auto Map() -> std::optional<platform::FileView> override { return view_; }
+    void Close() override
+    {
+        archive_.reset();
+        view_ = {};
+    }
+    auto Path() -> std::filesystem::path override { return path_; }
+
+   private:
+    std::shared_ptr<const void> archive_;  ///< keeps the archive mapped
+    platform::FileView view_;
+    std::filesystem::path path_;
+};
+
+/**************************************************************************************************/
+
+auto AssetPack::Open(platform::FileSystem& filesystem, const std::filesystem::path& path) -> std::unique_ptr<AssetPack>
+{
+    std::shared_ptr<platform::File> file = filesystem.Open(path.c_str());
+    if (not file) {
+        return nullptr;
+    }
+    std::shared_ptr<const void> storage = file;
+    std::optional<platform::FileView> data = file->Map();
+    if (not data) {
+        auto buffer = std::make_shared<const std::string>(file->ReadToString());
+        data = platform::FileView{ reinterpret_cast<const std::byte*>(buffer->data()), buffer->size() };
+        storage = std::move(buffer);
+    }
+
+    // validate the header and the index bounds, blobs are checked when opened
+    pack::PackHeader header{};
+    if (data->size < sizeof(header)) {
+        ERROR("Invalid asset pack ({}): truncated header", path.c_str());
+        return nullptr;
+    }
+    std::memcpy(&header, data->data, sizeof(header));
+    if (std::memcmp(header.magic, pack::kMagic, sizeof(pack::kMagic)) != 0 || header.version != pack::kVersion) {
+        ERROR("Invalid asset pack ({}): bad magic or version {}", path.c_str(), header.version);
+        return nullptr;
+    }
+    if (header.index_offset % alignof(pack::PackEntry) != 0 || header.index_offset > data->size ||
+        (data->size - header.index_offset) / sizeof(pack::PackEntry) < header.num_entries) {
+        ERROR("Invalid asset pack ({}): index out of bounds", path.c_str());
+        return nullptr;
+    }
+
+    auto pack = std::unique_ptr<AssetPack>(new AssetPack(std::move(storage), *data));
+    pack->index_ = { reinterpret_cast<const pack::PackEntry*>(data->data + header.index_offset), header.num_entries };
+    DEBUG("Opened asset pack ({}) with {} assets", path.c_str(), pack->index_.size());
+    return pack;
+}
+
+/**************************************************************************************************/
+
+AssetPack::AssetPack(std::shared_ptr<const void> storage, platform::FileView data)
+    : storage_(std::move(storage)), data_(data)
+{
+}
+
+/**************************************************************************************************/
+
+auto AssetPack::OpenFile(const std::filesystem::path& assetpath) const -> std::unique_ptr<platform::File>
+{
+    const uint64_t hash = pack::PathHash(assetpath);
+    const auto entry = std::lower_bound(index_.begin(), index_.end(), hash,
+                                         [](const pack::PackEntry& entry, uint64_t hash) { return entry.hash < hash; });
+    if (entry == index_.end() || entry->hash != hash) {
+        return nullptr;
+    }
+    if (entry->offset > data_.size || data_.size - entry->offset < entry->size) {
+        ERROR("Asset pack entry out of bounds ({})", assetpath.c_str());
+        return nullptr;
+    }
+    if (entry->codec != pack::Codec::NONE) {
+        ERROR("Asset pack entry with unsupported codec {} ({})", static_cast<uint32_t>(entry->codec), assetpath.c_str());
+        return nullptr;
+    }
+    const platform::FileView view{ data_.data + entry->offset, entry->size };
+    return std::make_unique<PackedFile>(storage_, view, assetpath);
+}
+
+}  // namespace firstgame::system
@@ -0,0 +1,44 @@
+#ifndef FIRSTGAME_SYSTEM_ASSET_PACK_H_
+#define FIRSTGAME_SYSTEM_ASSET_PACK_H_
+
+#include <memory>
+#include <optional>
+#include <filesystem>
+#include <gsl/span>
+
+#include "asset_pack_format.h"
+#include "firstgame/platform/filesystem.h"
+
+namespace firstgame::system {
+
+/// AssetPack serves assets from a packed archive, built by the firstgame_pack tool from the assets directory.
+/// The whole archive is opened and memory-mapped once, then finding an asset is a binary search
+/// in the index and opening it hands out a view into the mapping, with no further file system access.
+class AssetPack final {
+   public:
+    /// Open and validate an archive, returns null if missing or invalid
+    static auto Open(platform::FileSystem& filesystem, const std::filesystem::path& path) -> std::unique_ptr<AssetPack>;
+
+    /// Open an asset by its path relative to the assets directory, returns null if not in the archive
+    auto OpenFile(const std::filesystem::path& assetpath) const -> std::unique_ptr<platform::File>;
+
+    /// Number of assets in the archive
+    [[nodiscard]] size_t size() const { return index_.size(); }
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+   private:
+    AssetPack(std::shared_ptr<const void> storage, platform::FileView data);
+
+   private:
+    /// Owner of the archive content, the mapped file or a buffer read from it when it could not be mapped.
+    /// Shared by the opened assets, which may outlive the pack.
+    std::shared_ptr<const void> storage_;
+    platform::FileView data_;
+    gsl::span<const pack::PackEntry> index_;
+};
+
+}  // namespace firstgame::system
+
+#endif  // FIRSTGAME_SYSTEM_ASSET_PACK_H_
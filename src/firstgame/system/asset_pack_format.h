@@ -0,0 +1,58 @@
+#ifndef FIRSTGAME_SYSTEM_ASSET_PACK_FORMAT_H_
+#define FIRSTGAME_SYSTEM_ASSET_PACK_FORMAT_H_
+
+#include <string>
+#include <cstdint>
+#include <filesystem>
+
+#include "firstgame/util/hash.h"
+
+/// Layout of the asset pack archive (.fgpak), shared by the packer tool and the AssetManager.
+/// All fields are little-endian, and the archive is meant to be memory-mapped and read in place:
+///
+///     | PackHeader | blob | pad | blob | pad | ... | PackEntry[num_entries] |
+///
+/// Blobs start aligned to kPackAlignment. The index of entries is sorted by path hash for binary search,
+/// the paths themselves are not stored, so the packer rejects hash collisions.
+namespace firstgame::system::pack {
+
+inline constexpr char kMagic[4] = { 'F', 'G', 'P', 'K' };
+inline constexpr uint32_t kVersion = 1;
+inline constexpr uint64_t kPackAlignment = 16;
+
+/// Compression of a blob
+enum class Codec : uint32_t {
+    NONE = 0,  ///< stored as is, read in place
+    // reserved for LZ4 and zstd, once available to the build
+};
+
+/// Archive header, at offset zero
+struct PackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t num_entries;
+    uint32_t reserved;
+    uint64_t index_offset;  ///< byte offset of the PackEntry array
+};
+static_assert(sizeof(PackHeader) == 24);
+
+/// Index entry of an asset
+struct PackEntry {
+    uint64_t hash;    ///< PathHash() of the asset path
+    uint64_t offset;  ///< byte offset of the blob
+    uint64_t size;    ///< stored size of the blob
+    uint64_t original_size;
+    Codec codec;
+    uint32_t reserved;
+};
+static_assert(sizeof(PackEntry) == 40);
+
+/// Hash of an asset path relative to the assets directory, normalized with forward slashes
+inline uint64_t PathHash(const std::filesystem::path& assetpath)
+{
+    return util::Fnv1a(assetpath.lexically_normal().generic_string());
+}
+
+}  // namespace firstgame::system::pack
+
+#endif  // FIRSTGAME_SYSTEM_ASSET_PACK_FORMAT_H_
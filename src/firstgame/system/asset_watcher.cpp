@@ -0,0 +1,179 @@
+#include "asset_watcher.h"
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#if defined(FIRSTGAME_HOT_RELOAD) && defined(__linux__)
+#include <poll.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#define FIRSTGAME_ASSET_WATCHER_INOTIFY
+#endif
+
+#include "log.h"
+#include "asset_mgr.h"
+
+namespace firstgame::system {
+
+/// Normalized key of an asset path
+static std::string Key(const std::filesystem::path& assetpath)
+{
+    return assetpath.lexically_normal().generic_string();
+}
+
+/**************************************************************************************************/
+
+AssetWatcher::AssetWatcher(std::filesystem::path dir) : dir_(std::move(dir))
+{
+#if defined(FIRSTGAME_ASSET_WATCHER_INOTIFY)
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    quit_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inotify_fd_ < 0 || quit_fd_ < 0) {
+        WARN("Failed to watch assets ({}): {}", dir_.c_str(), std::strerror(errno));
+        return;
+    }
+    AddDirectory({});
+    thread_ = std::thread(&AssetWatcher::ThreadLoop, this);
+    TRACE("Watching assets ({}) in {} directories", dir_.c_str(), watch_dirs_.size());
+#endif
+}
+
+/**************************************************************************************************/
+
+AssetWatcher::~AssetWatcher()
+{
+#if defined(FIRSTGAME_ASSET_WATCHER_INOTIFY)
+    if (thread_.joinable()) {
+        const uint64_t quit = 1;
+        [[maybe_unused]] const ssize_t written = write(quit_fd_, &quit, sizeof(quit));
+        thread_.join();
+    }
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+    }
+    if (quit_fd_ >= 0) {
+        close(quit_fd_);
+    }
+#endif
+}
+
+/**************************************************************************************************/
+
+void AssetWatcher::Watch(const void* owner, const std::filesystem::path& assetpath, std::function<void()> on_change)
+{
+    watches_[Key(assetpath)].push_back({ owner, std::move(on_change) });
+}
+
+void AssetWatcher::Unwatch(const void* owner)
+{
+    for (auto it = watches_.begin(); it != watches_.end();) {
+        auto& entries = it->second;
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [owner](const auto& entry) { return entry.owner == owner; }),
+                      entries.end());
+        it = entries.empty() ? watches_.erase(it) : std::next(it);
+    }
+}
+
+/**************************************************************************************************/
+
+void AssetWatcher::Poll()
+{
+    // the common case, nothing changed
+    if (not changed_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::unordered_set<std::string> changes;
+    {
+        std::lock_guard lock(mutex_);
+        changes.swap(changes_);
+        changed_.store(false, std::memory_order_relaxed);
+    }
+    for (const std::string& assetpath : changes) {
+        AssetManager::current().Invalidate(assetpath);
+        auto it = watches_.find(assetpath);
+        if (it == watches_.end()) {
+            continue;
+        }
+        DEBUG("Asset changed ({}), notifying {} watches", assetpath, it->second.size());
+        // copied, a watch may watch or unwatch
+        const auto entries = it->second;
+        for (const auto& entry : entries) {
+            entry.on_change();
+        }
+    }
+}
+
+/**************************************************************************************************/
+
+void AssetWatcher::AddDirectory(const std::filesystem::path& dir)
+{
+#if defined(FIRSTGAME_ASSET_WATCHER_INOTIFY)
+    // files are watched once complete, whether written in place or renamed over by editors
+    const auto fullpath = dir_ / dir;
+    const int wd = inotify_add_watch(inotify_fd_, fullpath.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (wd < 0) {
+        WARN("Failed to watch directory ({}): {}", fullpath.c_str(), std::strerror(errno));
+        return;
+    }
+    watch_dirs_[wd] = dir;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(fullpath, error)) {
+        if (entry.is_directory(error)) {
+            AddDirectory(dir / entry.path().filename());
+        }
+    }
+#endif
+}
+
+/**************************************************************************************************/
+
+void AssetWatcher::ThreadLoop()
+{
+#if defined(FIRSTGAME_ASSET_WATCHER_INOTIFY)
+    alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+    pollfd fds[2] = { { inotify_fd_, POLLIN, 0 }, { quit_fd_, POLLIN, 0 } };
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ERROR("Failed to poll asset changes: {}", std::strerror(errno));
+            return;
+        }
+        if (fds[1].revents & POLLIN) {
+            return;
+        }
+        const ssize_t size = read(inotify_fd_, buffer, sizeof(buffer));
+        if (size <= 0) {
+            continue;
+        }
+        std::vector<std::string> changes;
+        for (ssize_t offset = 0; offset < size;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            auto dir = watch_dirs_.find(event->wd);
+            if (dir == watch_dirs_.end() || event->len == 0) {
+                continue;
+            }
+            const auto assetpath = dir->second / event->name;
+            if (event->mask & IN_ISDIR) {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    AddDirectory(assetpath);
+                }
+            }
+            else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                changes.push_back(Key(assetpath));
+            }
+        }
+        if (not changes.empty()) {
+            std::lock_guard lock(mutex_);
+            changes_.insert(changes.begin(), changes.end());
+            changed_.store(true, std::memory_order_release);
+        }
+    }
+#endif
+}
+
+}  // namespace firstgame::system
@@ -0,0 +1,83 @@
+#ifndef FIRSTGAME_SYSTEM_ASSET_WATCHER_H_
+#define FIRSTGAME_SYSTEM_ASSET_WATCHER_H_
+
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "firstgame/util/currenton.h"
+
+namespace firstgame::system {
+
+/// AssetWatcher detects changes to the files of the assets directory, so assets can be reloaded while running.
+/// Changes are detected with inotify on a background thread, blocked in the kernel until a file changes, and
+/// handed over to Poll() through an atomic flag, so polling every frame costs a single load when nothing changed.
+/// Poll() drops the changed assets from the AssetManager's cache and calls their watches, between frames.
+/// Watching is only supported on Linux, in Debug builds with the FIRSTGAME_HOT_RELOAD option, which serve the assets
+/// from the source tree; elsewhere no change is ever reported. Assets in a mounted asset pack do not reload, as the
+/// pack takes precedence.
+/// Watch(), Unwatch() and Poll() must be called from the same thread.
+/// Example:
+/// ```
+///  watcher.Watch(this, "shaders"_path / "main.vert", [this] { Reload(); });
+///  ...
+///  watcher.Poll();  // every frame
+///  ...
+///  watcher.Unwatch(this);
+/// ```
+class AssetWatcher final : public util::Currenton<AssetWatcher> {
+   public:
+    /// Watch the files of a directory and its subdirectories, if supported
+    explicit AssetWatcher(std::filesystem::path dir);
+    ~AssetWatcher() override;
+    AssetWatcher(const AssetWatcher&) = delete;
+    AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+    /// Call `on_change` whenever the asset changes, until unwatched by `owner`
+    void Watch(const void* owner, const std::filesystem::path& assetpath, std::function<void()> on_change);
+
+    /// Remove all the watches of an owner
+    void Unwatch(const void* owner);
+
+    /// Invalidate the assets changed since the last call and call their watches
+    void Poll();
+
+    /// Whether changes are being detected
+    [[nodiscard]] bool Active() const { return thread_.joinable(); }
+
+   private:
+    /// Watcher thread main loop, reading file events until quit
+    void ThreadLoop();
+
+    /// Watch a directory and its subdirectories, on the watcher thread
+    void AddDirectory(const std::filesystem::path& dir);
+
+   private:
+    /// Callback of a watched asset
+    struct WatchEntry {
+        const void* owner;
+        std::function<void()> on_change;
+    };
+
+    std::filesystem::path dir_;
+    int inotify_fd_ = -1;
+    int quit_fd_ = -1;  ///< signals the watcher thread to quit
+    std::unordered_map<int, std::filesystem::path> watch_dirs_;  ///< watched directory by descriptor, relative
+    std::thread thread_;
+
+    std::atomic<bool> changed_{ false };
+    std::mutex mutex_;
+    std::unordered_set<std::string> changes_;  ///< changed assets not polled yet
+
+    std::unordered_map<std::string, std::vector<WatchEntry>> watches_;  ///< watches by asset path
+};
+
+}  // namespace firstgame::system
+
+#endif  // FIRSTGAME_SYSTEM_ASSET_WATCHER_H_
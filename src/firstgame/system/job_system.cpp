@@ -0,0 +1,135 @@
+#include "job_system.h"
+
+#include <algorithm>
+
+#include "log.h"
+
+namespace firstgame::system {
+
+/**************************************************************************************************/
+
+JobSystem::JobSystem(unsigned int num_workers) : max_threads_(num_workers + 1)
+{
+    workers_.reserve(num_workers);
+    for (unsigned int index = 0; index < num_workers; index++) {
+        workers_.emplace_back(&JobSystem::WorkerLoop, this, index);
+    }
+    TRACE("Initialized JobSystem with {} workers", num_workers);
+}
+
+/**************************************************************************************************/
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard lock(mutex_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    TRACE("De-initialized JobSystem");
+}
+
+/**************************************************************************************************/
+
+unsigned int JobSystem::DefaultNumWorkers()
+{
+    const unsigned int hardware_threads = std::thread::hardware_concurrency();
+    return hardware_threads > 1 ? hardware_threads - 1 : 0;
+}
+
+/**************************************************************************************************/
+
+void JobSystem::Run(size_t count, size_t chunk_size, void* context, ChunkFunc func)
+{
+    if (count == 0) {
+        return;
+    }
+    chunk_size = std::max<size_t>(chunk_size, 1);
+    const size_t num_chunks = (count + chunk_size - 1) / chunk_size;
+    const auto num_participants =
+        static_cast<unsigned int>(std::min<size_t>({ workers_.size(), max_threads_ - 1, num_chunks - 1 }));
+
+    // deterministic fallback
+    if (deterministic_ || num_participants == 0) {
+        for (size_t begin = 0; begin < count; begin += chunk_size) {
+            func(context, begin, std::min(begin + chunk_size, count));
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        func_ = func;
+        context_ = context;
+        count_ = count;
+        chunk_size_ = chunk_size;
+        num_chunks_ = num_chunks;
+        num_participants_ = num_participants;
+        next_chunk_.store(0, std::memory_order_relaxed);
+        completed_chunks_.store(0, std::memory_order_relaxed);
+        generation_++;
+    }
+    wake_.notify_all();
+
+    ProcessChunks();
+
+    // wait for all chunks to complete and for all workers to leave the job,
+    // so that none of them touches the job state once the next one is published
+    std::unique_lock lock(mutex_);
+    finished_.wait(lock, [this] { return completed_chunks_.load() == num_chunks_ && active_ == 0; });
+}
+
+/**************************************************************************************************/
+
+void JobSystem::ProcessChunks()
+{
+    PROFILE_ZONE("Job");
+    for (;;) {
+        const size_t chunk = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= num_chunks_) {
+            return;
+        }
+        const size_t begin = chunk * chunk_size_;
+        func_(context_, begin, std::min(begin + chunk_size_, count_));
+        if (completed_chunks_.fetch_add(1, std::memory_order_acq_rel) + 1 == num_chunks_) {
+            std::lock_guard lock(mutex_);
+            finished_.notify_one();
+        }
+    }
+}
+
+/**************************************************************************************************/
+
+void JobSystem::WorkerLoop(unsigned int index)
+{
+    Profiler::NameThread(("worker " + std::to_string(index)).c_str());
+    uint64_t last_generation = 0;
+    for (;;) {
+        {
+            std::unique_lock lock(mutex_);
+            wake_.wait(lock, [&] { return quit_ || generation_ != last_generation; });
+            if (quit_) {
+                return;
+            }
+            last_generation = generation_;
+            // sit this job out if not needed or if it was already fully picked up
+            if (index >= num_participants_ || next_chunk_.load(std::memory_order_relaxed) >= num_chunks_) {
+                continue;
+            }
+            active_++;
+        }
+
+        ProcessChunks();
+
+        std::lock_guard lock(mutex_);
+        active_--;
+        if (active_ == 0) {
+            finished_.notify_one();
+        }
+    }
+}
+
+}  // namespace firstgame::system
@@ -0,0 +1,95 @@
+#ifndef FIRSTGAME_SYSTEM_JOB_SYSTEM_H_
+#define FIRSTGAME_SYSTEM_JOB_SYSTEM_H_
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <condition_variable>
+
+#include "firstgame/util/currenton.h"
+
+namespace firstgame::system {
+
+/// JobSystem runs data-parallel work on a pool of worker threads, sized to the hardware threads.
+/// ParallelFor splits a range of indices in chunks, which are picked up by the workers and the calling thread,
+/// and returns once all of them were processed. Only one thread may issue a ParallelFor at a time.
+/// In deterministic mode, or without workers, the chunks run sequentially and in order on the calling thread.
+/// Example:
+/// ```
+///  jobs.ParallelFor(transforms.size(), 1024, [&](size_t begin, size_t end) {
+///      for (size_t i = begin; i < end; i++) Integrate(transforms[i]);
+///  });
+/// ```
+class JobSystem final : public util::Currenton<JobSystem> {
+   public:
+    explicit JobSystem(unsigned int num_workers = DefaultNumWorkers());
+    ~JobSystem() override;
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /// Number of hardware threads, excluding the calling thread
+    static unsigned int DefaultNumWorkers();
+
+    /// Call `func(begin, end)` for every chunk of `chunk_size` indices within [0, count)
+    template<typename Func>
+    void ParallelFor(size_t count, size_t chunk_size, Func&& func)
+    {
+        using F = std::remove_reference_t<Func>;
+        void* context = const_cast<void*>(static_cast<const void*>(&func));
+        Run(count, chunk_size, context, [](void* context, size_t begin, size_t end) {
+            (*static_cast<F*>(context))(begin, end);
+        });
+    }
+
+    /// Run chunks sequentially and in order on the calling thread
+    void SetDeterministic(bool deterministic) { deterministic_ = deterministic; }
+    [[nodiscard]] bool Deterministic() const { return deterministic_; }
+
+    /// Limit the number of threads running a ParallelFor, including the calling thread
+    void SetMaxThreads(unsigned int max_threads) { max_threads_ = max_threads ? max_threads : 1; }
+    [[nodiscard]] unsigned int MaxThreads() const { return max_threads_; }
+
+    /// Number of worker threads in the pool
+    [[nodiscard]] unsigned int NumWorkers() const { return static_cast<unsigned int>(workers_.size()); }
+
+   private:
+    using ChunkFunc = void (*)(void* context, size_t begin, size_t end);
+
+    /// Publish a job to the workers and help processing it until done
+    void Run(size_t count, size_t chunk_size, void* context, ChunkFunc func);
+
+    /// Process chunks of the current job until there are none left
+    void ProcessChunks();
+
+    /// Worker thread main loop
+    void WorkerLoop(unsigned int index);
+
+   private:
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;      ///< signals workers of a new job or quit
+    std::condition_variable finished_;  ///< signals the issuing thread of job completion
+    // current job, written under mutex_ while no worker is active
+    ChunkFunc func_ = nullptr;
+    void* context_ = nullptr;
+    size_t count_ = 0;
+    size_t chunk_size_ = 0;
+    size_t num_chunks_ = 0;
+    unsigned int num_participants_ = 0;  ///< number of workers allowed to join the job
+    uint64_t generation_ = 0;            ///< incremented for every job
+    unsigned int active_ = 0;            ///< number of workers currently inside the job
+    bool quit_ = false;
+    std::atomic<size_t> next_chunk_{ 0 };
+    std::atomic<size_t> completed_chunks_{ 0 };
+    // settings
+    bool deterministic_ = false;
+    unsigned int max_threads_;
+};
+
+}  // namespace firstgame::system
+
+#endif  // FIRSTGAME_SYSTEM_JOB_SYSTEM_H_
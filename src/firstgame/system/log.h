@@ -9,6 +9,7 @@
 #include <spdlog/spdlog.h>
 
 #include "firstgame/util/currenton.h"
+#include "profiler.h"
 
 /**************************************************************************************************/
 
@@ -20,6 +21,16 @@
 #define CRITICAL(...) \
     SPDLOG_LOGGER_CRITICAL(::firstgame::system::Logger::current().handle(), __VA_ARGS__)
 
+// Time the enclosing scope as a zone of the frame profile, `name` must be a static string
+#ifdef FIRSTGAME_PROFILER
+#define PROFILE_ZONE(name) const ::firstgame::system::ScopedZone FIRSTGAME_PROFILE_VAR(__LINE__)(name)
+#define FIRSTGAME_PROFILE_VAR(line) FIRSTGAME_PROFILE_CONCAT(profile_zone_, line)
+#define FIRSTGAME_PROFILE_CONCAT(a, b) a##b
+#else
+#define PROFILE_ZONE(name) (void) 0
+#endif
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+
 #ifndef NDEBUG
 #define ASSERT_MSG(cond, ...)      \
     do {                           \
@@ -0,0 +1,161 @@
+#include "profiler.h"
+
+#include <algorithm>
+
+namespace firstgame::system {
+
+/**************************************************************************************************/
+
+Profiler::Profiler()
+{
+    // generations tell the buffers of a previous profiler apart, threads register again with a new one
+    static std::atomic<uint64_t> generations{ 0 };
+    s_generation_.store(generations.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+#ifdef FIRSTGAME_PROFILER
+    s_enabled_.store(true, std::memory_order_relaxed);
+#endif
+    start_ns_ = Now();
+    start_ticks_ = Ticks();
+    start_allocations_ = Allocations();
+}
+
+Profiler::~Profiler()
+{
+    s_enabled_.store(false, std::memory_order_relaxed);
+    s_generation_.store(0, std::memory_order_relaxed);
+}
+
+/**************************************************************************************************/
+
+void Profiler::SetEnabled(bool enabled)
+{
+#ifdef FIRSTGAME_PROFILER
+    s_enabled_.store(enabled, std::memory_order_relaxed);
+#endif
+}
+
+/**************************************************************************************************/
+
+bool Profiler::Register()
+{
+    const uint64_t generation = s_generation_.load(std::memory_order_relaxed);
+    if (generation == 0) {
+        return false;
+    }
+    Profiler& profiler = current();
+    std::lock_guard lock(profiler.threads_mutex_);
+    auto& buffer = profiler.threads_.emplace_back(std::make_unique<ThreadBuffer>());
+    buffer->name = "thread " + std::to_string(profiler.threads_.size() - 1);
+    t_thread_.buffer = buffer.get();
+    t_thread_.index = static_cast<uint16_t>(profiler.threads_.size() - 1);
+    t_thread_.generation = generation;
+    return true;
+}
+
+void Profiler::NameThread(const char* name)
+{
+    if (t_thread_.generation != s_generation_.load(std::memory_order_relaxed) && not Register()) {
+        return;
+    }
+    std::lock_guard lock(current().threads_mutex_);
+    t_thread_.buffer->name = name;
+}
+
+std::vector<std::string> Profiler::ThreadNames() const
+{
+    std::lock_guard lock(threads_mutex_);
+    std::vector<std::string> names;
+    names.reserve(threads_.size());
+    for (const auto& buffer : threads_) {
+        names.push_back(buffer->name);
+    }
+    return names;
+}
+
+/**************************************************************************************************/
+
+void Profiler::NextFrame()
+{
+    const uint64_t now = Now();
+    const uint64_t ticks = Ticks();
+    const AllocCounters allocations = Allocations();
+    if (paused_) {
+        std::lock_guard lock(threads_mutex_);
+        for (const auto& buffer : threads_) {
+            buffer->tail = buffer->head.load(std::memory_order_acquire);
+        }
+        start_ns_ = now;
+        start_ticks_ = ticks;
+        start_allocations_ = allocations;
+        return;
+    }
+    ProfileFrame& frame = frames_[number_ % kNumFrames];
+    frame.number = number_;
+    frame.start_ns = start_ns_;
+    frame.end_ns = now;
+    frame.allocations = AllocCounters{
+        .count = allocations.count - start_allocations_.count,
+        .bytes = allocations.bytes - start_allocations_.bytes,
+    };
+    frame.zones.clear();
+    frame.gpu_zones.clear();
+    // the timestamp counter is calibrated against the clock over the frame, zones which began in an earlier frame
+    // are extrapolated back
+    const double ns_per_tick = ticks > start_ticks_ ? static_cast<double>(now - start_ns_) / (ticks - start_ticks_) : 1.0;
+    const auto to_ns = [&](uint64_t zone_ticks) {
+        const auto offset = static_cast<double>(static_cast<int64_t>(zone_ticks - start_ticks_)) * ns_per_tick;
+        return static_cast<uint64_t>(static_cast<int64_t>(start_ns_) + static_cast<int64_t>(offset));
+    };
+    {
+        std::lock_guard lock(threads_mutex_);
+        for (const auto& buffer : threads_) {
+            const uint64_t head = buffer->head.load(std::memory_order_acquire);
+            const uint64_t first = std::max(buffer->tail, head > kZonesPerThread ? head - kZonesPerThread : 0);
+            const size_t begin = frame.zones.size();
+            for (uint64_t i = first; i < head; i++) {
+                frame.zones.push_back(buffer->zones[i & (kZonesPerThread - 1)]);
+            }
+            // zones overwritten by the thread while being copied are dropped
+            const uint64_t overwritten = buffer->head.load(std::memory_order_acquire);
+            if (overwritten > first + kZonesPerThread) {
+                const auto num_torn = std::min<uint64_t>(overwritten - first - kZonesPerThread, head - first);
+                frame.zones.erase(frame.zones.begin() + begin, frame.zones.begin() + begin + num_torn);
+            }
+            buffer->tail = head;
+        }
+    }
+    for (ProfileZone& zone : frame.zones) {
+        zone.start_ns = to_ns(zone.start_ns);
+        zone.end_ns = to_ns(zone.end_ns);
+    }
+    number_++;
+    start_ns_ = now;
+    start_ticks_ = ticks;
+    start_allocations_ = allocations;
+}
+
+/**************************************************************************************************/
+
+void Profiler::RecordGpu(uint64_t frame, const char* name, uint64_t start_ns, uint64_t duration_ns)
+{
+    if (frame >= number_ || number_ - frame > kNumFrames) {
+        return;  // not ended yet, or no longer kept
+    }
+    frames_[frame % kNumFrames].gpu_zones.push_back(ProfileZone{
+        .name = name,
+        .start_ns = start_ns,
+        .end_ns = start_ns + duration_ns,
+        .depth = 0,
+        .thread = 0,
+    });
+}
+
+const ProfileFrame* Profiler::Frame(size_t age) const
+{
+    if (age >= kNumFrames || age >= number_) {
+        return nullptr;
+    }
+    return &frames_[(number_ - 1 - age) % kNumFrames];
+}
+
+}  // namespace firstgame::system
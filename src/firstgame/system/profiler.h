@@ -0,0 +1,191 @@
+#ifndef FIRSTGAME_SYSTEM_PROFILER_H_
+#define FIRSTGAME_SYSTEM_PROFILER_H_
+
+#include <mutex>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "alloc_stats.h"
+#include "firstgame/util/currenton.h"
+
+namespace firstgame::system {
+
+/// Zone of a frame, timed on a thread or on the GPU
+struct ProfileZone {
+    const char* name;  ///< static string
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint16_t depth;   ///< nesting level within its thread
+    uint16_t thread;  ///< index of the thread in Profiler::ThreadNames()
+};
+
+/// Zones recorded during a frame
+struct ProfileFrame {
+    uint64_t number;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    AllocCounters allocations;           ///< heap allocations of all threads during the frame, see Allocations()
+    std::vector<ProfileZone> zones;      ///< zones of all threads which ended during the frame, in order by thread
+    std::vector<ProfileZone> gpu_zones;  ///< render passes submitted during the frame, once their timing is available
+};
+
+/// Profiler records the timing of the scoped zones of every thread, see PROFILE_ZONE() in log.h, and keeps the
+/// last frames of them for display. Each thread records into its own ring buffer, written by the thread only and
+/// read by NextFrame() without locks, so recording a zone is two reads of the CPU timestamp counter and a few
+/// stores. NextFrame() calibrates the counter against the clock over each frame to convert the zones to nanoseconds.
+/// GPU timings of the render passes come in a few frames later, and are added to the frame they were submitted in.
+class Profiler final : public util::Currenton<Profiler> {
+   public:
+    Profiler();
+    ~Profiler() override;
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /// Whether zones are recorded, false if compiled out
+    [[nodiscard]] static bool Enabled() { return s_enabled_.load(std::memory_order_relaxed); }
+    void SetEnabled(bool enabled);
+
+    /// End the current frame, collecting the zones recorded during it, and begin the next one. Called on the main
+    /// thread once per frame.
+    void NextFrame();
+
+    /// Whether frames are kept, while paused their zones are dropped and the kept frames stay as they are
+    [[nodiscard]] bool Paused() const { return paused_; }
+    void SetPaused(bool paused) { paused_ = paused; }
+
+    /// Number of the current frame
+    [[nodiscard]] uint64_t FrameNumber() const { return number_; }
+
+    /// Add the timing of a render pass to the frame it was submitted in, if still kept
+    void RecordGpu(uint64_t frame, const char* name, uint64_t start_ns, uint64_t duration_ns);
+
+    /// Frames kept, from the latest one (age 0) to the oldest one, or null if not recorded yet
+    [[nodiscard]] const ProfileFrame* Frame(size_t age) const;
+
+    /// Names of the threads which recorded zones, indexed by ProfileZone::thread
+    [[nodiscard]] std::vector<std::string> ThreadNames() const;
+
+    /// Name the calling thread in the profiles
+    static void NameThread(const char* name);
+
+    /// Monotonic time in nanoseconds
+    [[nodiscard]] static uint64_t Now()
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+
+    /// Timestamp of the CPU, in ticks of unknown period, cheaper to read than Now(). Falls back to Now() on CPUs
+    /// without a timestamp counter.
+    [[nodiscard]] static uint64_t Ticks()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return Now();
+#endif
+    }
+
+    /// Record a zone of the calling thread, timed in Ticks()
+    static void Record(const char* name, uint64_t start_ticks, uint64_t end_ticks, uint16_t depth);
+
+    /// Nesting level of the calling thread, maintained by ScopedZone
+    static uint16_t& Depth() { return t_thread_.depth; }
+
+    /// Number of frames kept
+    static constexpr size_t kNumFrames = 128;
+    /// Zones kept per thread between two frame ends, older ones are overwritten
+    static constexpr size_t kZonesPerThread = 1 << 12;
+
+   private:
+    /// Ring buffer of the zones of a thread, single producer (the thread) and single consumer (NextFrame()). Zones
+    /// are timed in Ticks() until NextFrame() converts them.
+    struct ThreadBuffer {
+        std::string name;
+        std::unique_ptr<ProfileZone[]> zones{ new ProfileZone[kZonesPerThread] };
+        std::atomic<uint64_t> head{ 0 };  ///< number of zones written, by the thread
+        uint64_t tail = 0;                ///< number of zones read, by NextFrame()
+    };
+
+    /// Per-thread recording state
+    struct ThreadState {
+        ThreadBuffer* buffer = nullptr;
+        uint64_t generation = ~uint64_t(0);  ///< of the profiler the buffer belongs to, none at first
+        uint16_t index = 0;
+        uint16_t depth = 0;
+    };
+
+    /// Create the buffer of the calling thread, returns false if there is no profiler
+    static bool Register();
+
+   private:
+    static inline std::atomic<bool> s_enabled_{ false };
+    static inline std::atomic<uint64_t> s_generation_{ 0 };  ///< of the current profiler, zero if none
+    static thread_local ThreadState t_thread_;
+
+    mutable std::mutex threads_mutex_;  ///< guards the registration of threads
+    std::vector<std::unique_ptr<ThreadBuffer>> threads_;
+    std::array<ProfileFrame, kNumFrames> frames_{};
+    uint64_t number_ = 0;
+    uint64_t start_ns_ = 0;
+    uint64_t start_ticks_ = 0;  ///< Ticks() at start_ns_
+    AllocCounters start_allocations_{};
+    bool paused_ = false;
+};
+
+/// Times the enclosing scope as a zone of the calling thread, see PROFILE_ZONE()
+class ScopedZone final {
+   public:
+    explicit ScopedZone(const char* name) : name_(name), start_ticks_(Profiler::Enabled() ? Profiler::Ticks() : 0)
+    {
+        Profiler::Depth()++;
+    }
+    ~ScopedZone()
+    {
+        const uint16_t depth = --Profiler::Depth();
+        if (start_ticks_) {
+            Profiler::Record(name_, start_ticks_, Profiler::Ticks(), depth);
+        }
+    }
+    ScopedZone(const ScopedZone&) = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+
+   private:
+    const char* name_;
+    uint64_t start_ticks_;
+};
+
+/**************************************************************************************************/
+
+inline thread_local Profiler::ThreadState Profiler::t_thread_{};
+
+inline void Profiler::Record(const char* name, uint64_t start_ticks, uint64_t end_ticks, uint16_t depth)
+{
+    ThreadState& thread = t_thread_;
+    if (thread.generation != s_generation_.load(std::memory_order_relaxed) && not Register()) {
+        return;
+    }
+    ThreadBuffer& buffer = *thread.buffer;
+    const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.zones[head & (kZonesPerThread - 1)] = ProfileZone{
+        .name = name,
+        .start_ns = start_ticks,
+        .end_ns = end_ticks,
+        .depth = depth,
+        .thread = thread.index,
+    };
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+}  // namespace firstgame::system
+
+#endif  // FIRSTGAME_SYSTEM_PROFILER_H_
@@ -7,7 +7,13 @@
 
 #include "log.h"
 #include "asset_mgr.h"
+#include "asset_loader.h"
+#include "asset_watcher.h"
+#include "job_system.h"
+#include "profiler.h"
+#include "trace_capture.h"
 #include "firstgame/util/currenton.h"
+#include "firstgame/util/frame_arena.h"
 #include "firstgame/platform/filesystem.h"
 
 namespace firstgame::system {
@@ -18,6 +24,12 @@ class System final : public util::Currenton<System> {
     [[nodiscard]] auto Logger() -> Logger& { return logger_; }
     [[nodiscard]] auto AssetManager() -> AssetManager& { return asset_mgr_; }
     [[nodiscard]] auto FileSystem() -> platform::FileSystem& { return *filesystem_; }
+    [[nodiscard]] auto Jobs() -> JobSystem& { return jobs_; }
+    [[nodiscard]] auto Loader() -> AssetLoader& { return loader_; }
+    [[nodiscard]] auto Watcher() -> AssetWatcher& { return watcher_; }
+    [[nodiscard]] auto Profiler() -> Profiler& { return profiler_; }
+    [[nodiscard]] auto Trace() -> TraceCapture& { return trace_; }
+    [[nodiscard]] auto FrameArena() -> util::FrameArena& { return frame_arena_; }
 
     // Constructor
     System(std::shared_ptr<spdlog::logger> logger, std::shared_ptr<platform::FileSystem> filesystem)
@@ -36,8 +48,14 @@ class System final : public util::Currenton<System> {
 
    private:
     system::Logger logger_;
+    system::Profiler profiler_;  ///< outlives the threads of the other systems, which record zones
     system::AssetManager asset_mgr_;
     std::shared_ptr<platform::FileSystem> filesystem_;
+    system::JobSystem jobs_;
+    system::AssetLoader loader_;
+    system::AssetWatcher watcher_{ FIRSTGAME_ASSETS_DIR_PATH };
+    system::TraceCapture trace_{ filesystem_ };
+    util::FrameArena frame_arena_;
 };
 
 }  // namespace firstgame::system
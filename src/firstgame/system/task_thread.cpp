@@ -0,0 +1,70 @@
+#include "task_thread.h"
+
+#include "log.h"
+
+namespace firstgame::system {
+
+/**************************************************************************************************/
+
+TaskThread::TaskThread()
+{
+    // started once all the members it uses are constructed
+    thread_ = std::thread(&TaskThread::Loop, this);
+    TRACE("Initialized TaskThread");
+}
+
+/**************************************************************************************************/
+
+TaskThread::~TaskThread()
+{
+    Wait();
+    {
+        std::lock_guard lock(mutex_);
+        quit_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+    TRACE("De-initialized TaskThread");
+}
+
+/**************************************************************************************************/
+
+void TaskThread::Run(std::function<void()> task)
+{
+    {
+        std::lock_guard lock(mutex_);
+        ASSERT(not busy_);
+        task_ = std::move(task);
+        busy_ = true;
+    }
+    wake_.notify_one();
+}
+
+/**************************************************************************************************/
+
+void TaskThread::Wait()
+{
+    std::unique_lock lock(mutex_);
+    finished_.wait(lock, [this] { return not busy_; });
+}
+
+/**************************************************************************************************/
+
+void TaskThread::Loop()
+{
+    std::unique_lock lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return busy_ || quit_; });
+        if (quit_) {
+            return;
+        }
+        lock.unlock();
+        task_();
+        lock.lock();
+        task_ = nullptr;
+        busy_ = false;
+        finished_.notify_one();
+    }
+}
+
+}  // namespace firstgame::system
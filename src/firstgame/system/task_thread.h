@@ -0,0 +1,49 @@
+#ifndef FIRSTGAME_SYSTEM_TASK_THREAD_H_
+#define FIRSTGAME_SYSTEM_TASK_THREAD_H_
+
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+namespace firstgame::system {
+
+/// TaskThread runs one task at a time on a dedicated thread, overlapping it with the work of the calling thread.
+/// Unlike JobSystem, which splits a range across threads, it moves a whole sequential task off the calling thread,
+/// like simulating the next frame while the current one is submitted.
+/// Example:
+/// ```
+///  thread.Run([&] { Simulate(); });
+///  Submit();
+///  thread.Wait();
+/// ```
+class TaskThread final {
+   public:
+    TaskThread();
+    ~TaskThread();
+    TaskThread(const TaskThread&) = delete;
+    TaskThread& operator=(const TaskThread&) = delete;
+
+    /// Start running the task on the thread, the previous task must have been waited for
+    void Run(std::function<void()> task);
+
+    /// Block until the task is done
+    void Wait();
+
+   private:
+    /// Thread main loop
+    void Loop();
+
+   private:
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;      ///< signals the thread of a new task or quit
+    std::condition_variable finished_;  ///< signals the calling thread of task completion
+    std::function<void()> task_;
+    bool busy_ = false;
+    bool quit_ = false;
+};
+
+}  // namespace firstgame::system
+
+#endif  // FIRSTGAME_SYSTEM_TASK_THREAD_H_
@@ -0,0 +1,247 @@
+#include "trace_capture.h"
+
+#include <charconv>
+#include <algorithm>
+#include <filesystem>
+
+#include "log.h"
+#include "asset_loader.h"
+
+namespace firstgame::system {
+
+/**************************************************************************************************/
+
+namespace {
+
+/// Bytes kept at the end of the buffer for the metadata of the trace, written when it is closed
+constexpr size_t kMetadataReserve = 64 * 1024;
+
+/// Number of the next frame to serialize before it is known
+constexpr uint64_t kNoFrame = ~uint64_t(0);
+
+}  // namespace
+
+/**************************************************************************************************/
+
+TraceCapture::TraceCapture(std::shared_ptr<platform::FileSystem> filesystem) : filesystem_(std::move(filesystem)) {}
+
+TraceCapture::~TraceCapture() = default;
+
+/**************************************************************************************************/
+
+void TraceCapture::Start(unsigned int num_frames, size_t capacity)
+{
+    if (Capturing() || num_frames == 0) {
+        return;
+    }
+    // the only allocation of the capture, frames are serialized in place
+    buffer_.resize(std::max(capacity, 2 * kMetadataReserve));
+    size_ = 0;
+    limit_ = buffer_.size() - kMetadataReserve;
+    overflow_ = false;
+    num_frames_ = num_frames;
+    num_captured_ = 0;
+    next_frame_ = kNoFrame;
+    Append(R"({"displayTimeUnit":"ms","traceEvents":[)");
+    DEBUG("Capturing a trace of {} frames", num_frames);
+}
+
+/**************************************************************************************************/
+
+void TraceCapture::Update(const Profiler& profiler)
+{
+    if (not Capturing()) {
+        return;
+    }
+    if (next_frame_ == kNoFrame) {
+        next_frame_ = profiler.FrameNumber();  // the frame starting now is the first one captured
+        return;
+    }
+    // frames ended kGpuLatency frames ago have their GPU timings in
+    while (next_frame_ + kGpuLatency < profiler.FrameNumber()) {
+        const ProfileFrame* frame = profiler.Frame(profiler.FrameNumber() - 1 - next_frame_);
+        if (not frame || not AddFrame(*frame)) {
+            // out of buffer space, or the profiler was paused long enough for the frame to be dropped
+            WARN("Trace capture ended early, after {} frames", num_captured_);
+            Finish(profiler);
+            return;
+        }
+        next_frame_++;
+        if (++num_captured_ == num_frames_) {
+            Finish(profiler);
+            return;
+        }
+    }
+}
+
+/**************************************************************************************************/
+
+bool TraceCapture::AddFrame(const ProfileFrame& frame)
+{
+    if (num_captured_ == 0) {
+        origin_ns_ = frame.start_ns;
+    }
+    const size_t frame_start = size_;
+    const ProfileZone frame_zone{
+        .name = "Frame",
+        .start_ns = frame.start_ns,
+        .end_ns = frame.end_ns,
+        .depth = 0,
+        .thread = 0,
+    };
+    AppendZone(frame_zone, kFrameTid, "frame");
+    BeginEvent();
+    Append(R"({"name":"Allocations","ph":"C","pid":1,"ts":)");
+    AppendTime(frame.start_ns);
+    Append(R"(,"args":{"count":)");
+    AppendUInt(frame.allocations.count);
+    Append(R"(,"bytes":)");
+    AppendUInt(frame.allocations.bytes);
+    Append("}}");
+    for (const ProfileZone& zone : frame.zones) {
+        AppendZone(zone, zone.thread, "cpu");
+    }
+    for (const ProfileZone& zone : frame.gpu_zones) {
+        AppendZone(zone, kGpuTid, "gpu");
+    }
+    if (overflow_) {
+        size_ = frame_start;
+        return false;
+    }
+    return true;
+}
+
+/**************************************************************************************************/
+
+void TraceCapture::Finish(const Profiler& profiler)
+{
+    // metadata naming the tracks, written into the space kept for it
+    overflow_ = false;
+    limit_ = buffer_.size();
+    const auto append_name = [this](std::string_view kind, uint64_t tid, std::string_view name) {
+        BeginEvent();
+        Append(R"({"name":)");
+        AppendString(kind);
+        Append(R"(,"ph":"M","pid":1,"tid":)");
+        AppendUInt(tid);
+        Append(R"(,"args":{"name":)");
+        AppendString(name);
+        Append("}}");
+    };
+    const std::vector<std::string> threads = profiler.ThreadNames();
+    append_name("process_name", 0, "FirstGame");
+    for (size_t thread = 0; thread < threads.size(); thread++) {
+        append_name("thread_name", thread, threads[thread]);
+    }
+    append_name("thread_name", kGpuTid, "GPU");
+    append_name("thread_name", kFrameTid, "Frames");
+    Append("]}\n");
+    buffer_.resize(size_);
+    num_frames_ = 0;
+
+    const std::filesystem::path dir = filesystem_->CacheDir();
+    if (dir.empty()) {
+        WARN("Trace capture dropped, the platform has no writable storage");
+        buffer_ = {};
+        return;
+    }
+    const std::string name = "frames-" + std::to_string(next_frame_ - num_captured_) + ".json";
+    const std::filesystem::path path = dir / "traces" / name;
+    // written on a loader thread, the trace may be large
+    writing_ = AssetLoader::current().Async([filesystem = filesystem_, path, buffer = std::move(buffer_)] {
+        const bool written = filesystem->Write(path.c_str(), buffer.data(), buffer.size());
+        if (written) {
+            INFO("Wrote trace to {} ({} KiB)", path.c_str(), buffer.size() / 1024);
+        }
+        return [written, path] { return written ? path.string() : std::string(); };
+    });
+    buffer_ = {};
+}
+
+/**************************************************************************************************/
+
+const std::string& TraceCapture::LastPath()
+{
+    if (writing_.valid() && writing_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        try {
+            last_path_ = writing_.get();
+        }
+        catch (const std::exception& e) {
+            last_path_.clear();
+            ERROR("Failed to write trace: {}", e.what());
+        }
+    }
+    return last_path_;
+}
+
+/**************************************************************************************************/
+
+void TraceCapture::BeginEvent()
+{
+    if (size_ > 0 && buffer_[size_ - 1] != '[') {
+        Append(",");
+    }
+}
+
+void TraceCapture::Append(std::string_view text)
+{
+    if (overflow_ || size_ + text.size() > limit_) {
+        overflow_ = true;
+        return;
+    }
+    std::copy(text.begin(), text.end(), buffer_.data() + size_);
+    size_ += text.size();
+}
+
+void TraceCapture::AppendString(std::string_view text)
+{
+    Append("\"");
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            const char escaped[] = { '\\', c };
+            Append({ escaped, sizeof(escaped) });
+        }
+        else if (static_cast<unsigned char>(c) >= 0x20) {
+            Append({ &c, 1 });
+        }
+    }
+    Append("\"");
+}
+
+void TraceCapture::AppendUInt(uint64_t value)
+{
+    char digits[20];
+    const auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+    Append({ digits, static_cast<size_t>(result.ptr - digits) });
+}
+
+void TraceCapture::AppendMicros(uint64_t ns)
+{
+    AppendUInt(ns / 1000);
+    const char fraction[] = { '.', char('0' + ns / 100 % 10), char('0' + ns / 10 % 10), char('0' + ns % 10) };
+    Append({ fraction, sizeof(fraction) });
+}
+
+void TraceCapture::AppendTime(uint64_t ns)
+{
+    // zones may have started before the first frame
+    AppendMicros(ns > origin_ns_ ? ns - origin_ns_ : 0);
+}
+
+void TraceCapture::AppendZone(const ProfileZone& zone, uint64_t tid, std::string_view category)
+{
+    BeginEvent();
+    Append(R"({"name":)");
+    AppendString(zone.name);
+    Append(R"(,"cat":)");
+    AppendString(category);
+    Append(R"(,"ph":"X","pid":1,"tid":)");
+    AppendUInt(tid);
+    Append(R"(,"ts":)");
+    AppendTime(zone.start_ns);
+    Append(R"(,"dur":)");
+    AppendMicros(zone.end_ns - std::min(zone.start_ns, zone.end_ns));
+    Append("}");
+}
+
+}  // namespace firstgame::system
@@ -0,0 +1,94 @@
+#ifndef FIRSTGAME_SYSTEM_TRACE_CAPTURE_H_
+#define FIRSTGAME_SYSTEM_TRACE_CAPTURE_H_
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+#include "profiler.h"
+#include "firstgame/platform/filesystem.h"
+
+namespace firstgame::system {
+
+/// TraceCapture records the next frames of the Profiler into a Chrome Trace Event file (.json), to look at hitches
+/// offline in chrome://tracing or ui.perfetto.dev. The zones of every thread, the GPU passes, the asset loads
+/// (their "Decode asset" and "Upload asset" zones) and the heap allocations of each frame are captured.
+///
+/// Frames are serialized as they come into a buffer reserved when the capture starts, so capturing does not
+/// allocate during the frames. A frame is serialized once its GPU timings came in, a few frames after its end.
+/// Once all frames are in, the buffer is written through the FileSystem on a loader thread.
+/// Example:
+/// ```
+///  capture.Start(60);
+///  ...
+///  profiler.NextFrame();  // every frame
+///  capture.Update(profiler);
+/// ```
+class TraceCapture final {
+   public:
+    explicit TraceCapture(std::shared_ptr<platform::FileSystem> filesystem);
+    ~TraceCapture();
+    TraceCapture(const TraceCapture&) = delete;
+    TraceCapture& operator=(const TraceCapture&) = delete;
+
+    /// Start capturing the next `num_frames` frames, with a buffer of `capacity` bytes. Frames that do not fit are
+    /// left out. Ignored if a capture is in progress.
+    void Start(unsigned int num_frames, size_t capacity = kDefaultCapacity);
+
+    /// Serialize the frames of the profiler that became complete, and write the file once all frames are in.
+    /// Called on the main thread once per frame, after Profiler::NextFrame().
+    void Update(const Profiler& profiler);
+
+    /// Whether frames are being captured
+    [[nodiscard]] bool Capturing() const { return num_frames_ != 0; }
+    /// Number of frames captured so far by the capture in progress, or by the last one
+    [[nodiscard]] unsigned int NumCaptured() const { return num_captured_; }
+    /// Path of the last file written, empty if none or if writing failed
+    [[nodiscard]] const std::string& LastPath();
+
+    /// Default size of the capture buffer, enough for about a hundred thousand zones
+    static constexpr size_t kDefaultCapacity = 16 * 1024 * 1024;
+    /// Frames waited for the GPU timings of a frame, see opengl::GpuTimer
+    static constexpr size_t kGpuLatency = 4;
+
+   private:
+    /// Serialize a frame, returns false if it does not fit
+    bool AddFrame(const ProfileFrame& frame);
+
+    /// Close the trace and write it on a loader thread
+    void Finish(const Profiler& profiler);
+
+    /// Append an event, or a part of one, to the buffer
+    void BeginEvent();  ///< separates the event from the previous one
+    void Append(std::string_view text);
+    void AppendString(std::string_view text);  ///< quoted and escaped
+    void AppendUInt(uint64_t value);
+    void AppendMicros(uint64_t ns);
+    void AppendTime(uint64_t ns);  ///< in microseconds since the capture start
+    void AppendZone(const ProfileZone& zone, uint64_t tid, std::string_view category);
+
+   private:
+    /// Thread ids of the tracks of the GPU passes and of the frames, after those of the profiled threads
+    static constexpr uint64_t kGpuTid = 1000;
+    static constexpr uint64_t kFrameTid = 1001;
+
+   private:
+    std::shared_ptr<platform::FileSystem> filesystem_;
+    std::vector<char> buffer_;
+    size_t size_ = 0;        ///< bytes used in the buffer
+    size_t limit_ = 0;       ///< bytes usable in the buffer, the end of it is kept for the metadata
+    bool overflow_ = false;  ///< whether an event did not fit, ends the capture
+    unsigned int num_frames_ = 0;
+    unsigned int num_captured_ = 0;
+    uint64_t next_frame_ = 0;  ///< number of the next frame to serialize
+    uint64_t origin_ns_ = 0;   ///< time zero of the trace
+    std::future<std::string> writing_;
+    std::string last_path_;
+};
+
+}  // namespace firstgame::system
+
+#endif  // FIRSTGAME_SYSTEM_TRACE_CAPTURE_H_
@@ -14,6 +14,9 @@ class Currenton {
         return *static_cast<C*>(s_current_);
     }
 
+    /// Current instance, or null if there is none, e.g. outside of its owner's lifetime
+    static C* try_current() { return static_cast<C*>(s_current_); }
+
    protected:
     Currenton() { s_current_ = this; }
     virtual ~Currenton()
@@ -0,0 +1,145 @@
+#ifndef FIRSTGAME_UTIL_FRAME_ARENA_H_
+#define FIRSTGAME_UTIL_FRAME_ARENA_H_
+
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <memory_resource>
+
+#include "currenton.h"
+
+namespace firstgame::util {
+
+/// LinearArena is a bump pointer memory resource over a buffer, whose allocations are all released at once by
+/// Reset(), in constant time. Deallocating is a no-op. Allocations that do not fit the buffer fall back to the
+/// upstream resource and are released on Reset(), which then grows the buffer past the high-water mark, so that
+/// an overflow does not repeat on the next frames.
+class LinearArena final : public std::pmr::memory_resource {
+   public:
+    explicit LinearArena(size_t capacity, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : buffer_(std::make_unique<std::byte[]>(capacity)), capacity_(capacity), upstream_(upstream)
+    {
+    }
+    ~LinearArena() override { ReleaseOverflows(); }
+    LinearArena(LinearArena&&) = delete;
+    LinearArena& operator=(LinearArena&&) = delete;
+
+    /// Release all the allocations, and grow the buffer if it overflowed since the last reset
+    void Reset()
+    {
+        const bool overflowed = overflows_ != nullptr;
+        ReleaseOverflows();
+        if (overflowed && high_water_ > capacity_) {
+            capacity_ = std::max(capacity_, high_water_) * 2;  // slack for the alignment padding
+            buffer_ = std::make_unique<std::byte[]>(capacity_);
+        }
+        offset_ = 0;
+    }
+
+    /// Bytes allocated since the last reset, overflows included
+    [[nodiscard]] size_t Used() const { return offset_ + overflow_bytes_; }
+    [[nodiscard]] size_t Capacity() const { return capacity_; }
+    /// Most bytes allocated between two resets
+    [[nodiscard]] size_t HighWater() const { return high_water_; }
+    /// Number of allocations that fell back to the upstream resource, since construction
+    [[nodiscard]] uint64_t NumOverflows() const { return num_overflows_; }
+
+   private:
+    /// Header of an allocation fallen back to the upstream resource, at the start of its block
+    struct Overflow {
+        Overflow* next;
+        size_t size;
+        size_t alignment;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        const auto base = reinterpret_cast<uintptr_t>(buffer_.get());
+        const uintptr_t aligned = (base + offset_ + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        if (aligned + bytes <= base + capacity_) {
+            offset_ = aligned + bytes - base;
+            high_water_ = std::max(high_water_, Used());
+            return reinterpret_cast<void*>(aligned);
+        }
+        // block of the header followed by the allocation, aligned for both
+        const size_t block_alignment = std::max(alignment, alignof(Overflow));
+        const size_t header_size = (sizeof(Overflow) + block_alignment - 1) & ~(block_alignment - 1);
+        auto* block = static_cast<std::byte*>(upstream_->allocate(header_size + bytes, block_alignment));
+        overflows_ = new (block) Overflow{ overflows_, header_size + bytes, block_alignment };
+        overflow_bytes_ += bytes;
+        num_overflows_++;
+        high_water_ = std::max(high_water_, Used());
+        return block + header_size;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void ReleaseOverflows()
+    {
+        while (overflows_) {
+            Overflow* overflow = std::exchange(overflows_, overflows_->next);
+            upstream_->deallocate(overflow, overflow->size, overflow->alignment);
+        }
+        overflow_bytes_ = 0;
+    }
+
+   private:
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t capacity_;
+    size_t offset_ = 0;
+    std::pmr::memory_resource* upstream_;
+    Overflow* overflows_ = nullptr;  ///< allocations fallen back to upstream since the last reset, newest first
+    size_t overflow_bytes_ = 0;
+    size_t high_water_ = 0;
+    uint64_t num_overflows_ = 0;
+};
+
+/// FrameArena holds the transient allocations of the frames, like per-frame scratch containers and command lists,
+/// in two linear arenas used on alternate frames. What is allocated during a frame stays valid until the end of
+/// the next one, so the frame being submitted keeps its data while the next one is simulated, and an arena is
+/// reset in constant time once both frames are done. Not thread-safe: only the thread simulating the frame
+/// allocates from it, and NextFrame() is called while no frame is being simulated.
+/// Example:
+/// ```
+///  std::pmr::vector<CellCoord> missing(util::FrameArena::current().Resource());
+/// ```
+class FrameArena final : public Currenton<FrameArena> {
+   public:
+    static constexpr size_t kDefaultCapacity = 256 * 1024;
+
+    explicit FrameArena(size_t capacity = kDefaultCapacity) : arenas_{ LinearArena(capacity), LinearArena(capacity) }
+    {
+    }
+
+    /// Memory resource of the current frame
+    [[nodiscard]] auto Resource() -> std::pmr::memory_resource* { return &arenas_[current_]; }
+
+    /// Switch to the next frame, releasing the allocations of the frame before the current one
+    void NextFrame()
+    {
+        current_ ^= 1;
+        arenas_[current_].Reset();
+    }
+
+    /// Arena of the current frame
+    [[nodiscard]] auto Current() const -> const LinearArena& { return arenas_[current_]; }
+
+    /// Most bytes allocated in a frame
+    [[nodiscard]] size_t HighWater() const { return std::max(arenas_[0].HighWater(), arenas_[1].HighWater()); }
+
+    /// Number of allocations that did not fit their arena and went to the heap
+    [[nodiscard]] uint64_t NumOverflows() const { return arenas_[0].NumOverflows() + arenas_[1].NumOverflows(); }
+
+   private:
+    LinearArena arenas_[2];
+    unsigned int current_ = 0;
+};
+
+}  // namespace firstgame::util
+
+#endif  // FIRSTGAME_UTIL_FRAME_ARENA_H_
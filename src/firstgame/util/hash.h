@@ -0,0 +1,32 @@
+#ifndef FIRSTGAME_UTIL_HASH_H_
+#define FIRSTGAME_UTIL_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace firstgame::util {
+
+/// Offset basis of the 64-bit FNV-1a hash, the hash of no data
+inline constexpr uint64_t kFnv1aBasis = 14695981039346656037ull;
+
+/// 64-bit FNV-1a hash of the data, continuing from `hash` to hash data in pieces.
+/// Stable across runs and platforms, so it can be persisted.
+constexpr uint64_t Fnv1a(const unsigned char* data, size_t size, uint64_t hash = kFnv1aBasis)
+{
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/// 64-bit FNV-1a hash of a string
+inline uint64_t Fnv1a(std::string_view str, uint64_t hash = kFnv1aBasis)
+{
+    return Fnv1a(reinterpret_cast<const unsigned char*>(str.data()), str.size(), hash);
+}
+
+}  // namespace firstgame::util
+
+#endif  // FIRSTGAME_UTIL_HASH_H_
@@ -0,0 +1,485 @@
+/**
+ * Benchmarks of asset loading: reading files into memory against mapping them, opening the shipped assets from
+ * the asset pack against from loose files, the mesh import path from a binary mesh file to the GPU against
+ * importing the model with Assimp as it was before, building shader programs from sources against from the program
+ * binary cache, and the offline optimizations of the mesh import tool.
+ */
+
+#include <array>
+#include <random>
+#include <string>
+#include <optional>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <sstream>
+#include <filesystem>
+#include <glm/vec3.hpp>
+#include <glm/gtc/packing.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include "headless.h"
+#include "optimizer.h"
+#include "firstgame/render/mesh_format.h"
+#include "firstgame/render/mesh_loader.h"
+#include "firstgame/render/shader_lib.h"
+#include "firstgame/opengl/shader.h"
+#include "firstgame/opengl/program_cache.h"
+#include "firstgame/system/log.h"
+#include "firstgame/system/asset_mgr.h"
+#include "firstgame/opengl/stub/gl_stub.h"
+
+using namespace firstgame;
+using namespace firstgame::tools::bench;
+using render::mesh_format::MeshHeader;
+using render::mesh_format::PackedVertex;
+
+/**************************************************************************************************/
+
+/// Path of a temporary file of the benchmarks
+static std::filesystem::path TempPath(const std::string& name)
+{
+    return std::filesystem::temp_directory_path() / "firstgame_bench" / name;
+}
+
+/// File of `size` bytes of pseudo-random content, kept between runs as the largest take seconds to write
+static std::filesystem::path MakeFile(platform::FileSystem& filesystem, size_t size)
+{
+    const std::filesystem::path path = TempPath("file-" + std::to_string(size) + ".bin");
+    std::error_code error;
+    if (std::filesystem::file_size(path, error) == size) {
+        return path;
+    }
+    std::vector<uint32_t> content((size + 3) / 4);
+    std::mt19937 rng(1);
+    std::generate(content.begin(), content.end(), rng);
+    filesystem.Write(path.c_str(), content.data(), size);
+    return path;
+}
+
+/// Peak resident memory of running `load` once, in bytes above the resident memory at its start. It runs in a
+/// forked child, so that the peak is that of this load alone rather than the highest of the whole process.
+/// Returns 0 if the child could not be run.
+template<typename Load>
+static double PeakRss(Load&& load)
+{
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        return 0.0;
+    }
+    const pid_t pid = ::fork();
+    if (pid == 0) {
+        ::close(fds[0]);
+        rusage usage{};
+        ::getrusage(RUSAGE_SELF, &usage);
+        const long start_kb = usage.ru_maxrss;
+        load();
+        ::getrusage(RUSAGE_SELF, &usage);
+        const long peak_kb = usage.ru_maxrss - start_kb;
+        [[maybe_unused]] const ssize_t written = ::write(fds[1], &peak_kb, sizeof(peak_kb));
+        ::_exit(0);
+    }
+    ::close(fds[1]);
+    long peak_kb = 0;
+    if (pid < 0 || ::read(fds[0], &peak_kb, sizeof(peak_kb)) != sizeof(peak_kb)) {
+        peak_kb = 0;
+    }
+    ::close(fds[0]);
+    if (pid > 0) {
+        ::waitpid(pid, nullptr, 0);
+    }
+    return static_cast<double>(peak_kb) * 1024.0;
+}
+
+/// Open a file and copy its content into memory, as assets were read before files were mapped
+static void ReadFile(platform::FileSystem& filesystem, const std::filesystem::path& path)
+{
+    auto file = filesystem.Open(path.c_str());
+    const std::string content = file->ReadToString();
+    benchmark::DoNotOptimize(content.data());
+    file->Close();
+}
+
+/// Open a file and map its content, touching every page as a reader would. Returns false if it cannot be mapped.
+static bool MapFile(platform::FileSystem& filesystem, const std::filesystem::path& path)
+{
+    auto file = filesystem.Open(path.c_str());
+    const std::optional<platform::FileView> view = file->Map();
+    if (not view) {
+        return false;
+    }
+    unsigned int sum = 0;
+    for (size_t offset = 0; offset < view->size; offset += 4096) {
+        sum += static_cast<unsigned int>(view->data[offset]);
+    }
+    benchmark::DoNotOptimize(sum);
+    file->Close();
+    return true;
+}
+
+/// Read files into memory, reporting the peak resident memory of a read as "peak_rss"
+static void BM_ReadFile(benchmark::State& state)
+{
+    const auto filesystem = BenchFileSystem();
+    const auto size = static_cast<size_t>(state.range(0));
+    const std::filesystem::path path = MakeFile(*filesystem, size);
+    for (auto _ : state) {
+        ReadFile(*filesystem, path);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+    state.counters["peak_rss"] = benchmark::Counter(PeakRss([&] { ReadFile(*filesystem, path); }),
+                                                    benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+}
+BENCHMARK(BM_ReadFile)->Arg(64 << 10)->RangeMultiplier(8)->Range(1 << 20, 1 << 30)->Unit(benchmark::kMicrosecond);
+
+/// Map files, reporting the peak resident memory of a mapping as "peak_rss", which counts the page cache pages
+/// it maps but not a copy
+static void BM_MapFile(benchmark::State& state)
+{
+    const auto filesystem = BenchFileSystem();
+    const auto size = static_cast<size_t>(state.range(0));
+    const std::filesystem::path path = MakeFile(*filesystem, size);
+    for (auto _ : state) {
+        if (not MapFile(*filesystem, path)) {
+            state.SkipWithError("files cannot be mapped");
+            return;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+    state.counters["peak_rss"] = benchmark::Counter(PeakRss([&] { MapFile(*filesystem, path); }),
+                                                    benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+}
+BENCHMARK(BM_MapFile)->Arg(64 << 10)->RangeMultiplier(8)->Range(1 << 20, 1 << 30)->Unit(benchmark::kMicrosecond);
+
+/**************************************************************************************************/
+
+/// Paths of the shipped assets, relative to the assets directory
+static std::vector<std::filesystem::path> ShippedAssets()
+{
+    const std::filesystem::path assets_dir(FIRSTGAME_ASSETS_DIR_PATH);
+    std::vector<std::filesystem::path> assetpaths;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(assets_dir)) {
+        if (entry.is_regular_file()) {
+            assetpaths.push_back(std::filesystem::relative(entry.path(), assets_dir));
+        }
+    }
+    return assetpaths;
+}
+
+/// Drop the pages of a file from the page cache, so that it is next read from the disk. Pages still mapped stay.
+static void DropFromPageCache(const std::filesystem::path& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    ::fdatasync(fd);  // dirty pages are not dropped
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+/// Open every shipped asset through the asset manager and touch every page of its content, as loaders would
+static void OpenAssets(benchmark::State& state, system::AssetManager& assets,
+                       const std::vector<std::filesystem::path>& assetpaths)
+{
+    unsigned int sum = 0;
+    for (const auto& assetpath : assetpaths) {
+        auto asset = assets.Open(assetpath);
+        if (not asset) {
+            state.SkipWithError("failed to open a shipped asset");
+            return;
+        }
+        const auto bytes = asset->Bytes();
+        for (size_t offset = 0; offset < bytes.size(); offset += 4096) {
+            sum += static_cast<unsigned int>(bytes[offset]);
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+}
+
+/// Open the shipped assets with their files in the page cache, from loose files (pack:0) or from the asset pack
+/// built by firstgame_pack (pack:1), mounted beforehand
+static void BM_OpenAssetsWarm(benchmark::State& state)
+{
+    system::Logger logger(BenchLogger());
+    system::AssetManager assets(BenchFileSystem());
+    assets.Unmount();
+    if (state.range(0) && not assets.Mount(FIRSTGAME_BENCH_PACK_PATH)) {
+        state.SkipWithError("asset pack not found");
+        return;
+    }
+    const std::vector<std::filesystem::path> assetpaths = ShippedAssets();
+    OpenAssets(state, assets, assetpaths);  // fill the page cache
+    for (auto _ : state) {
+        OpenAssets(state, assets, assetpaths);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(assetpaths.size()));
+}
+BENCHMARK(BM_OpenAssetsWarm)->ArgName("pack")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+/// Open the shipped assets with their files dropped from the page cache, as on the first start of the game, from
+/// loose files (pack:0) or from the asset pack (pack:1), mounting it included since its mapping must be released
+/// for its pages to be dropped
+static void BM_OpenAssetsCold(benchmark::State& state)
+{
+    system::Logger logger(BenchLogger());
+    system::AssetManager assets(BenchFileSystem());
+    assets.Unmount();
+    const std::filesystem::path assets_dir(FIRSTGAME_ASSETS_DIR_PATH);
+    const std::vector<std::filesystem::path> assetpaths = ShippedAssets();
+    for (auto _ : state) {
+        state.PauseTiming();
+        assets.Unmount();
+        DropFromPageCache(FIRSTGAME_BENCH_PACK_PATH);
+        for (const auto& assetpath : assetpaths) {
+            DropFromPageCache(assets_dir / assetpath);
+        }
+        state.ResumeTiming();
+        if (state.range(0) && not assets.Mount(FIRSTGAME_BENCH_PACK_PATH)) {
+            state.SkipWithError("asset pack not found");
+            return;
+        }
+        OpenAssets(state, assets, assetpaths);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(assetpaths.size()));
+}
+BENCHMARK(BM_OpenAssetsCold)->ArgName("pack")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+/**************************************************************************************************/
+
+/// Triangulated grid of `side` x `side` vertices on the XZ plane, its triangles shuffled as a model may come
+static void GridMesh(uint32_t side, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices)
+{
+    positions.clear();
+    indices.clear();
+    for (uint32_t z = 0; z < side; z++) {
+        for (uint32_t x = 0; x < side; x++) {
+            positions.emplace_back(float(x), 0.0f, float(z));
+        }
+    }
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t z = 0; z + 1 < side; z++) {
+        for (uint32_t x = 0; x + 1 < side; x++) {
+            const uint32_t v = z * side + x;
+            triangles.push_back({ v, v + side, v + 1 });
+            triangles.push_back({ v + 1, v + side, v + side + 1 });
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(1));
+    for (const auto& triangle : triangles) {
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+    }
+}
+
+/// Binary mesh (.fgmesh) of a grid, laid out as the mesh import tool writes it
+static std::vector<std::byte> GridMeshFile(uint32_t side)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    GridMesh(side, positions, indices);
+    const auto align = [](uint64_t offset) {
+        return (offset + render::mesh_format::kMeshAlignment - 1) / render::mesh_format::kMeshAlignment *
+               render::mesh_format::kMeshAlignment;
+    };
+    MeshHeader header{
+        .magic = {},
+        .version = render::mesh_format::kVersion,
+        .num_vertices = static_cast<uint32_t>(positions.size()),
+        .num_indices = static_cast<uint32_t>(indices.size()),
+        .bounds = { side / 2.0f, 0.0f, side / 2.0f, side * 0.75f },
+        .vertex_offset = align(sizeof(MeshHeader)),
+        .index_offset = 0,
+    };
+    std::memcpy(header.magic, render::mesh_format::kMagic, sizeof(header.magic));
+    header.index_offset = align(header.vertex_offset + positions.size() * sizeof(PackedVertex));
+    std::vector<std::byte> bytes(header.index_offset + indices.size() * sizeof(uint16_t));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    auto* vertices = reinterpret_cast<PackedVertex*>(bytes.data() + header.vertex_offset);
+    for (size_t v = 0; v < positions.size(); v++) {
+        vertices[v] = PackedVertex{
+            .position = { glm::packHalf1x16(positions[v].x), glm::packHalf1x16(positions[v].y),
+                          glm::packHalf1x16(positions[v].z), 0 },
+            .color = { 255, 255, 255, 255 },
+        };
+    }
+    auto* packed_indices = reinterpret_cast<uint16_t*>(bytes.data() + header.index_offset);
+    std::copy(indices.begin(), indices.end(), packed_indices);
+    return bytes;
+}
+
+/// Mesh import at runtime: map the binary mesh, validate it in place and upload it
+static void BM_MeshImport(benchmark::State& state)
+{
+    Headless engine;
+    const auto filesystem = BenchFileSystem();
+    const auto side = static_cast<uint32_t>(state.range(0));
+    const std::vector<std::byte> content = GridMeshFile(side);
+    const std::filesystem::path path = TempPath("grid-" + std::to_string(side) + ".fgmesh");
+    filesystem->Write(path.c_str(), content.data(), content.size());
+    const auto& shader = render::ShaderLibrary::current().get(render::MyShader::SIMPLE);
+    for (auto _ : state) {
+        opengl::stub::Reset();
+        auto file = filesystem->Open(path.c_str());
+        const std::optional<platform::FileView> view = file->Map();
+        if (not view) {
+            state.SkipWithError("files cannot be mapped");
+            return;
+        }
+        const render::MeshData data = render::ParseMesh({ view->data, view->size });
+        benchmark::DoNotOptimize(render::UploadMesh(shader, data));
+        file->Close();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(content.size()));
+}
+BENCHMARK(BM_MeshImport)->Arg(32)->Arg(128)->Unit(benchmark::kMicrosecond);
+
+/**************************************************************************************************/
+
+/// Shader program built from its GLSL sources, as on a launch without a program binary cache or with a stale one.
+/// The stub does not compile, so this times the engine's side of the build only, to compare with the warm path.
+static void BM_ShaderBuildCold(benchmark::State& state)
+{
+    Headless engine;
+    auto& assets = system::AssetManager::current();
+    const auto vert = assets.Load("shaders/main.vert");
+    const auto frag = assets.Load("shaders/main.frag");
+    for (auto _ : state) {
+        auto shader = opengl::GLShader::build("simple", { vert->View(), frag->View() }, true);
+        if (not shader) {
+            state.SkipWithError("failed to build the shader");
+            return;
+        }
+    }
+}
+BENCHMARK(BM_ShaderBuildCold)->Unit(benchmark::kMicrosecond);
+
+/// Shader program created from the binary read from the program binary cache, as on later launches
+static void BM_ShaderBuildWarm(benchmark::State& state)
+{
+    Headless engine;
+    auto& assets = system::AssetManager::current();
+    const auto vert = assets.Load("shaders/main.vert");
+    const auto frag = assets.Load("shaders/main.frag");
+    const opengl::ProgramCache cache(assets.Storage());
+    if (not cache.enabled()) {
+        state.SkipWithError("program binary cache disabled");
+        return;
+    }
+    const opengl::ShaderSourceArray sources{ vert->View(), frag->View() };
+    const uint64_t key = cache.key(sources);
+    auto built = opengl::GLShader::build("simple", sources, true);
+    const auto binary = built ? built->binary() : std::nullopt;
+    if (not binary || not cache.write("simple", key, *binary)) {
+        state.SkipWithError("failed to cache the shader binary");
+        return;
+    }
+    for (auto _ : state) {
+        const auto binary = cache.read("simple", key);
+        auto shader = binary ? opengl::GLShader::from_binary("simple", *binary) : util::Scoped<opengl::GLShader>{};
+        if (not shader) {
+            state.SkipWithError("cached binary rejected");
+            return;
+        }
+    }
+}
+BENCHMARK(BM_ShaderBuildWarm)->Unit(benchmark::kMicrosecond);
+
+/// Wavefront model (.obj) of a grid, as a model comes before the mesh import tool
+static std::string GridObjFile(uint32_t side)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    GridMesh(side, positions, indices);
+    std::ostringstream obj;
+    for (const glm::vec3& position : positions) {
+        obj << "v " << position.x << ' ' << position.y << ' ' << position.z << '\n';
+    }
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        obj << "f " << indices[i] + 1 << ' ' << indices[i + 1] + 1 << ' ' << indices[i + 2] + 1 << '\n';
+    }
+    return obj.str();
+}
+
+/// Baseline of BM_MeshImport: import the same grid with Assimp at runtime, with the post-processing of the mesh
+/// import tool, as models were loaded before they were converted offline
+static void BM_AssimpImport(benchmark::State& state)
+{
+    const auto filesystem = BenchFileSystem();
+    const auto side = static_cast<uint32_t>(state.range(0));
+    const std::string content = GridObjFile(side);
+    const std::filesystem::path path = TempPath("grid-" + std::to_string(side) + ".obj");
+    filesystem->Write(path.c_str(), content.data(), content.size());
+    for (auto _ : state) {
+        Assimp::Importer importer;
+        importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+        const aiScene* scene = importer.ReadFile(path.string(), aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
+                                                                    aiProcess_PreTransformVertices | aiProcess_SortByPType);
+        if (scene == nullptr || scene->mNumMeshes == 0) {
+            state.SkipWithError(importer.GetErrorString());
+            return;
+        }
+        benchmark::DoNotOptimize(scene->mMeshes[0]->mVertices);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(content.size()));
+}
+BENCHMARK(BM_AssimpImport)->Arg(32)->Arg(128)->Unit(benchmark::kMicrosecond);
+
+/**************************************************************************************************/
+
+/// Offline vertex cache optimization of the mesh import tool
+static void BM_OptimizeVertexCache(benchmark::State& state)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> shuffled, indices;
+    GridMesh(static_cast<uint32_t>(state.range(0)), positions, shuffled);
+    for (auto _ : state) {
+        state.PauseTiming();
+        indices = shuffled;
+        state.ResumeTiming();
+        tools::mesh::OptimizeVertexCache(indices, positions.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(indices.size() / 3));
+    state.counters["acmr_before"] = tools::mesh::AverageCacheMissRatio(shuffled, positions.size());
+    state.counters["acmr_after"] = tools::mesh::AverageCacheMissRatio(indices, positions.size());
+}
+BENCHMARK(BM_OptimizeVertexCache)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+/// Offline overdraw optimization of the mesh import tool, on a cache optimized mesh
+static void BM_OptimizeOverdraw(benchmark::State& state)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> optimized, indices;
+    GridMesh(static_cast<uint32_t>(state.range(0)), positions, optimized);
+    tools::mesh::OptimizeVertexCache(optimized, positions.size());
+    for (auto _ : state) {
+        state.PauseTiming();
+        indices = optimized;
+        state.ResumeTiming();
+        tools::mesh::OptimizeOverdraw(indices, positions, 1.05f);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(indices.size() / 3));
+    state.counters["acmr"] = tools::mesh::AverageCacheMissRatio(indices, positions.size());
+}
+BENCHMARK(BM_OptimizeOverdraw)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+/// Offline vertex fetch optimization of the mesh import tool
+static void BM_OptimizeVertexFetch(benchmark::State& state)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> shuffled, indices;
+    GridMesh(static_cast<uint32_t>(state.range(0)), positions, shuffled);
+    for (auto _ : state) {
+        state.PauseTiming();
+        indices = shuffled;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(tools::mesh::OptimizeVertexFetch(indices, positions.size()));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(positions.size()));
+}
+BENCHMARK(BM_OptimizeVertexFetch)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,166 @@
+/**
+ * Frame benchmarks of whole scenes: the game itself, and scenes stressing the renderer and the ECS systems.
+ * Each reports the throughput of the frame, the heap allocations per frame and what the renderer drew.
+ */
+
+#include <cmath>
+#include <memory>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "headless.h"
+#include "firstgame/firstgame.h"
+#include "firstgame/opengl/stub/gl_stub.h"
+#include "firstgame/render/motion.h"
+#include "firstgame/render/painter.h"
+#include "firstgame/render/transform.h"
+#include "firstgame/render/shader_lib.h"
+#include "firstgame/render/renderable_instanced.h"
+#include "firstgame/util/frame_arena.h"
+
+using namespace firstgame;
+using namespace firstgame::tools::bench;
+using render::Motion;
+using render::Renderable;
+using render::RenderableInstanced;
+using render::Transform;
+
+/**************************************************************************************************/
+
+/// Place `count` cubes on a square grid in front of the camera, with a Motion if `moving`
+static void AddCubes(Headless& engine, size_t count, bool moving)
+{
+    auto& registry = engine.Registry();
+    const auto side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    for (size_t i = 0; i < count; i++) {
+        const entt::entity entity = registry.create();
+        registry.emplace<Transform>(entity, Transform{
+                                                .position = glm::vec3(float(i % side) * 2.0f, -3.0f, float(i / side) * 2.0f),
+                                                .scale = glm::vec3(0.5f),
+                                                .rotation = glm::quat(1.0f, glm::vec3(0.0f)),
+                                            });
+        if (moving) {
+            registry.emplace<Motion>(entity, Motion{
+                                                 .velocity = glm::vec3(float(i % 7) * 10.0f, 20.0f, 30.0f),
+                                                 .acceleration = glm::vec3(0.0f, 0.0f, 1.0f),
+                                             });
+        }
+        registry.emplace<Renderable>(entity, engine.Cube());
+    }
+}
+
+/**************************************************************************************************/
+
+/// The game as the platforms run it, through FirstGame::New() and Update(). Once the startup loads completed and
+/// the containers reached their size, an Update must not allocate from the heap: the benchmark fails if it does.
+static void BM_FirstGameUpdate(benchmark::State& state)
+{
+    auto game = FirstGame::New(1280, 720, BenchLogger(), BenchFileSystem());
+    // steady once a second of frames went by without allocating
+    int steady_frames = 0;
+    for (int frame = 0; frame < 10000 && steady_frames < 60; frame++) {
+        const AllocCounter allocs;
+        opengl::stub::Reset();
+        game->Update(kDeltaTime);
+        steady_frames = allocs.Count() ? 0 : steady_frames + 1;
+    }
+    AllocCounter allocs;
+    for (auto _ : state) {
+        opengl::stub::Reset();
+        game->Update(kDeltaTime);
+    }
+    allocs.Report(state);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["gl_calls"] = static_cast<double>(opengl::stub::Calls().size());
+    const util::FrameArena& arena = util::FrameArena::current();
+    state.counters["arena_bytes"] = static_cast<double>(arena.HighWater());
+    state.counters["arena_overflows"] = static_cast<double>(arena.NumOverflows());
+    if (allocs.Count()) {
+        state.SkipWithError("steady-state Update allocated from the heap");
+    }
+}
+BENCHMARK(BM_FirstGameUpdate)->Unit(benchmark::kMillisecond);
+
+/**************************************************************************************************/
+
+/// Static non-instanced cubes sharing a mesh, culled and batched by the renderer
+static void BM_ManyRenderables(benchmark::State& state)
+{
+    Headless engine;
+    const auto count = static_cast<size_t>(state.range(0));
+    AddCubes(engine, count, false);
+    engine.Frame(kDeltaTime);  // world matrices and spatial index built on the first frame
+
+    AllocCounter allocs;
+    for (auto _ : state) {
+        engine.Frame(kDeltaTime);
+    }
+    allocs.Report(state);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+    ReportRender(state, engine.Renderer().Stats());
+    state.counters["gl_calls"] = static_cast<double>(opengl::stub::Calls().size());
+}
+BENCHMARK(BM_ManyRenderables)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+/**************************************************************************************************/
+
+/// Waving grid of instanced cubes, whose transforms are re-written, culled and streamed every frame
+static void BM_InstancedGrid(benchmark::State& state)
+{
+    Headless engine;
+    const auto rows = static_cast<unsigned int>(state.range(0));
+    const auto cols = static_cast<unsigned int>(state.range(1));
+    auto& registry = engine.Registry();
+    const entt::entity grid = registry.create();
+    auto& renderable = registry.emplace<RenderableInstanced>(
+        grid, render::GenerateCubeInstanced(render::ShaderLibrary::current().get(render::MyShader::SIMPLE_INSTANCE), rows, cols));
+    renderable.models.resize(size_t(rows) * cols);
+
+    float time = 0.0f;
+    const auto wave = [&] {
+        time += kDeltaTime;
+        const glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(0.5f));
+        for (unsigned int i = 0; i < rows; i++) {
+            for (unsigned int j = 0; j < cols; j++) {
+                const float height = -3.0f + 0.5f * std::sin(2.0f * time + 0.3f * float(i + j));
+                renderable.models[i * cols + j] = glm::translate(glm::mat4(1.0f), glm::vec3(float(i), height, float(j))) * scale;
+            }
+        }
+    };
+    wave();
+    engine.Frame(kDeltaTime);
+
+    AllocCounter allocs;
+    for (auto _ : state) {
+        wave();
+        engine.Frame(kDeltaTime);
+    }
+    allocs.Report(state);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(rows * cols));
+    ReportRender(state, engine.Renderer().Stats());
+}
+BENCHMARK(BM_InstancedGrid)->Args({ 50, 100 })->Args({ 200, 250 })->Args({ 400, 500 })->Unit(benchmark::kMillisecond);
+
+/**************************************************************************************************/
+
+/// Moving cubes, integrated by the MotionSystem across the job threads then re-indexed and rendered
+static void BM_HeavyMotion(benchmark::State& state)
+{
+    Headless engine;
+    const auto count = static_cast<size_t>(state.range(0));
+    engine.System().Jobs().SetMaxThreads(static_cast<unsigned int>(state.range(1)));
+    AddCubes(engine, count, true);
+    engine.Frame(kDeltaTime);
+
+    AllocCounter allocs;
+    for (auto _ : state) {
+        engine.Frame(kDeltaTime);
+    }
+    allocs.Report(state);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+    ReportRender(state, engine.Renderer().Stats());
+}
+BENCHMARK(BM_HeavyMotion)
+    ->ArgsProduct({ { 10000, 100000 }, { 1, 2, 4, 8 } })
+    ->ArgNames({ "entities", "threads" })
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,370 @@
+/**
+ * Benchmarks of the engine's building blocks on their own: the Motion integration kernels, the dynamic AABB
+ * tree of the spatial index, the scene snapshots, the GL state cache, the profiler zones and the mip downsampling.
+ */
+
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <utility>
+#include <algorithm>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <entt/entity/registry.hpp>
+
+#include "headless.h"
+#include "firstgame/render/aabb.h"
+#include "firstgame/render/aabb_tree.h"
+#include "firstgame/render/frustum.h"
+#include "firstgame/render/motion.h"
+#include "firstgame/render/motion_integrator.h"
+#include "firstgame/render/scene_snapshot.h"
+#include "firstgame/render/transform.h"
+#include "firstgame/render/image.h"
+#include "firstgame/system/log.h"
+#include "firstgame/system/profiler.h"
+#include "firstgame/opengl/state_cache.h"
+#include "firstgame/opengl/stub/gl_stub.h"
+
+using namespace firstgame;
+using namespace firstgame::tools::bench;
+using render::Aabb;
+using render::AabbTree;
+
+/**************************************************************************************************/
+
+/// One integration step of a structure-of-arrays batch, with the kernel of each instruction set
+static void BM_IntegrateMotion(benchmark::State& state)
+{
+    const auto level = static_cast<render::SimdLevel>(state.range(0));
+    if (level > render::DetectSimdLevel()) {
+        state.SkipWithError("instruction set not supported by the build or the CPU");
+        return;
+    }
+    const auto count = static_cast<size_t>(state.range(1));
+    std::vector<float> velocity[3], acceleration[3], rotation[4];
+    for (auto& array : velocity) {
+        array.assign(count, 30.0f);
+    }
+    for (auto& array : acceleration) {
+        array.assign(count, 1.0f);
+    }
+    for (auto& array : rotation) {
+        array.assign(count, 0.0f);
+    }
+    rotation[3].assign(count, 1.0f);
+    const render::MotionBatch batch{
+        .velocity = { velocity[0].data(), velocity[1].data(), velocity[2].data() },
+        .acceleration = { acceleration[0].data(), acceleration[1].data(), acceleration[2].data() },
+        .rotation = { rotation[0].data(), rotation[1].data(), rotation[2].data(), rotation[3].data() },
+        .size = count,
+    };
+    for (auto _ : state) {
+        render::IntegrateMotion(batch, kDeltaTime, level);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_IntegrateMotion)
+    ->ArgsProduct({ { int(render::SimdLevel::Scalar), int(render::SimdLevel::SSE2), int(render::SimdLevel::AVX2) },
+                    { 1 << 10, 1 << 17 } })
+    ->ArgNames({ "simd", "entities" });
+
+/**************************************************************************************************/
+
+/// Unit boxes scattered in a cube of side proportional to the cubic root of their number, at constant density
+static std::vector<Aabb> RandomBoxes(size_t count, uint32_t seed = 1)
+{
+    std::mt19937 rng(seed);
+    const float side = 4.0f * std::cbrt(static_cast<float>(count));
+    std::uniform_real_distribution<float> coord(0.0f, side);
+    std::vector<Aabb> boxes(count);
+    for (Aabb& box : boxes) {
+        const glm::vec3 min(coord(rng), coord(rng), coord(rng));
+        box = Aabb{ min, min + 1.0f };
+    }
+    return boxes;
+}
+
+/// Insertion of all the proxies into an empty tree
+static void BM_AabbTreeBuild(benchmark::State& state)
+{
+    const std::vector<Aabb> boxes = RandomBoxes(static_cast<size_t>(state.range(0)));
+    AabbTree tree;
+    for (auto _ : state) {
+        tree.Clear();
+        for (size_t i = 0; i < boxes.size(); i++) {
+            tree.CreateProxy(boxes[i], static_cast<uint32_t>(i));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["height"] = tree.Height();
+}
+BENCHMARK(BM_AabbTreeBuild)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+/// Small moves of every proxy, mostly within their fat box, some enlarging it and refitting the ancestors
+static void BM_AabbTreeRefit(benchmark::State& state)
+{
+    std::vector<Aabb> boxes = RandomBoxes(static_cast<size_t>(state.range(0)));
+    AabbTree tree;
+    std::vector<int32_t> proxies(boxes.size());
+    for (size_t i = 0; i < boxes.size(); i++) {
+        proxies[i] = tree.CreateProxy(boxes[i], static_cast<uint32_t>(i));
+    }
+    float step = 0.05f;
+    size_t changed = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < boxes.size(); i++) {
+            boxes[i].min.x += step;
+            boxes[i].max.x += step;
+            changed += tree.MoveProxy(proxies[i], boxes[i]);
+        }
+        step = -step;  // back and forth, the tree does not drift apart
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["changed"] = benchmark::Counter(static_cast<double>(changed), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_AabbTreeRefit)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+/// Frustum query of a camera looking across the boxes
+static void BM_AabbTreeQuery(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    const std::vector<Aabb> boxes = RandomBoxes(count);
+    AabbTree tree;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        tree.CreateProxy(boxes[i], static_cast<uint32_t>(i));
+    }
+    const float side = 4.0f * std::cbrt(static_cast<float>(count));
+    const glm::mat4 view = glm::lookAt(glm::vec3(-10.0f, side / 2, -10.0f), glm::vec3(side / 2), glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, side);
+    const render::Frustum frustum = render::Frustum::FromMatrix(projection * view);
+    size_t visible = 0;
+    for (auto _ : state) {
+        visible = 0;
+        tree.Query(frustum, [&](uint32_t) {
+            visible++;
+            return true;
+        });
+        benchmark::DoNotOptimize(visible);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+    state.counters["visible"] = static_cast<double>(visible);
+}
+BENCHMARK(BM_AabbTreeQuery)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+/**************************************************************************************************/
+
+/// Registry of `count` cubes, half of them moving, and the mesh table of their cube
+static render::MeshTable AddScene(Headless& engine, entt::registry& registry, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        const entt::entity entity = registry.create();
+        registry.emplace<render::Transform>(entity, render::Transform{
+                                                        .position = glm::vec3(float(i % 1000), 0.0f, float(i / 1000)),
+                                                        .scale = glm::vec3(0.5f),
+                                                        .rotation = glm::quat(1.0f, glm::vec3(0.0f)),
+                                                    });
+        if (i % 2) {
+            registry.emplace<render::Motion>(entity, render::Motion{
+                                                         .velocity = glm::vec3(1.0f),
+                                                         .acceleration = glm::vec3(0.0f),
+                                                     });
+        }
+        registry.emplace<render::Renderable>(entity, engine.Cube());
+    }
+    return { { "cube", engine.Cube().mesh } };
+}
+
+/// Saving a registry into a binary scene
+static void BM_SceneSave(benchmark::State& state)
+{
+    Headless engine;
+    entt::registry registry;
+    const render::MeshTable meshes = AddScene(engine, registry, static_cast<size_t>(state.range(0)));
+    size_t size = 0;
+    for (auto _ : state) {
+        const std::vector<std::byte> bytes = render::SaveScene(registry, meshes);
+        size = bytes.size();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneSave)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+/// Loading a binary scene into an empty registry
+static void BM_SceneLoad(benchmark::State& state)
+{
+    Headless engine;
+    std::vector<std::byte> bytes;
+    render::MeshTable meshes;
+    {
+        entt::registry registry;
+        meshes = AddScene(engine, registry, static_cast<size_t>(state.range(0)));
+        bytes = render::SaveScene(registry, meshes);
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        entt::registry registry;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(render::LoadScene(bytes, registry, meshes));
+        state.PauseTiming();  // not timing the destruction of the registry
+        registry = {};
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes.size()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneLoad)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+/**************************************************************************************************/
+
+/// Set each state twice in a row: a program, a vertex array and a matrix uniform of the program twice over, then
+/// a capability on and off. Eight state changes, each followed by a call that changes nothing.
+static void SetStates(opengl::StateCache& cache)
+{
+    static constexpr float kMatrices[2][16] = { { 1.0f }, { 2.0f } };
+    for (GLuint object : { 1u, 2u }) {
+        for (int repeat = 0; repeat < 2; repeat++) {
+            cache.UseProgram(object);
+            cache.BindVertexArray(object);
+            cache.UniformMatrix4fv(0, kMatrices[object - 1]);
+        }
+    }
+    cache.Enable(GL_DEPTH_TEST);
+    cache.Enable(GL_DEPTH_TEST);
+    cache.Disable(GL_DEPTH_TEST);
+    cache.Disable(GL_DEPTH_TEST);
+}
+
+/// Whether the GL calls recorded by the stub and the counters of the cache are those of SetStates(): one GL call
+/// per state change, and none for the repeated calls
+static bool CheckStateCalls(const opengl::StateCache& cache)
+{
+    namespace stub = opengl::stub;
+    return stub::Calls().size() == 8 && stub::Count("glUseProgram") == 2 && stub::Count("glBindVertexArray") == 2 &&
+           stub::Count("glUniformMatrix4fv") == 2 && stub::Count("glEnable") == 1 && stub::Count("glDisable") == 1 &&
+           cache.counters().issued == 8 && cache.counters().elided == 8;
+}
+
+/// Repeated state changes through the GL state cache, checked against the calls recorded by the stub first, then
+/// timed after Invalidate() so that every frame starts from an unknown state, as after the UI rendered
+static void BM_StateCache(benchmark::State& state)
+{
+    opengl::StateCache cache;
+    for (int pass = 0; pass < 2; pass++) {
+        opengl::stub::Reset();
+        cache.Invalidate();
+        cache.ResetCounters();
+        SetStates(cache);
+        if (not CheckStateCalls(cache)) {
+            state.SkipWithError("state cache issued other GL calls than one per state change");
+            return;
+        }
+    }
+    for (auto _ : state) {
+        opengl::stub::Reset();
+        cache.Invalidate();
+        SetStates(cache);
+    }
+    state.SetItemsProcessed(state.iterations() * 16);
+}
+BENCHMARK(BM_StateCache);
+
+/**************************************************************************************************/
+
+/// Recording nested profiler zones, the cost of a PROFILE_ZONE on the thread it times. The "zone" counter is the time
+/// per zone, budgeted under 50 ns. A frame is ended every 256 iterations as the game ends every frame, so that the
+/// ring buffer does not wrap, its collection on the main thread not timed.
+static void BM_ProfileZone(benchmark::State& state)
+{
+#ifdef FIRSTGAME_PROFILER
+    system::Profiler profiler;
+    uint64_t iterations = 0;
+    for (auto _ : state) {
+        PROFILE_ZONE("outer");
+        {
+            PROFILE_ZONE("inner");
+            benchmark::ClobberMemory();
+        }
+        {
+            PROFILE_ZONE("inner");
+            benchmark::ClobberMemory();
+        }
+        if (++iterations % 256 == 0) {
+            state.PauseTiming();
+            profiler.NextFrame();
+            state.ResumeTiming();
+        }
+    }
+    state.counters["zone"] = benchmark::Counter(static_cast<double>(state.iterations() * 3),
+                                                benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+#else
+    state.SkipWithError("profiler zones compiled out, built without FIRSTGAME_PROFILER");
+#endif
+}
+BENCHMARK(BM_ProfileZone);
+
+/**************************************************************************************************/
+
+/// Reference of DownsampleRgba8(): 2x2 box filter, rounded to nearest, clamped at odd edges
+static void DownsampleReference(const uint8_t* src, uint32_t src_width, uint32_t src_height, uint8_t* dst)
+{
+    const uint32_t width = std::max(src_width / 2, 1u);
+    const uint32_t height = std::max(src_height / 2, 1u);
+    for (uint32_t y = 0; y < height; y++) {
+        const uint32_t y0 = std::min(2 * y, src_height - 1);
+        const uint32_t y1 = std::min(2 * y + 1, src_height - 1);
+        for (uint32_t x = 0; x < width; x++) {
+            const uint32_t x0 = std::min(2 * x, src_width - 1);
+            const uint32_t x1 = std::min(2 * x + 1, src_width - 1);
+            for (uint32_t c = 0; c < 4; c++) {
+                const unsigned int sum = src[(y0 * src_width + x0) * 4 + c] + src[(y0 * src_width + x1) * 4 + c] +
+                                         src[(y1 * src_width + x0) * 4 + c] + src[(y1 * src_width + x1) * 4 + c];
+                dst[(y * width + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+/// Whether DownsampleRgba8() matches the reference on random texels of the size, within the one unit the
+/// vectorized averaging of pairs may round up by
+static bool CheckDownsample(uint32_t src_width, uint32_t src_height)
+{
+    std::vector<uint8_t> src(size_t(src_width) * src_height * 4);
+    std::mt19937 rng(src_width * 31 + src_height);
+    std::generate(src.begin(), src.end(), [&] { return static_cast<uint8_t>(rng()); });
+    const size_t dst_size = size_t(std::max(src_width / 2, 1u)) * std::max(src_height / 2, 1u) * 4;
+    std::vector<uint8_t> expected(dst_size), actual(dst_size);
+    DownsampleReference(src.data(), src_width, src_height, expected.data());
+    render::DownsampleRgba8(reinterpret_cast<const std::byte*>(src.data()), src_width, src_height,
+                            reinterpret_cast<std::byte*>(actual.data()));
+    for (size_t i = 0; i < dst_size; i++) {
+        if (std::abs(int(actual[i]) - int(expected[i])) > 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Downsampling a square rgba level to the next mip level, checked against the scalar reference first, on the
+/// benchmarked size and on odd sizes which end on the scalar tail
+static void BM_DownsampleRgba8(benchmark::State& state)
+{
+    const auto side = static_cast<uint32_t>(state.range(0));
+    const std::pair<uint32_t, uint32_t> sizes[] = { { side, side }, { side + 1, side - 1 }, { 7, 3 }, { 1, 5 } };
+    for (const auto& [width, height] : sizes) {
+        if (not CheckDownsample(width, height)) {
+            state.SkipWithError("downsampled level differs from the scalar reference");
+            return;
+        }
+    }
+    std::vector<std::byte> src(size_t(side) * side * 4, std::byte{ 0x5a });
+    std::vector<std::byte> dst(size_t(side / 2) * (side / 2) * 4);
+    for (auto _ : state) {
+        render::DownsampleRgba8(src.data(), side, side, dst.data());
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(src.size()));
+}
+BENCHMARK(BM_DownsampleRgba8)->Arg(256)->Arg(2048)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,86 @@
+#include "headless.h"
+
+#include <thread>
+#include <chrono>
+#include <filesystem>
+
+#include "firstgame/opengl/stub/gl_stub.h"
+#include "firstgame/render/painter.h"
+#include "firstgame/render/shader_lib.h"
+#include "firstgame/platform/posix_filesystem.h"
+
+namespace firstgame::tools::bench {
+
+/**************************************************************************************************/
+
+std::shared_ptr<spdlog::logger> BenchLogger()
+{
+    auto logger = spdlog::default_logger();
+    logger->set_level(spdlog::level::warn);
+    return logger;
+}
+
+std::shared_ptr<platform::FileSystem> BenchFileSystem()
+{
+    return std::make_shared<platform::PosixFileSystem>(std::filesystem::temp_directory_path() / "firstgame_bench");
+}
+
+/**************************************************************************************************/
+
+Headless::Headless()
+    : system_(BenchLogger(), BenchFileSystem()),
+      renderer_({ util::Width(1280), util::Height(720) }),
+      transform_system_(registry_),
+      motion_system_(registry_),
+      spatial_system_(registry_)
+{
+    FinishLoads();
+    cube_ = render::GenerateCube(render::ShaderLibrary::current().get(render::MyShader::SIMPLE));
+}
+
+Headless::~Headless() = default;
+
+/**************************************************************************************************/
+
+void Headless::FinishLoads()
+{
+    auto& loader = system_.Loader();
+    while (loader.NumPending()) {
+        loader.Upload(std::chrono::seconds(1));
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+/**************************************************************************************************/
+
+void Headless::Frame(float deltatime)
+{
+    opengl::stub::Reset();
+    system_.Profiler().NextFrame();
+    system_.FrameArena().NextFrame();
+    transform_system_.Update(registry_);
+    motion_system_.Update(registry_, system_.Jobs(), deltatime);
+    spatial_system_.Update(registry_);
+    renderer_.Render(registry_);
+    system_.Loader().Upload(std::chrono::microseconds(2000));
+}
+
+/**************************************************************************************************/
+
+void AllocCounter::Report(benchmark::State& state) const
+{
+    const system::AllocCounters end = system::Allocations();
+    state.counters["allocs"] = benchmark::Counter(static_cast<double>(end.count - start_.count),
+                                                  benchmark::Counter::kAvgIterations);
+    state.counters["alloc_bytes"] = benchmark::Counter(static_cast<double>(end.bytes - start_.bytes),
+                                                       benchmark::Counter::kAvgIterations);
+}
+
+void ReportRender(benchmark::State& state, const render::RenderStats& stats)
+{
+    state.counters["draw_calls"] = stats.draw_calls;
+    state.counters["visible"] = stats.simple.visible + stats.instanced.visible;
+    state.counters["culled"] = stats.simple.culled + stats.instanced.culled;
+}
+
+}  // namespace firstgame::tools::bench
@@ -0,0 +1,89 @@
+/**
+ * Headless engine of the benchmarks: the systems, the ECS systems and the renderer running on the OpenGL
+ * recording stub, so the engine runs on machines without a GPU.
+ */
+
+#ifndef FIRSTGAME_TOOLS_BENCH_HEADLESS_H_
+#define FIRSTGAME_TOOLS_BENCH_HEADLESS_H_
+
+#include <memory>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <entt/entity/registry.hpp>
+
+#include "firstgame/system/system.h"
+#include "firstgame/system/alloc_stats.h"
+#include "firstgame/render/renderer.h"
+#include "firstgame/render/renderable.h"
+#include "firstgame/render/render_stats.h"
+#include "firstgame/render/motion_system.h"
+#include "firstgame/render/spatial_system.h"
+#include "firstgame/render/transform_system.h"
+#include "firstgame/platform/filesystem.h"
+
+namespace firstgame::tools::bench {
+
+/// Step of the simulation, as at 60 FPS
+inline constexpr float kDeltaTime = 1.0f / 60.0f;
+
+/// Logger of the benchmarks, logging warnings only so that it does not weigh on the timings
+std::shared_ptr<spdlog::logger> BenchLogger();
+
+/// File system of the benchmarks, with its cache in a temporary directory
+std::shared_ptr<platform::FileSystem> BenchFileSystem();
+
+/// Systems, renderer and registry of a scene, as the game sets them up, with the shaders loaded.
+/// Only one may exist at a time, like the game.
+class Headless final {
+   public:
+    Headless();
+    ~Headless();
+    Headless(const Headless&) = delete;
+    Headless& operator=(const Headless&) = delete;
+
+    [[nodiscard]] auto System() -> system::System& { return system_; }
+    [[nodiscard]] auto Renderer() -> render::Renderer& { return renderer_; }
+    [[nodiscard]] auto Registry() -> entt::registry& { return registry_; }
+
+    /// Cube shared by the objects of the scenes
+    [[nodiscard]] const render::Renderable& Cube() const { return cube_; }
+
+    /// Run the background loads until none is pending
+    void FinishLoads();
+
+    /// Simulate and render a frame, as the game does without pipelining. The GL calls recorded by the stub are
+    /// dropped at the start of the frame, so that they do not pile up.
+    void Frame(float deltatime);
+
+   private:
+    system::System system_;
+    render::Renderer renderer_;
+    entt::registry registry_;
+    render::TransformSystem transform_system_;
+    render::MotionSystem motion_system_;
+    render::SpatialSystem spatial_system_;
+    render::Renderable cube_;
+};
+
+/// Counts the heap allocations of the benchmark loop, reported per iteration. Counted only in builds with
+/// FIRSTGAME_ALLOC_STATS, on with FIRSTGAME_BENCH, see system::Allocations().
+class AllocCounter final {
+   public:
+    AllocCounter() : start_(system::Allocations()) {}
+
+    /// Number of heap allocations since construction
+    [[nodiscard]] uint64_t Count() const { return system::Allocations().count - start_.count; }
+
+    /// Set the "allocs" and "alloc_bytes" counters of the benchmark, per iteration
+    void Report(benchmark::State& state) const;
+
+   private:
+    system::AllocCounters start_;
+};
+
+/// Set the counters of the rendered frame: draw calls, visible and culled objects and instances
+void ReportRender(benchmark::State& state, const render::RenderStats& stats);
+
+}  // namespace firstgame::tools::bench
+
+#endif  // FIRSTGAME_TOOLS_BENCH_HEADLESS_H_
@@ -0,0 +1,22 @@
+#ifndef FIRSTGAME_TOOLS_COMMON_PAD_H_
+#define FIRSTGAME_TOOLS_COMMON_PAD_H_
+
+#include <cstdint>
+#include <ostream>
+
+namespace firstgame::tools {
+
+/// Write zeros up to the next multiple of the alignment, for the aligned blobs of the binary asset formats
+template<uint64_t Alignment>
+void Pad(std::ostream& out)
+{
+    static_assert(Alignment > 0);
+    static constexpr char zeros[Alignment] = {};
+    const auto offset = static_cast<uint64_t>(out.tellp());
+    const uint64_t padding = (Alignment - offset % Alignment) % Alignment;
+    out.write(zeros, static_cast<std::streamsize>(padding));
+}
+
+}  // namespace firstgame::tools
+
+#endif  // FIRSTGAME_TOOLS_COMMON_PAD_H_
@@ -0,0 +1,157 @@
+/**
+ * Mesh importer, converting a 3D model into the binary mesh parsed and uploaded by ParseMesh() and UploadMesh().
+ * Every mesh of the model is merged into one, optimized for the vertex cache, overdraw and vertex fetch,
+ * and quantized to half float positions and normalized byte colors.
+ * Usage: firstgame_mesh <input model> <output .fgmesh>
+ */
+
+#include <vector>
+#include <limits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/packing.hpp>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include "optimizer.h"
+#include "common/pad.h"
+#include "firstgame/render/mesh_format.h"
+
+using namespace firstgame::render::mesh_format;
+using namespace firstgame::tools::mesh;
+using firstgame::tools::Pad;
+
+/// Maximum ratio of cache misses traded for less overdraw
+static constexpr float kOverdrawThreshold = 1.05f;
+
+/// Quantize a color channel in [0,1] to a normalized byte
+static uint8_t PackUnorm(float value)
+{
+    return static_cast<uint8_t>(glm::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input model> <output .fgmesh>\n";
+        return 1;
+    }
+
+    // import, with the node transforms baked into one space and identical vertices welded
+    Assimp::Importer importer;
+    importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+    const aiScene* scene = importer.ReadFile(argv[1], aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
+                                                          aiProcess_PreTransformVertices | aiProcess_SortByPType);
+    if (scene == nullptr || scene->mNumMeshes == 0) {
+        std::cerr << "Failed to import " << argv[1] << ": " << importer.GetErrorString() << "\n";
+        return 1;
+    }
+
+    // merge meshes, colored by their vertex colors or else their material's diffuse color
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec4> colors;
+    std::vector<uint32_t> indices;
+    for (unsigned int m = 0; m < scene->mNumMeshes; m++) {
+        const aiMesh* mesh = scene->mMeshes[m];
+        aiColor4D diffuse(1.0f, 1.0f, 1.0f, 1.0f);
+        scene->mMaterials[mesh->mMaterialIndex]->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse);
+        const auto base = static_cast<uint32_t>(positions.size());
+        for (unsigned int v = 0; v < mesh->mNumVertices; v++) {
+            const aiVector3D& position = mesh->mVertices[v];
+            const aiColor4D& color = mesh->HasVertexColors(0) ? mesh->mColors[0][v] : diffuse;
+            positions.emplace_back(position.x, position.y, position.z);
+            colors.emplace_back(color.r, color.g, color.b, color.a);
+        }
+        for (unsigned int f = 0; f < mesh->mNumFaces; f++) {
+            const aiFace& face = mesh->mFaces[f];
+            if (face.mNumIndices == 3) {
+                indices.insert(indices.end(), { base + face.mIndices[0], base + face.mIndices[1], base + face.mIndices[2] });
+            }
+        }
+    }
+    if (positions.size() > std::numeric_limits<uint16_t>::max() + 1u ||
+        indices.size() > std::numeric_limits<uint16_t>::max()) {
+        std::cerr << "Model too large, " << positions.size() << " vertices and " << indices.size()
+                  << " indices do not fit 16-bit indices\n";
+        return 1;
+    }
+
+    // optimize
+    const float acmr = AverageCacheMissRatio(indices, positions.size());
+    OptimizeVertexCache(indices, positions.size());
+    OptimizeOverdraw(indices, positions, kOverdrawThreshold);
+    const std::vector<uint32_t> remap = OptimizeVertexFetch(indices, positions.size());
+    const float optimized_acmr = AverageCacheMissRatio(indices, positions.size());
+
+    // quantize, in fetch order
+    const auto num_vertices = static_cast<uint32_t>(std::count_if(remap.begin(), remap.end(), [](uint32_t r) {
+        return r != std::numeric_limits<uint32_t>::max();
+    }));
+    std::vector<PackedVertex> vertices(num_vertices);
+    glm::vec3 min{ std::numeric_limits<float>::max() };
+    glm::vec3 max{ std::numeric_limits<float>::lowest() };
+    for (size_t v = 0; v < remap.size(); v++) {
+        if (remap[v] == std::numeric_limits<uint32_t>::max()) {
+            continue;
+        }
+        PackedVertex& packed = vertices[remap[v]];
+        for (int k = 0; k < 3; k++) {
+            packed.position[k] = glm::packHalf1x16(positions[v][k]);
+            packed.color[k] = PackUnorm(colors[v][k]);
+        }
+        packed.position[3] = 0;
+        packed.color[3] = PackUnorm(colors[v][3]);
+        min = glm::min(min, positions[v]);
+        max = glm::max(max, positions[v]);
+    }
+    const glm::vec3 center = (min + max) * 0.5f;
+    float radius = 0.0f;
+    for (size_t v = 0; v < remap.size(); v++) {
+        if (remap[v] != std::numeric_limits<uint32_t>::max()) {
+            radius = std::max(radius, glm::distance(center, positions[v]));
+        }
+    }
+    const std::vector<uint16_t> packed_indices(indices.begin(), indices.end());
+
+    // write
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    if (not out) {
+        std::cerr << "Failed to write " << argv[2] << "\n";
+        return 1;
+    }
+    MeshHeader header{
+        .magic = {},
+        .version = kVersion,
+        .num_vertices = num_vertices,
+        .num_indices = static_cast<uint32_t>(packed_indices.size()),
+        .bounds = { center.x, center.y, center.z, radius },
+        .vertex_offset = 0,
+        .index_offset = 0,
+    };
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    Pad<kMeshAlignment>(out);
+    header.vertex_offset = static_cast<uint64_t>(out.tellp());
+    out.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(vertices.size() * sizeof(PackedVertex)));
+    Pad<kMeshAlignment>(out);
+    header.index_offset = static_cast<uint64_t>(out.tellp());
+    out.write(reinterpret_cast<const char*>(packed_indices.data()),
+              static_cast<std::streamsize>(packed_indices.size() * sizeof(uint16_t)));
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (not out) {
+        std::cerr << "Failed to write " << argv[2] << "\n";
+        return 1;
+    }
+
+    std::cout << "Imported " << num_vertices << " vertices and " << packed_indices.size() / 3 << " triangles, "
+              << "cache miss ratio " << acmr << " -> " << optimized_acmr << "\n";
+    return 0;
+}
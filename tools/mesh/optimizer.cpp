@@ -0,0 +1,277 @@
+#include "optimizer.h"
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <glm/geometric.hpp>
+
+namespace firstgame::tools::mesh {
+
+/**************************************************************************************************/
+
+/// Size of the LRU cache modelled by the Forsyth scoring
+static constexpr int kForsythCacheSize = 32;
+
+/// Forsyth's score of a vertex by its position in the LRU cache and the number of triangles left using it
+static float VertexScore(int cache_position, unsigned int valence)
+{
+    if (valence == 0) {
+        return -1.0f;  // no triangle left using it
+    }
+    float score = 0.0f;
+    if (cache_position >= 0) {
+        if (cache_position < 3) {
+            score = 0.75f;  // used by the last triangle, fixed score so it does not favour strips over fans
+        }
+        else {
+            const float scale = 1.0f / (kForsythCacheSize - 3);
+            score = std::pow(1.0f - float(cache_position - 3) * scale, 1.5f);
+        }
+    }
+    // favour vertices with few triangles left, so lone triangles are not left behind
+    return score + 2.0f / std::sqrt(float(valence));
+}
+
+void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t num_vertices)
+{
+    const size_t num_triangles = indices.size() / 3;
+    if (num_triangles == 0) {
+        return;
+    }
+
+    // triangles adjacent to each vertex, as offsets into a flat array
+    std::vector<unsigned int> valence(num_vertices, 0);
+    for (uint32_t index : indices) {
+        valence[index]++;
+    }
+    std::vector<unsigned int> offsets(num_vertices + 1, 0);
+    std::partial_sum(valence.begin(), valence.end(), offsets.begin() + 1);
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<unsigned int> filled(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++) {
+        adjacency[filled[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<int> cache_position(num_vertices, -1);
+    std::vector<float> vertex_score(num_vertices);
+    for (size_t v = 0; v < num_vertices; v++) {
+        vertex_score[v] = VertexScore(-1, valence[v]);
+    }
+    std::vector<float> triangle_score(num_triangles);
+    std::vector<bool> emitted(num_triangles, false);
+    for (size_t t = 0; t < num_triangles; t++) {
+        triangle_score[t] = vertex_score[indices[t * 3]] + vertex_score[indices[t * 3 + 1]] + vertex_score[indices[t * 3 + 2]];
+    }
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    // LRU cache, with room for the vertices pushed out by the last triangle
+    std::vector<uint32_t> cache, next_cache;
+    cache.reserve(kForsythCacheSize + 3);
+    next_cache.reserve(kForsythCacheSize + 3);
+    size_t next_unemitted = 0;
+
+    while (output.size() < indices.size()) {
+        // best triangle touching the cache, otherwise the next one in input order
+        size_t best = num_triangles;
+        float best_score = -1.0f;
+        for (uint32_t v : cache) {
+            for (unsigned int i = offsets[v]; i < offsets[v] + valence[v]; i++) {
+                const uint32_t t = adjacency[i];
+                if (triangle_score[t] > best_score) {
+                    best = t;
+                    best_score = triangle_score[t];
+                }
+            }
+        }
+        if (best == num_triangles) {
+            while (emitted[next_unemitted]) {
+                next_unemitted++;
+            }
+            best = next_unemitted;
+        }
+
+        // emit it, removing it from the adjacency of its vertices
+        emitted[best] = true;
+        next_cache.clear();
+        for (int k = 0; k < 3; k++) {
+            const uint32_t v = indices[best * 3 + k];
+            output.push_back(v);
+            next_cache.push_back(v);
+            auto begin = adjacency.begin() + offsets[v];
+            auto end = begin + valence[v];
+            std::iter_swap(std::find(begin, end, static_cast<uint32_t>(best)), end - 1);
+            valence[v]--;
+        }
+        for (uint32_t v : cache) {
+            if (std::find(next_cache.begin(), next_cache.begin() + 3, v) == next_cache.begin() + 3) {
+                next_cache.push_back(v);
+            }
+        }
+        std::swap(cache, next_cache);
+
+        // rescore the vertices in the cache and their triangles, dropping the ones pushed out
+        for (size_t i = 0; i < cache.size(); i++) {
+            const uint32_t v = cache[i];
+            const int position = i < kForsythCacheSize ? static_cast<int>(i) : -1;
+            cache_position[v] = position;
+            const float delta = VertexScore(position, valence[v]) - vertex_score[v];
+            vertex_score[v] += delta;
+            for (unsigned int j = offsets[v]; j < offsets[v] + valence[v]; j++) {
+                triangle_score[adjacency[j]] += delta;
+            }
+        }
+        if (cache.size() > kForsythCacheSize) {
+            cache.resize(kForsythCacheSize);
+        }
+    }
+    indices = std::move(output);
+}
+
+/**************************************************************************************************/
+
+/// FIFO post-transform vertex cache simulation
+class CacheSimulator final {
+   public:
+    explicit CacheSimulator(size_t num_vertices) : timestamps_(num_vertices, 0) {}
+
+    /// Transform a vertex, returns whether it missed the cache
+    bool Miss(uint32_t v)
+    {
+        if (time_ - timestamps_[v] < kCacheSize && timestamps_[v] != 0) {
+            return false;
+        }
+        timestamps_[v] = ++time_;
+        return true;
+    }
+
+    /// Count the misses of a triangle
+    unsigned int Misses(const uint32_t* triangle) { return Miss(triangle[0]) + Miss(triangle[1]) + Miss(triangle[2]); }
+
+    /// Empty the cache
+    void Flush() { time_ += kCacheSize + 1; }
+
+   private:
+    std::vector<uint64_t> timestamps_;
+    uint64_t time_ = 0;
+};
+
+float AverageCacheMissRatio(const std::vector<uint32_t>& indices, size_t num_vertices)
+{
+    if (indices.empty()) {
+        return 0.0f;
+    }
+    CacheSimulator cache(num_vertices);
+    unsigned int misses = 0;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        misses += cache.Misses(&indices[i]);
+    }
+    return float(misses) / float(indices.size() / 3);
+}
+
+/**************************************************************************************************/
+
+void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions, float threshold)
+{
+    const size_t num_triangles = indices.size() / 3;
+    if (num_triangles == 0) {
+        return;
+    }
+
+    // hard boundaries, where every vertex of a triangle misses, so reordering them costs no cache hits
+    CacheSimulator cache(positions.size());
+    std::vector<size_t> hard{ 0 };
+    for (size_t t = 0; t < num_triangles; t++) {
+        if (cache.Misses(&indices[t * 3]) == 3 && t > 0) {
+            hard.push_back(t);
+        }
+    }
+    hard.push_back(num_triangles);
+
+    // soft boundaries within hard clusters, where restarting with an empty cache keeps the miss ratio under threshold
+    std::vector<size_t> clusters;
+    for (size_t c = 0; c + 1 < hard.size(); c++) {
+        const size_t start = hard[c], end = hard[c + 1];
+        cache.Flush();
+        unsigned int cluster_misses = 0;
+        for (size_t t = start; t < end; t++) {
+            cluster_misses += cache.Misses(&indices[t * 3]);
+        }
+        const float cluster_acmr = float(cluster_misses) / float(end - start);
+
+        cache.Flush();
+        size_t soft_start = start;
+        unsigned int misses = 0;
+        clusters.push_back(start);
+        for (size_t t = start; t < end; t++) {
+            misses += cache.Misses(&indices[t * 3]);
+            const float acmr = float(misses) / float(t + 1 - soft_start);
+            if (t + 1 < end && acmr <= cluster_acmr * threshold) {
+                clusters.push_back(t + 1);
+                soft_start = t + 1;
+                misses = 0;
+                cache.Flush();
+            }
+        }
+    }
+    clusters.push_back(num_triangles);
+
+    // sort clusters by how far out they face, from the mesh centroid along their average normal
+    glm::vec3 mesh_centroid{ 0.0f };
+    for (const glm::vec3& position : positions) {
+        mesh_centroid += position;
+    }
+    mesh_centroid /= float(std::max<size_t>(positions.size(), 1));
+
+    struct Cluster {
+        size_t start, end;
+        float sort_key;
+    };
+    std::vector<Cluster> sorted;
+    sorted.reserve(clusters.size() - 1);
+    for (size_t c = 0; c + 1 < clusters.size(); c++) {
+        glm::vec3 centroid{ 0.0f }, normal{ 0.0f };
+        float area = 0.0f;
+        for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+            const glm::vec3& p0 = positions[indices[t * 3]];
+            const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+            const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+            const glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);  // area weighted normal
+            const float triangle_area = glm::length(cross);
+            centroid += (p0 + p1 + p2) * (triangle_area / 3.0f);
+            normal += cross;
+            area += triangle_area;
+        }
+        centroid = area > 0.0f ? centroid / area : positions[indices[clusters[c] * 3]];
+        const float normal_length = glm::length(normal);
+        const float sort_key = normal_length > 0.0f ? glm::dot(centroid - mesh_centroid, normal / normal_length) : 0.0f;
+        sorted.push_back({ clusters[c], clusters[c + 1], sort_key });
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) { return a.sort_key > b.sort_key; });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (const Cluster& cluster : sorted) {
+        output.insert(output.end(), indices.begin() + cluster.start * 3, indices.begin() + cluster.end * 3);
+    }
+    indices = std::move(output);
+}
+
+/**************************************************************************************************/
+
+std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& indices, size_t num_vertices)
+{
+    constexpr uint32_t kUnused = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(num_vertices, kUnused);
+    uint32_t next = 0;
+    for (uint32_t& index : indices) {
+        if (remap[index] == kUnused) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    return remap;
+}
+
+}  // namespace firstgame::tools::mesh
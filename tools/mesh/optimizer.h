@@ -0,0 +1,32 @@
+#ifndef FIRSTGAME_TOOLS_MESH_OPTIMIZER_H_
+#define FIRSTGAME_TOOLS_MESH_OPTIMIZER_H_
+
+#include <vector>
+#include <cstdint>
+#include <glm/vec3.hpp>
+
+/// Offline triangle mesh optimizations of the mesh import tool, run in this order:
+/// vertex cache, then overdraw, then vertex fetch. Meshes are indexed triangle lists.
+namespace firstgame::tools::mesh {
+
+/// Size of the simulated post-transform vertex cache, a FIFO of recent GPUs' typical size
+inline constexpr unsigned int kCacheSize = 16;
+
+/// Reorder the triangles to maximize post-transform vertex cache hits, with Tom Forsyth's linear-speed algorithm.
+void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t num_vertices);
+
+/// Reorder clusters of triangles so that outer, outward facing ones are drawn first and occlude the rest, reducing
+/// overdraw from most view directions. The cache optimized order is split into clusters where the cache is flushed,
+/// or where splitting raises the cache miss ratio by less than `threshold` (e.g. 1.05 for up to 5%).
+void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions, float threshold);
+
+/// Reorder the vertices by first use in the index order, for sequential vertex fetch.
+/// Remaps the indices and returns the new position of every vertex, unused vertices are dropped (~0u).
+std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& indices, size_t num_vertices);
+
+/// Average cache miss ratio, vertices transformed per triangle, of the index order with a FIFO cache of kCacheSize
+float AverageCacheMissRatio(const std::vector<uint32_t>& indices, size_t num_vertices);
+
+}  // namespace firstgame::tools::mesh
+
+#endif  // FIRSTGAME_TOOLS_MESH_OPTIMIZER_H_
@@ -0,0 +1,103 @@
+/**
+ * Asset packer, building the asset pack archive served by the AssetManager from the assets directory.
+ * Usage: firstgame_pack <assets directory> <output .fgpak>
+ */
+
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <filesystem>
+
+#include "common/pad.h"
+#include "firstgame/system/asset_pack_format.h"
+
+namespace fs = std::filesystem;
+using namespace firstgame::system::pack;
+using firstgame::tools::Pad;
+
+/// Asset to be packed
+struct Item {
+    fs::path assetpath;
+    std::vector<char> content;
+    PackEntry entry;
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <assets directory> <output .fgpak>\n";
+        return 1;
+    }
+    const fs::path assets_dir = argv[1];
+    const fs::path output = argv[2];
+
+    // read assets
+    std::vector<Item> items;
+    for (const auto& dir_entry : fs::recursive_directory_iterator(assets_dir)) {
+        if (not dir_entry.is_regular_file()) {
+            continue;
+        }
+        std::ifstream in(dir_entry.path(), std::ios::binary);
+        if (not in) {
+            std::cerr << "Failed to read " << dir_entry.path() << "\n";
+            return 1;
+        }
+        Item item;
+        item.assetpath = fs::relative(dir_entry.path(), assets_dir);
+        item.content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        item.entry = PackEntry{
+            .hash = PathHash(item.assetpath),
+            .offset = 0,
+            .size = item.content.size(),
+            .original_size = item.content.size(),
+            .codec = Codec::NONE,
+            .reserved = 0,
+        };
+        items.push_back(std::move(item));
+    }
+
+    // sort the index by hash, paths are not stored so hashes must be unique
+    std::sort(items.begin(), items.end(), [](const Item& lhs, const Item& rhs) { return lhs.entry.hash < rhs.entry.hash; });
+    for (size_t i = 1; i < items.size(); i++) {
+        if (items[i].entry.hash == items[i - 1].entry.hash) {
+            std::cerr << "Path hash collision between " << items[i - 1].assetpath << " and " << items[i].assetpath << "\n";
+            return 1;
+        }
+    }
+
+    // write blobs, then the index
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (not out) {
+        std::cerr << "Failed to create " << output << "\n";
+        return 1;
+    }
+    PackHeader header{};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t total_size = 0;
+    for (Item& item : items) {
+        Pad<kPackAlignment>(out);
+        item.entry.offset = static_cast<uint64_t>(out.tellp());
+        out.write(item.content.data(), static_cast<std::streamsize>(item.content.size()));
+        total_size += item.content.size();
+    }
+    Pad<kPackAlignment>(out);
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.num_entries = static_cast<uint32_t>(items.size());
+    header.index_offset = static_cast<uint64_t>(out.tellp());
+    for (const Item& item : items) {
+        out.write(reinterpret_cast<const char*>(&item.entry), sizeof(item.entry));
+    }
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (not out) {
+        std::cerr << "Failed to write " << output << "\n";
+        return 1;
+    }
+
+    std::cout << "Packed " << items.size() << " assets (" << total_size << " bytes) into " << output << "\n";
+    return 0;
+}
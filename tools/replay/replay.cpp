@@ -0,0 +1,180 @@
+/**
+ * Replay driver, feeding a recorded session to the game running headless on the OpenGL recording stub, and
+ * reporting the distribution of its frame times, optionally against the frame times of a baseline build.
+ * Usage: firstgame_replay <recording .fgreplay> [--fixed] [--csv <output .csv>] [--baseline <baseline .csv>]
+ */
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <utility>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <string_view>
+#include <spdlog/spdlog.h>
+
+#include "firstgame/firstgame.h"
+#include "firstgame/replay/replay.h"
+#include "firstgame/platform/posix_filesystem.h"
+#include "firstgame/opengl/stub/gl_stub.h"
+
+using namespace firstgame;
+
+/// Percentiles of a frame time distribution, in milliseconds
+struct Distribution {
+    float mean;
+    float p50;
+    float p90;
+    float p99;
+    float max;
+};
+
+/// Distribution of the frame times, by nearest rank
+static Distribution Summarize(std::vector<float> frame_ms)
+{
+    if (frame_ms.empty()) {
+        return {};
+    }
+    std::sort(frame_ms.begin(), frame_ms.end());
+    const auto rank = [&](double percentile) {
+        return frame_ms[std::min(frame_ms.size() - 1, static_cast<size_t>(percentile * frame_ms.size()))];
+    };
+    double sum = 0.0;
+    for (float ms : frame_ms) {
+        sum += ms;
+    }
+    return {
+        .mean = static_cast<float>(sum / frame_ms.size()),
+        .p50 = rank(0.50),
+        .p90 = rank(0.90),
+        .p99 = rank(0.99),
+        .max = frame_ms.back(),
+    };
+}
+
+/// Frame times of a CSV written by this driver, throws on a line not holding a frame time
+static std::vector<float> ReadCsv(const std::string& path)
+{
+    std::ifstream in(path);
+    if (not in) {
+        throw std::runtime_error("Failed to open");
+    }
+    std::vector<float> frame_ms;
+    std::string line;
+    std::getline(in, line);  // header
+    for (size_t number = 2; std::getline(in, line); number++) {
+        const size_t comma = line.find(',');
+        if (comma == std::string::npos) {
+            continue;
+        }
+        try {
+            frame_ms.push_back(std::stof(line.substr(comma + 1)));
+        }
+        catch (const std::logic_error&) {  // std::invalid_argument and std::out_of_range
+            throw std::runtime_error("Bad frame time at line " + std::to_string(number) + ": '" + line + "'");
+        }
+    }
+    return frame_ms;
+}
+
+static void PrintRow(const char* name, float ms, float baseline_ms, bool has_baseline)
+{
+    if (has_baseline && baseline_ms <= 0.0f) {
+        std::printf("  %-4s %9.3f ms %9.3f ms      n/a\n", name, ms, baseline_ms);
+    }
+    else if (has_baseline) {
+        std::printf("  %-4s %9.3f ms %9.3f ms %+7.1f%%\n", name, ms, baseline_ms, 100.0f * (ms - baseline_ms) / baseline_ms);
+    }
+    else {
+        std::printf("  %-4s %9.3f ms\n", name, ms);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const char* recording = nullptr;
+    const char* csv = nullptr;
+    const char* baseline = nullptr;
+    auto pace = replay::Pace::Max;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        if (arg == "--fixed") {
+            pace = replay::Pace::Fixed;
+        }
+        else if (arg == "--csv" && i + 1 < argc) {
+            csv = argv[++i];
+        }
+        else if (arg == "--baseline" && i + 1 < argc) {
+            baseline = argv[++i];
+        }
+        else if (recording == nullptr && arg.substr(0, 2) != "--") {
+            recording = argv[i];
+        }
+        else {
+            recording = nullptr;
+            break;
+        }
+    }
+    if (recording == nullptr) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <recording .fgreplay> [--fixed] [--csv <output .csv>] [--baseline <baseline .csv>]\n";
+        return 1;
+    }
+
+    // read the baseline first, so a bad one is reported before spending the time of the replay
+    std::vector<float> baseline_ms;
+    if (baseline != nullptr) {
+        try {
+            baseline_ms = ReadCsv(baseline);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to read the baseline " << baseline << ": " << e.what() << "\n";
+            return 1;
+        }
+        if (baseline_ms.empty()) {
+            std::cerr << "The baseline " << baseline << " holds no frame times, expected a CSV written with --csv\n";
+            return 1;
+        }
+    }
+
+    auto logger = spdlog::default_logger();
+    logger->set_level(spdlog::level::warn);
+    auto filesystem = std::make_shared<platform::PosixFileSystem>();
+    std::vector<float> frame_ms;
+    try {
+        replay::Player player = replay::Player::Load(*filesystem, recording);
+        auto game = FirstGame::New(player.Width(), player.Height(), logger, filesystem);
+        // the stub records every GL call, dropped once the frame is done so they do not pile up
+        frame_ms = player.Run(*game, pace, [] { opengl::stub::Reset(); });
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Failed to replay " << recording << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    if (csv != nullptr) {
+        std::ofstream out(csv);
+        out << "frame,ms\n";
+        for (size_t frame = 0; frame < frame_ms.size(); frame++) {
+            out << frame << ',' << frame_ms[frame] << '\n';
+        }
+        if (not out) {
+            std::cerr << "Failed to write " << csv << "\n";
+            return 1;
+        }
+    }
+
+    const Distribution current = Summarize(frame_ms);
+    const Distribution base = Summarize(std::move(baseline_ms));
+    const bool has_baseline = baseline != nullptr;
+    std::printf("%zu frames%s\n", frame_ms.size(), has_baseline ? ", against the baseline" : "");
+    PrintRow("mean", current.mean, base.mean, has_baseline);
+    PrintRow("p50", current.p50, base.p50, has_baseline);
+    PrintRow("p90", current.p90, base.p90, has_baseline);
+    PrintRow("p99", current.p99, base.p99, has_baseline);
+    PrintRow("max", current.max, base.max, has_baseline);
+    return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * Texture pre-processor, decoding an image and generating its mip chain offline into the pre-processed texture
+ * uploaded in place by LoadTextureAsync().
+ * Usage: firstgame_texture <input image> <output .fgtex>
+ */
+
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "common/pad.h"
+#include "firstgame/render/image.h"
+#include "firstgame/render/texture_format.h"
+
+using namespace firstgame::render;
+using namespace firstgame::render::texture_format;
+using firstgame::tools::Pad;
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input image> <output .fgtex>\n";
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (not in) {
+        std::cerr << "Failed to read " << argv[1] << "\n";
+        return 1;
+    }
+    const std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    const auto start = std::chrono::steady_clock::now();
+    Image image;
+    try {
+        image = DecodeImage({ reinterpret_cast<const std::byte*>(content.data()), content.size() });
+        GenerateMips(image);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Failed to process " << argv[1] << ": " << e.what() << "\n";
+        return 1;
+    }
+    const float process_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (image.levels.size() > kMaxLevels) {
+        std::cerr << "Image too large, " << image.levels.size() << " mip levels\n";
+        return 1;
+    }
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    if (not out) {
+        std::cerr << "Failed to write " << argv[2] << "\n";
+        return 1;
+    }
+    TextureHeader header{
+        .magic = {},
+        .version = kVersion,
+        .width = image.levels.front().width,
+        .height = image.levels.front().height,
+        .num_levels = static_cast<uint32_t>(image.levels.size()),
+        .codec = Codec::RGBA8,
+    };
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<LevelEntry> entries(image.levels.size());
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(LevelEntry)));
+    for (size_t i = 0; i < image.levels.size(); i++) {
+        const ImageLevel& level = image.levels[i];
+        Pad<kTextureAlignment>(out);
+        entries[i] = LevelEntry{
+            .width = level.width,
+            .height = level.height,
+            .offset = static_cast<uint64_t>(out.tellp()),
+            .size = level.texels.size(),
+        };
+        out.write(reinterpret_cast<const char*>(level.texels.data()), static_cast<std::streamsize>(level.texels.size()));
+    }
+    out.seekp(sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(LevelEntry)));
+    if (not out) {
+        std::cerr << "Failed to write " << argv[2] << "\n";
+        return 1;
+    }
+
+    std::cout << "Processed " << header.width << "x" << header.height << " with " << header.num_levels << " levels in "
+              << process_ms << " ms\n";
+    return 0;
+}